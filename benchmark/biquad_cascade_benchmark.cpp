@@ -0,0 +1,109 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: biquad_cascade_benchmark.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/filter.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::filter;
+
+namespace {
+
+    constexpr std::size_t max_order = 16;
+    constexpr std::size_t samples   = 1 << 20;
+
+    template <typename T>
+    using cascade = biquad_cascade<T, max_order / 2>;
+
+    // Reference: the sample-major loop, every sample walks all the stages.
+    template <typename T>
+    void sample_major(cascade<T>& filter, T* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            data[i] = filter.tick(data[i]);
+        }
+    }
+
+    template <typename T>
+    void stage_major(cascade<T>& filter, T* data, std::size_t size) {
+        filter.process(data, size);
+    }
+
+    template <typename T, typename Function>
+    double measure(cascade<T> filter, std::vector<T> data, std::size_t block, Function function) {
+        double best = std::numeric_limits<double>::max();
+        for (auto repetition = 0; repetition < 5; ++repetition) {
+            filter.reset();
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t offset = 0; offset < data.size(); offset += block) {
+                function(filter, data.data() + offset, std::min(block, data.size() - offset));
+            }
+            const auto stop = std::chrono::steady_clock::now();
+            best            = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+        return best / static_cast<double>(data.size());
+    }
+
+    template <typename T>
+    void run(const char* name) {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<T> distribution(-1, 1);
+        std::vector<T> input(samples);
+        std::generate(std::begin(input), std::end(input), [&]() { return distribution(generator); });
+
+        std::printf("%s\n%6s %6s %12s %12s %8s %12s\n", name, "order", "block", "tick ns/s", "block ns/s", "speedup",
+                    "max error");
+        for (std::size_t order = 2; order <= max_order; order *= 2) {
+            const auto filter =
+                designer<T, designer_type::Butterworth, max_order>{}.template design<filter_type::LowPass>(
+                    order, static_cast<T>(48000), static_cast<T>(1000));
+            for (std::size_t block = 64; block <= 4096; block *= 4) {
+                const auto reference = measure(filter, input, block, sample_major<T>);
+                const auto blocked   = measure(filter, input, block, stage_major<T>);
+
+                // Both loop orders compute the same operations, so the outputs should match exactly.
+                auto expected = input, output = input;
+                auto first = filter, second = filter;
+                sample_major(first, expected.data(), expected.size());
+                for (std::size_t offset = 0; offset < output.size(); offset += block) {
+                    stage_major(second, output.data() + offset, std::min(block, output.size() - offset));
+                }
+                T error = 0;
+                for (std::size_t i = 0; i < output.size(); ++i) {
+                    error = std::max(error, std::abs(expected[i] - output[i]));
+                }
+                std::printf("%6zu %6zu %12.3f %12.3f %7.2fx %12g\n", order, block, reference, blocked,
+                            reference / blocked, static_cast<double>(error));
+            }
+        }
+    }
+
+} // namespace
+
+int main() {
+    run<float>("biquad_cascade<float>");
+    run<double>("biquad_cascade<double>");
+    return 0;
+}
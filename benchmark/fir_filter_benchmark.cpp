@@ -0,0 +1,123 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: fir_filter_benchmark.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/filter.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace edsp::filter;
+
+namespace {
+
+    constexpr std::size_t samples    = 1 << 16;
+    constexpr std::size_t long_call  = 4096;
+    constexpr std::size_t short_call = 64;
+    constexpr std::size_t direct     = std::numeric_limits<std::size_t>::max();
+
+    template <typename T>
+    double measure(fir_filter<T>& filter, const std::vector<T>& input, std::vector<T>& output, std::size_t call) {
+        double best = std::numeric_limits<double>::max();
+        for (auto repetition = 0; repetition < 5; ++repetition) {
+            filter.reset();
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t offset = 0; offset < input.size(); offset += call) {
+                const auto count = std::min(call, input.size() - offset);
+                filter.filter(std::cbegin(input) + offset, std::cbegin(input) + offset + count,
+                              std::begin(output) + offset);
+            }
+            const auto stop = std::chrono::steady_clock::now();
+            best            = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+        return best / static_cast<double>(input.size());
+    }
+
+    // Compares the direct form and the overlap-save method, in long and in short calls. The smallest kernel for which
+    // the overlap-save method is faster is the crossover, and the ratio between the cost of a block and the cost of a
+    // multiply-add of the direct form gives the fft_cost factor of the filter.
+    template <typename T>
+    bool run(const char* type, T tolerance) {
+        std::printf("%s\n%6s %12s %12s %12s %12s %10s %8s\n", type, "taps", "direct", "fft long", "fft short",
+                    "auto short", "error", "factor");
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<T> distribution(-1, 1);
+        std::vector<T> input(samples), reference(samples), output(samples);
+        std::generate(std::begin(input), std::end(input), [&]() { return distribution(generator); });
+
+        bool passed           = true;
+        std::size_t crossover = 0;
+        for (std::size_t taps = 8; taps <= 2048; taps *= 2) {
+            for (const auto size : {taps, taps + taps / 2}) {
+                std::vector<T> coefficients(size);
+                std::generate(std::begin(coefficients), std::end(coefficients),
+                              [&]() { return distribution(generator); });
+
+                fir_filter<T> slow(std::cbegin(coefficients), std::cend(coefficients), direct);
+                fir_filter<T> fast(std::cbegin(coefficients), std::cend(coefficients), 0);
+                fir_filter<T> automatic(std::cbegin(coefficients), std::cend(coefficients));
+
+                const auto direct_time = measure(slow, input, reference, long_call);
+                const auto fft_time    = measure(fast, input, output, long_call);
+
+                T error = 0;
+                for (std::size_t i = 0; i < samples; ++i) {
+                    error = std::max(error, std::abs(output[i] - reference[i]));
+                }
+
+                std::size_t nfft = 2, stages = 1;
+                while (nfft < 2 * size) {
+                    nfft *= 2;
+                    ++stages;
+                }
+
+                // Every call pays the FFTs of a whole block, so the cost of the overlap-save method in short calls is
+                // the cost of a block divided by the length of the call.
+                const auto block      = static_cast<double>(nfft - size + 1);
+                const auto short_time = fft_time * block / static_cast<double>(short_call);
+                const auto auto_time  = measure(automatic, input, output, short_call);
+                const auto tap_time   = direct_time / static_cast<double>(size);
+                const auto factor     = fft_time * block / tap_time / static_cast<double>(nfft * stages);
+
+                if (crossover == 0 && fft_time < direct_time) {
+                    crossover = size;
+                }
+                const bool ok = error <= tolerance * static_cast<T>(size);
+                passed        = passed && ok;
+                std::printf("%6zu %9.2f ns %9.2f ns %9.2f ns %9.2f ns %10.3e %8.2f %s\n", size, direct_time, fft_time,
+                            short_time, auto_time, static_cast<double>(error), factor, ok ? "" : "FAILED");
+            }
+        }
+        std::printf("crossover: %zu taps\n", crossover);
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    const auto passed = run<float>("float", 1e-6f) && run<double>("double", 1e-14);
+    std::printf("%s\n", passed ? "Both methods are equivalent" : "The methods are not equivalent");
+    return passed ? 0 : 1;
+}
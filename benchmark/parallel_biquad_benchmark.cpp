@@ -0,0 +1,130 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: parallel_biquad_benchmark.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/filter.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::filter;
+
+namespace {
+
+    constexpr std::size_t max_order = 16;
+    constexpr std::size_t samples   = 1 << 18;
+
+    template <typename T>
+    using cascade = biquad_cascade<T, max_order / 2>;
+
+    template <typename Filter, typename T>
+    double measure(Filter filter, std::vector<T> data) {
+        double best = std::numeric_limits<double>::max();
+        for (auto repetition = 0; repetition < 5; ++repetition) {
+            filter.reset();
+            const auto start = std::chrono::steady_clock::now();
+            filter.process(data.data(), data.size());
+            const auto stop = std::chrono::steady_clock::now();
+            best            = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+        return best / static_cast<double>(data.size());
+    }
+
+    // Numerical equivalence: the error of both forms is measured against a long double cascade, relative to the
+    // energy of the reference output, for an impulse and for white noise.
+    template <typename T>
+    bool compare(const char* name, const cascade<T>& serial, T tolerance) {
+        cascade<long double> reference;
+        for (const auto& stage : serial) {
+            reference.emplace_back(static_cast<long double>(stage.a0()), static_cast<long double>(stage.a1()),
+                                   static_cast<long double>(stage.a2()), static_cast<long double>(stage.b0()),
+                                   static_cast<long double>(stage.b1()), static_cast<long double>(stage.b2()));
+        }
+        auto parallel = make_parallel_biquad(serial);
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<T> distribution(-1, 1);
+        std::vector<T> noise(samples), impulse(samples, 0);
+        std::generate(std::begin(noise), std::end(noise), [&]() { return distribution(generator); });
+        impulse[0] = 1;
+
+        bool passed = true;
+        for (const auto* input : {&impulse, &noise}) {
+            auto first = serial;
+            first.reset();
+            reference.reset();
+            parallel.reset();
+            std::vector<T> serial_output(input->size()), parallel_output(input->size());
+            first.filter(std::cbegin(*input), std::cend(*input), std::begin(serial_output));
+            parallel.filter(std::cbegin(*input), std::cend(*input), std::begin(parallel_output));
+
+            long double energy = 0, serial_error = 0, parallel_error = 0;
+            for (std::size_t i = 0; i < input->size(); ++i) {
+                const auto expected = reference.tick(static_cast<long double>((*input)[i]));
+                energy += expected * expected;
+                serial_error += std::pow(serial_output[i] - expected, 2);
+                parallel_error += std::pow(parallel_output[i] - expected, 2);
+            }
+            const auto serial_relative   = static_cast<double>(std::sqrt(serial_error / energy));
+            const auto parallel_relative = static_cast<double>(std::sqrt(parallel_error / energy));
+            const bool ok                = parallel_relative <= std::max<double>(tolerance, 10 * serial_relative);
+            passed                       = passed && ok;
+            std::printf("%-24s %-8s %12.3e %12.3e %6s\n", name, input == &impulse ? "impulse" : "noise",
+                        serial_relative, parallel_relative, ok ? "ok" : "FAILED");
+        }
+        std::printf("%-24s %-8s %9.3f ns %9.3f ns\n", name, "timing", measure(serial, noise), measure(parallel, noise));
+        return passed;
+    }
+
+    template <typename T>
+    bool run(const char* type, T tolerance) {
+        std::printf("%s\n%-24s %-8s %12s %12s\n", type, "filter", "input", "cascade", "parallel");
+        bool passed     = true;
+        const auto rate = static_cast<T>(48000);
+        char name[64]{};
+        for (std::size_t order = 2; order <= max_order; order += 2) {
+            std::snprintf(name, sizeof(name), "butterworth lp %zu", order);
+            passed &= compare(name, designer<T, designer_type::Butterworth, max_order>{}
+                                        .template design<filter_type::LowPass>(order, rate, static_cast<T>(2000)),
+                              tolerance);
+            std::snprintf(name, sizeof(name), "butterworth hp %zu", order);
+            passed &= compare(name, designer<T, designer_type::Butterworth, max_order>{}
+                                        .template design<filter_type::HighPass>(order, rate, static_cast<T>(500)),
+                              tolerance);
+            std::snprintf(name, sizeof(name), "chebyshev I lp %zu", order);
+            passed &= compare(name,
+                              designer<T, designer_type::ChebyshevI, max_order>{}.template design<filter_type::LowPass>(
+                                  order, rate, static_cast<T>(4000), static_cast<T>(1)),
+                              tolerance);
+        }
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    const auto passed = run<float>("float", 1e-3f) && run<double>("double", 1e-9);
+    std::printf("%s\n", passed ? "All the parallel forms are equivalent" : "Some parallel forms are not equivalent");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: state_variable_filter_benchmark.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/filter.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace edsp::filter;
+
+namespace {
+
+    constexpr std::size_t samples = 1 << 18;
+
+    template <typename Function>
+    double measure(Function function) {
+        double best = std::numeric_limits<double>::max();
+        for (auto repetition = 0; repetition < 5; ++repetition) {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const auto stop = std::chrono::steady_clock::now();
+            best            = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+        return best / static_cast<double>(samples);
+    }
+
+    // A low pass filter whose cutoff is driven by a 3 Hz LFO at audio rate, computed with: the cutoff buffer, the
+    // exact prewarping of set_cutoff every sample, and a RBJ design every sample.
+    template <typename T>
+    bool run(const char* type, T tolerance) {
+        const auto rate = static_cast<T>(48000);
+        const auto Q    = static_cast<T>(2);
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<T> distribution(-1, 1);
+        std::vector<T> input(samples), cutoff(samples);
+        for (std::size_t i = 0; i < samples; ++i) {
+            input[i]  = distribution(generator);
+            cutoff[i] = static_cast<T>(1000 + 800 * std::sin(2 * M_PI * 3 * static_cast<double>(i) / rate));
+        }
+
+        std::vector<T> modulated(input), exact(input), redesigned(input);
+        state_variable_filter<T> buffered(rate, cutoff[0], Q), reference(rate, cutoff[0], Q);
+        buffered.template process<svf_mode::LowPass>(modulated.data(), cutoff.data(), samples);
+        for (std::size_t i = 0; i < samples; ++i) {
+            reference.set_cutoff(cutoff[i]);
+            exact[i] = reference.tick(exact[i]).low;
+        }
+
+        T error = 0;
+        for (std::size_t i = 0; i < samples; ++i) {
+            error = std::max(error, std::abs(modulated[i] - exact[i]));
+        }
+        const bool passed = error <= tolerance;
+
+        std::vector<T> data(samples);
+        const auto buffer_time = measure([&]() {
+            data = input;
+            state_variable_filter<T> filter(rate, cutoff[0], Q);
+            filter.template process<svf_mode::LowPass>(data.data(), cutoff.data(), samples);
+        });
+        const auto exact_time = measure([&]() {
+            data = input;
+            state_variable_filter<T> filter(rate, cutoff[0], Q);
+            for (std::size_t i = 0; i < samples; ++i) {
+                filter.set_cutoff(cutoff[i]);
+                data[i] = filter.tick(data[i]).low;
+            }
+        });
+        const auto rbj_time = measure([&]() {
+            data = input;
+            T w0 = 0, w1 = 0;
+            for (std::size_t i = 0; i < samples; ++i) {
+                const auto section = RBJFilterDesigner<T, filter_type::LowPass>{}(cutoff[i], rate, Q);
+                const auto value   = data[i];
+                const auto out     = (section.b0() * value + w0) / section.a0();
+                w0                 = (section.b1() * value - section.a1() * out) / section.a0() + w1;
+                w1                 = (section.b2() * value - section.a2() * out) / section.a0();
+                data[i]            = out;
+            }
+        });
+
+        std::printf("%-8s error %10.3e %6s | buffer %7.3f ns | set_cutoff %7.3f ns | rbj %7.3f ns\n", type,
+                    static_cast<double>(error), passed ? "ok" : "FAILED", buffer_time, exact_time, rbj_time);
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    const auto passed = run<float>("float", 1e-5f) && run<double>("double", 1e-12);
+    std::printf("%s\n", passed ? "The modulated filters are equivalent" : "The modulated filters are not equivalent");
+    return passed ? 0 : 1;
+}
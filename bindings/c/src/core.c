@@ -56,6 +56,7 @@ const char *get_fft_library() {
         case edsp::core::fft_lib::fftw: return "fftw";
         case edsp::core::fft_lib::pffft: return "pffft";
         case edsp::core::fft_lib::accelerate: return "accelerate";
+        case edsp::core::fft_lib::native: return "native";
         case edsp::core::fft_lib::unknown: return "unknown";
     }
     return "";
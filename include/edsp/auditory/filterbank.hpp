@@ -0,0 +1,318 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: filterbank.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_FILTERBANK_HPP
+#define EDSP_FILTERBANK_HPP
+
+#include <edsp/auditory/audspace.hpp>
+#include <edsp/auditory/converter/bark2hertz.hpp>
+#include <edsp/auditory/converter/cent2hertz.hpp>
+#include <edsp/auditory/converter/erb2hertz.hpp>
+#include <edsp/auditory/converter/mel2hertz.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace edsp { namespace auditory {
+
+    namespace internal {
+
+        template <typename T>
+        constexpr T to_auditory_scale(T frequency, auditory_scale scale) noexcept {
+            switch (scale) {
+                case auditory_scale::erb:
+                    return converter::hertz2erb(frequency);
+                case auditory_scale::bark:
+                    return converter::hertz2bark(frequency);
+                case auditory_scale::cent:
+                    return converter::hertz2cent(frequency);
+                default:
+                    return converter::hertz2mel(frequency);
+            }
+        }
+
+        template <typename T>
+        constexpr T from_auditory_scale(T value, auditory_scale scale) noexcept {
+            switch (scale) {
+                case auditory_scale::erb:
+                    return converter::erb2hertz(value);
+                case auditory_scale::bark:
+                    return converter::bark2hertz(value);
+                case auditory_scale::cent:
+                    return converter::cent2hertz(value);
+                default:
+                    return converter::mel2hertz(value);
+            }
+        }
+
+    } // namespace internal
+
+    /**
+     * @class filterbank
+     * @brief This class implements a bank of triangular filters applied to the magnitude or power spectrum of a
+     * frame, as used to compute Mel, Bark or ERB band energies.
+     *
+     * The m-th filter rises linearly from the edge \f$ f_{m} \f$ to the edge \f$ f_{m+1} \f$ and falls back to zero
+     * at \f$ f_{m+2} \f$. When the filterbank is created from an auditory scale, the edges are equally spaced on
+     * that scale between the minimum and maximum frequencies.
+     *
+     * Every filter is only non-zero in a narrow span of bins, so only that span is stored. Applying the filterbank
+     * to a spectrum of nfft / 2 + 1 bins costs the total number of non-zero weights instead of filters * bins.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class filterbank {
+    public:
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        /**
+         * @brief Creates a %filterbank with filters equally spaced on an auditory scale.
+         * @param scale Auditory scale of the filters.
+         * @param filters Number of filters.
+         * @param min_frequency Lower edge of the first filter in Hz.
+         * @param max_frequency Upper edge of the last filter in Hz.
+         * @param sample_rate Sampling frequency in Hz.
+         * @param nfft Size of the FFT of the spectra.
+         * @param normalize If true, every filter is scaled to have unit area, otherwise to have unit peak.
+         */
+        filterbank(auditory_scale scale, size_type filters, value_type min_frequency, value_type max_frequency,
+                   value_type sample_rate, size_type nfft, bool normalize = false);
+
+        /**
+         * @brief Creates a %filterbank from the edges of the filters in the range [first, last).
+         *
+         * N edges define N - 2 filters, the m-th filter spans the edges m, m + 1 and m + 2.
+         * @param first Input iterator defining the beginning of the range of edges in Hz, in increasing order.
+         * @param last Input iterator defining the ending of the range of edges in Hz.
+         * @param sample_rate Sampling frequency in Hz.
+         * @param nfft Size of the FFT of the spectra.
+         * @param normalize If true, every filter is scaled to have unit area, otherwise to have unit peak.
+         */
+        template <typename InputIt>
+        filterbank(InputIt first, InputIt last, value_type sample_rate, size_type nfft, bool normalize = false);
+
+        /**
+         * @brief Returns the number of filters.
+         * @return Number of filters.
+         */
+        size_type filters() const noexcept;
+
+        /**
+         * @brief Returns the number of bins of the spectra.
+         * @return nfft / 2 + 1
+         */
+        size_type bins() const noexcept;
+
+        /**
+         * @brief Returns the centre frequency of the i-th filter.
+         * @param i Position of the filter.
+         * @return Frequency in Hz.
+         */
+        value_type frequency(size_type i) const;
+
+        /**
+         * @brief Returns the number of non-zero weights of all the filters.
+         * @return Number of stored weights.
+         */
+        size_type nonzeros() const noexcept;
+
+        /**
+         * @brief Returns the weight of the i-th filter at the given bin.
+         * @param i Position of the filter.
+         * @param bin Position of the bin.
+         * @return Weight of the filter.
+         */
+        value_type weight(size_type i, size_type bin) const;
+
+        /**
+         * @brief Applies the filters to a spectrum of bins() values, beginning at first, and stores the output of
+         * every filter in another range, beginning at d_first.
+         * @param first Random access iterator defining the beginning of the spectrum.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename RandomIt, typename OutputIt>
+        OutputIt apply(RandomIt first, OutputIt d_first) const;
+
+        /**
+         * @brief Applies the filters to a batch of spectra stored one after the other, beginning at first, and stores
+         * the output of every frame one after the other in another range, beginning at d_first.
+         * @param first Random access iterator defining the beginning of the spectra, every one of bins() values.
+         * @param frames Number of spectra.
+         * @param d_first Output iterator defining the beginning of the destination range, every frame of filters()
+         * values.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename RandomIt, typename OutputIt>
+        OutputIt apply(RandomIt first, size_type frames, OutputIt d_first) const;
+
+    private:
+        void build(const std::vector<value_type>& edges, value_type sample_rate, bool normalize);
+
+        static std::vector<value_type> make_edges(auditory_scale scale, size_type filters, value_type min_frequency,
+                                                  value_type max_frequency);
+
+        std::vector<value_type> centres_;
+        std::vector<size_type> starts_;
+        std::vector<size_type> offsets_;
+        std::vector<value_type> weights_;
+        size_type nfft_;
+        size_type bins_;
+    };
+
+    template <typename T>
+    filterbank<T>::filterbank(auditory_scale scale, size_type filters, value_type min_frequency,
+                              value_type max_frequency, value_type sample_rate, size_type nfft, bool normalize) :
+        nfft_(nfft),
+        bins_(nfft / 2 + 1) {
+        meta::expects(filters > 0, "The number of filters should be greater than zero");
+        meta::expects(0 <= min_frequency && min_frequency < max_frequency, "Expecting a valid range of frequencies");
+        build(make_edges(scale, filters, min_frequency, max_frequency), sample_rate, normalize);
+    }
+
+    template <typename T>
+    template <typename InputIt>
+    filterbank<T>::filterbank(InputIt first, InputIt last, value_type sample_rate, size_type nfft, bool normalize) :
+        nfft_(nfft),
+        bins_(nfft / 2 + 1) {
+        build(std::vector<value_type>(first, last), sample_rate, normalize);
+    }
+
+    template <typename T>
+    std::vector<typename filterbank<T>::value_type> filterbank<T>::make_edges(auditory_scale scale, size_type filters,
+                                                                             value_type min_frequency,
+                                                                             value_type max_frequency) {
+        const auto lower = internal::to_auditory_scale(min_frequency, scale);
+        const auto upper = internal::to_auditory_scale(max_frequency, scale);
+        std::vector<value_type> edges(filters + 2);
+        for (size_type i = 0; i < edges.size(); ++i) {
+            const auto step = static_cast<value_type>(i) / static_cast<value_type>(filters + 1);
+            edges[i]        = internal::from_auditory_scale(lower + (upper - lower) * step, scale);
+        }
+        edges.front() = min_frequency;
+        edges.back()  = max_frequency;
+        return edges;
+    }
+
+    template <typename T>
+    void filterbank<T>::build(const std::vector<value_type>& edges, value_type sample_rate, bool normalize) {
+        meta::expects(edges.size() > 2, "Expecting at least three edges");
+        meta::expects(std::is_sorted(std::cbegin(edges), std::cend(edges)), "Expecting edges in increasing order");
+        meta::expects(sample_rate > 0, "The sample rate should be greater than zero");
+        meta::expects(bins_ > 1, "The FFT size should be greater than one");
+
+        const auto filters    = edges.size() - 2;
+        const auto resolution = sample_rate / static_cast<value_type>(nfft_);
+        centres_.resize(filters);
+        starts_.resize(filters);
+        offsets_.assign(1, 0);
+        for (size_type m = 0; m < filters; ++m) {
+            const auto lower  = edges[m];
+            const auto centre = edges[m + 1];
+            const auto upper  = edges[m + 2];
+            const auto scale  = normalize ? 2 / (upper - lower) : static_cast<value_type>(1);
+            centres_[m]       = centre;
+
+            // Only the bins strictly inside (lower, upper) have a non-zero weight.
+            const auto first = static_cast<size_type>(std::floor(lower / resolution)) + 1;
+            starts_[m]       = std::min(first, bins_);
+            for (auto j = first; j < bins_ && static_cast<value_type>(j) * resolution < upper; ++j) {
+                const auto frequency = static_cast<value_type>(j) * resolution;
+                const auto rising    = (centre > lower) ? (frequency - lower) / (centre - lower) : 1;
+                const auto falling   = (upper > centre) ? (upper - frequency) / (upper - centre) : 1;
+                weights_.push_back(std::max(std::min(rising, falling), static_cast<value_type>(0)) * scale);
+            }
+            offsets_.push_back(weights_.size());
+        }
+    }
+
+    template <typename T>
+    typename filterbank<T>::size_type filterbank<T>::filters() const noexcept {
+        return centres_.size();
+    }
+
+    template <typename T>
+    typename filterbank<T>::size_type filterbank<T>::bins() const noexcept {
+        return bins_;
+    }
+
+    template <typename T>
+    typename filterbank<T>::value_type filterbank<T>::frequency(size_type i) const {
+        return centres_[i];
+    }
+
+    template <typename T>
+    typename filterbank<T>::size_type filterbank<T>::nonzeros() const noexcept {
+        return weights_.size();
+    }
+
+    template <typename T>
+    typename filterbank<T>::value_type filterbank<T>::weight(size_type i, size_type bin) const {
+        const auto count = offsets_[i + 1] - offsets_[i];
+        if (bin < starts_[i] || bin >= starts_[i] + count) {
+            return 0;
+        }
+        return weights_[offsets_[i] + bin - starts_[i]];
+    }
+
+    template <typename T>
+    template <typename RandomIt, typename OutputIt>
+    OutputIt filterbank<T>::apply(RandomIt first, OutputIt d_first) const {
+        const auto* weight = weights_.data();
+        for (size_type m = 0; m < centres_.size(); ++m, ++d_first) {
+            const auto x     = first + static_cast<std::ptrdiff_t>(starts_[m]);
+            const auto* w    = weight + offsets_[m];
+            const auto count = offsets_[m + 1] - offsets_[m];
+
+            // Independent partial sums, so the reduction does not depend on reassociating the additions.
+            value_type s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            size_type j = 0;
+            for (; j + 4 <= count; j += 4) {
+                s0 += w[j] * x[j];
+                s1 += w[j + 1] * x[j + 1];
+                s2 += w[j + 2] * x[j + 2];
+                s3 += w[j + 3] * x[j + 3];
+            }
+            for (; j < count; ++j) {
+                s0 += w[j] * x[j];
+            }
+            *d_first = (s0 + s1) + (s2 + s3);
+        }
+        return d_first;
+    }
+
+    template <typename T>
+    template <typename RandomIt, typename OutputIt>
+    OutputIt filterbank<T>::apply(RandomIt first, size_type frames, OutputIt d_first) const {
+        for (size_type i = 0; i < frames; ++i) {
+            d_first = apply(first, d_first);
+            std::advance(first, bins_);
+        }
+        return d_first;
+    }
+
+}} // namespace edsp::auditory
+
+#endif //EDSP_FILTERBANK_HPP
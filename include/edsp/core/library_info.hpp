@@ -29,7 +29,7 @@
 
 namespace edsp { inline namespace core {
 
-    enum class fft_lib { fftw, pffft, accelerate, unknown };
+    enum class fft_lib { fftw, pffft, accelerate, native, unknown };
 
     enum class codec_lib { audiofile, sndfile, unknown };
 
@@ -43,6 +43,8 @@ namespace edsp { inline namespace core {
                 return stream << "PFFFT";
             case fft_lib::accelerate:
                 return stream << "Apple Accelerate Framework";
+            case fft_lib::native:
+                return stream << "eDSP native FFT";
             case fft_lib::unknown:
             default:
                 return stream << edsp::red << "not found" << edsp::endc;
@@ -106,7 +108,7 @@ namespace edsp { inline namespace core {
 #elif defined(USE_LIBACCELERATE)
             return fft_lib::fftw;
 #else
-            return fft_lib::unknown;
+            return fft_lib::native;
 #endif
         }
 
@@ -0,0 +1,435 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: mfcc_extractor.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_MFCC_EXTRACTOR_HPP
+#define EDSP_MFCC_EXTRACTOR_HPP
+
+#include <edsp/auditory/filterbank.hpp>
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/windowing.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace edsp { namespace feature { inline namespace spectral {
+
+    namespace internal {
+
+        /**
+         * @brief Streaming regression of a sequence of vectors of a fixed dimension.
+         *
+         * Every pushed vector is delayed by width frames, the output is the centre vector followed by the delta of
+         * its last tail values:
+         *
+         * \f[
+         *  \Delta_t = \frac{\sum_{n=1}^{W} n (x_{t+n} - x_{t-n})}{2 \sum_{n=1}^{W} n^2}
+         * \f]
+         *
+         * The first and last vectors are replicated at the edges of the sequence.
+         */
+        template <typename T>
+        class delta_stage {
+        public:
+            using value_type = T;
+            using size_type  = std::size_t;
+
+            delta_stage(size_type dimension, size_type tail, size_type width) :
+                history_((2 * width + 1) * dimension),
+                dimension_(dimension),
+                tail_(tail),
+                width_(width) {
+                value_type sum = 0;
+                for (size_type n = 1; n <= width; ++n) {
+                    sum += static_cast<value_type>(n * n);
+                }
+                normalization_ = 1 / (2 * sum);
+            }
+
+            void reset() noexcept {
+                received_ = 0;
+                pending_  = 0;
+            }
+
+            // Pushes a vector, returns true if the output was written.
+            bool push(const value_type* input, value_type* output) {
+                if (received_ == 0) {
+                    for (size_type i = 0; i <= 2 * width_; ++i) {
+                        std::copy_n(input, dimension_, slot(i));
+                    }
+                } else {
+                    head_ = (head_ + 1) % (2 * width_ + 1);
+                    std::copy_n(input, dimension_, slot(2 * width_));
+                }
+                ++received_;
+                if (received_ <= width_) {
+                    pending_ = received_;
+                    return false;
+                }
+                pending_ = width_;
+                emit(output);
+                return true;
+            }
+
+            // Replicates the last vector to complete a pending output, returns false if there is none.
+            bool flush(value_type* output) {
+                if (pending_ == 0) {
+                    return false;
+                }
+                head_ = (head_ + 1) % (2 * width_ + 1);
+                std::copy_n(slot(2 * width_ - 1), dimension_, slot(2 * width_));
+                --pending_;
+                emit(output);
+                return true;
+            }
+
+        private:
+            // Position i of the window, 0 being the oldest vector and 2 * width the newest one.
+            value_type* slot(size_type i) noexcept {
+                return history_.data() + ((head_ + i) % (2 * width_ + 1)) * dimension_;
+            }
+
+            void emit(value_type* output) {
+                std::copy_n(slot(width_), dimension_, output);
+                const auto offset = dimension_ - tail_;
+                auto* delta       = output + dimension_;
+                std::fill_n(delta, tail_, 0);
+                for (size_type n = 1; n <= width_; ++n) {
+                    const auto* next     = slot(width_ + n) + offset;
+                    const auto* previous = slot(width_ - n) + offset;
+                    const auto weight    = static_cast<value_type>(n) * normalization_;
+                    for (size_type i = 0; i < tail_; ++i) {
+                        delta[i] += weight * (next[i] - previous[i]);
+                    }
+                }
+            }
+
+            std::vector<value_type> history_;
+            size_type dimension_;
+            size_type tail_;
+            size_type width_;
+            size_type head_{0};
+            size_type received_{0};
+            size_type pending_{0};
+            value_type normalization_;
+        };
+
+    } // namespace internal
+
+    /**
+     * @class mfcc_extractor
+     * @brief This class computes the Mel-Frequency Cepstral Coefficients (MFCC) of audio frames.
+     *
+     * Every frame is windowed, zero-padded to nfft samples and transformed with a Real-to-Complex FFT. The power
+     * spectrum is weighted by a bank of triangular filters equally spaced on the Mel scale, and the DCT-II of the
+     * logarithm of the filter energies gives the coefficients:
+     *
+     * \f[
+     *  c_k = s_k \sum_{m=0}^{M-1} \log(E_m) \cos\left(\frac{\pi k (2m + 1)}{2M}\right)
+     * \f]
+     *
+     * where \f$ s_k \f$ is the orthonormal scaling of the DCT.
+     *
+     * The FFT and DCT plans, the filterbank and all the temporary buffers are created during the construction, so
+     * computing the coefficients never allocates. Optionally, the first and second order deltas are computed
+     * incrementally while the frames are pushed, with a latency of delta_width frames per order.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class mfcc_extractor {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %mfcc_extractor with the given configuration.
+         * @param sample_rate Sampling frequency in Hz.
+         * @param frame_size Number of samples of every frame.
+         * @param nfft Size of the FFT, it should be greater or equal than the frame size.
+         * @param filters Number of Mel filters.
+         * @param coefficients Number of cepstral coefficients, it should be less or equal than the number of filters.
+         * @param min_frequency Lower edge of the first filter in Hz.
+         * @param max_frequency Upper edge of the last filter in Hz.
+         * @param window Type of window applied to every frame.
+         * @param delta_order Order of the deltas appended to the coefficients by %push: 0, 1 or 2.
+         * @param delta_width Number of frames at each side used to compute the deltas.
+         */
+        mfcc_extractor(value_type sample_rate, size_type frame_size, size_type nfft, size_type filters,
+                       size_type coefficients, value_type min_frequency, value_type max_frequency,
+                       windowing::WindowType window = windowing::WindowType::Hamming, size_type delta_order = 0,
+                       size_type delta_width = 2);
+
+        /**
+         * @brief Returns the number of samples of every frame.
+         * @return Frame size.
+         */
+        size_type frame_size() const noexcept;
+
+        /**
+         * @brief Returns the size of the FFT.
+         * @return Size of the FFT.
+         */
+        size_type nfft() const noexcept;
+
+        /**
+         * @brief Returns the number of cepstral coefficients of every frame.
+         * @return Number of coefficients.
+         */
+        size_type coefficients() const noexcept;
+
+        /**
+         * @brief Returns the number of values emitted by %push for every frame: the coefficients and their deltas.
+         * @return coefficients() * (delta_order + 1)
+         */
+        size_type features() const noexcept;
+
+        /**
+         * @brief Returns the number of frames between a pushed frame and its features.
+         * @return delta_order * delta_width
+         */
+        size_type latency() const noexcept;
+
+        /**
+         * @brief Returns the Mel filterbank.
+         * @return Reference to the filterbank.
+         */
+        const auditory::filterbank<T>& filterbank() const noexcept;
+
+        /**
+         * @brief Computes the coefficients of a frame of frame_size() samples, beginning at first, and stores them in
+         * another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the frame.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt compute(InputIt first, OutputIt d_first);
+
+        /**
+         * @brief Computes the coefficients of a batch of frames stored one after the other, beginning at first, and
+         * stores the coefficients of every frame one after the other in another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the frames, every one of frame_size() samples.
+         * @param frames Number of frames.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt compute(InputIt first, size_type frames, OutputIt d_first);
+
+        /**
+         * @brief Pushes a frame of frame_size() samples, beginning at first, and stores the features of the frame
+         * pushed latency() frames before in another range, beginning at d_first.
+         *
+         * The features are the coefficients followed by their deltas and delta-deltas, as many as the delta order.
+         * @param first Input iterator defining the beginning of the frame.
+         * @param d_first Output iterator defining the beginning of the destination range, it stores features() values.
+         * @return True if the features were stored, false while the first latency() frames are pushed.
+         */
+        template <typename InputIt, typename OutputIt>
+        bool push(InputIt first, OutputIt d_first);
+
+        /**
+         * @brief Stores the features of the next pending frame at the end of the stream.
+         *
+         * Call it until it returns false to retrieve the last latency() frames.
+         * @param d_first Output iterator defining the beginning of the destination range, it stores features() values.
+         * @return True if the features were stored, false if there are no pending frames.
+         */
+        template <typename OutputIt>
+        bool flush(OutputIt d_first);
+
+        /**
+         * @brief Discards the pending frames of the deltas.
+         */
+        void reset() noexcept;
+
+    private:
+        template <typename OutputIt>
+        bool emit(bool ready, OutputIt d_first);
+
+        std::unique_ptr<fft_engine<T>> engine_;
+        std::unique_ptr<fft_engine<T>> dct_engine_;
+        auditory::filterbank<T> filterbank_;
+        std::vector<value_type> window_;
+        std::vector<value_type> windowed_;
+        std::vector<complex_type> spectrum_;
+        std::vector<value_type> power_;
+        std::vector<value_type> energies_;
+        std::vector<value_type> cepstrum_;
+        std::vector<value_type> scaling_;
+        std::vector<value_type> features_;
+        std::vector<internal::delta_stage<T>> stages_;
+        size_type coefficients_;
+        size_type delta_width_;
+    };
+
+    template <typename T>
+    mfcc_extractor<T>::mfcc_extractor(value_type sample_rate, size_type frame_size, size_type nfft, size_type filters,
+                                      size_type coefficients, value_type min_frequency, value_type max_frequency,
+                                      windowing::WindowType window, size_type delta_order, size_type delta_width) :
+        engine_(std::make_unique<fft_engine<T>>(nfft, std::initializer_list<fft_kind>{fft_kind::RealForward})),
+        dct_engine_(std::make_unique<fft_engine<T>>(filters, std::initializer_list<fft_kind>{fft_kind::Cosine})),
+        filterbank_(auditory::auditory_scale::mel, filters, min_frequency, max_frequency, sample_rate, nfft),
+        window_(frame_size),
+        windowed_(nfft, 0),
+        spectrum_(make_fft_size(nfft)),
+        power_(make_fft_size(nfft)),
+        energies_(filters),
+        cepstrum_(filters),
+        scaling_(coefficients),
+        features_(coefficients * (delta_order + 1)),
+        coefficients_(coefficients),
+        delta_width_(delta_width) {
+        meta::expects(frame_size > 0 && frame_size <= nfft, "The frame size should be in the range [1, nfft]");
+        meta::expects(coefficients > 0 && coefficients <= filters, "The coefficients should be in [1, filters]");
+        meta::expects(delta_order <= 2, "The order of the deltas should be 0, 1 or 2");
+        meta::expects(delta_order == 0 || delta_width > 0, "The width of the deltas should be greater than zero");
+        windowing::make_window(window, std::begin(window_), std::end(window_));
+
+        // Orthonormal DCT-II, the unnormalized transform computes 2 sum x_m cos(pi k (2m + 1) / 2M).
+        const auto size = static_cast<value_type>(filters);
+        for (size_type k = 0; k < coefficients; ++k) {
+            scaling_[k] = std::sqrt(1 / ((k == 0 ? 4 : 2) * size));
+        }
+
+        // The k-th stage delays the coefficients and the previous deltas, and differentiates the last ones.
+        for (size_type k = 1; k <= delta_order; ++k) {
+            stages_.emplace_back(k * coefficients, coefficients, delta_width);
+        }
+    }
+
+    template <typename T>
+    typename mfcc_extractor<T>::size_type mfcc_extractor<T>::frame_size() const noexcept {
+        return window_.size();
+    }
+
+    template <typename T>
+    typename mfcc_extractor<T>::size_type mfcc_extractor<T>::nfft() const noexcept {
+        return windowed_.size();
+    }
+
+    template <typename T>
+    typename mfcc_extractor<T>::size_type mfcc_extractor<T>::coefficients() const noexcept {
+        return coefficients_;
+    }
+
+    template <typename T>
+    typename mfcc_extractor<T>::size_type mfcc_extractor<T>::features() const noexcept {
+        return features_.size();
+    }
+
+    template <typename T>
+    typename mfcc_extractor<T>::size_type mfcc_extractor<T>::latency() const noexcept {
+        return stages_.size() * delta_width_;
+    }
+
+    template <typename T>
+    const auditory::filterbank<T>& mfcc_extractor<T>::filterbank() const noexcept {
+        return filterbank_;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt mfcc_extractor<T>::compute(InputIt first, OutputIt d_first) {
+        const auto frame_size = window_.size();
+        for (size_type i = 0; i < frame_size; ++i, ++first) {
+            windowed_[i] = *first * window_[i];
+        }
+        engine_->dft(windowed_.data(), spectrum_.data());
+        std::transform(std::cbegin(spectrum_), std::cend(spectrum_), std::begin(power_),
+                       [](const complex_type& bin) { return bin.real() * bin.real() + bin.imag() * bin.imag(); });
+        filterbank_.apply(std::cbegin(power_), std::begin(energies_));
+
+        const auto floor = std::numeric_limits<value_type>::min();
+        for (auto& energy : energies_) {
+            energy = std::log(std::max(energy, floor));
+        }
+        dct_engine_->dct(energies_.data(), cepstrum_.data());
+        for (size_type k = 0; k < coefficients_; ++k, ++d_first) {
+            *d_first = cepstrum_[k] * scaling_[k];
+        }
+        return d_first;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt mfcc_extractor<T>::compute(InputIt first, size_type frames, OutputIt d_first) {
+        for (size_type i = 0; i < frames; ++i) {
+            d_first = compute(first, d_first);
+            std::advance(first, window_.size());
+        }
+        return d_first;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    bool mfcc_extractor<T>::push(InputIt first, OutputIt d_first) {
+        compute(first, std::begin(features_));
+        auto ready = true;
+        for (size_type k = 0; k < stages_.size() && ready; ++k) {
+            ready = stages_[k].push(features_.data(), features_.data());
+        }
+        return emit(ready, d_first);
+    }
+
+    template <typename T>
+    template <typename OutputIt>
+    bool mfcc_extractor<T>::flush(OutputIt d_first) {
+        // The pending frames of a stage feed the next ones, which emit as soon as they are complete.
+        for (size_type k = 0; k < stages_.size(); ++k) {
+            if (stages_[k].flush(features_.data())) {
+                auto ready = true;
+                for (auto next = k + 1; next < stages_.size() && ready; ++next) {
+                    ready = stages_[next].push(features_.data(), features_.data());
+                }
+                if (ready) {
+                    return emit(true, d_first);
+                }
+                return flush(d_first);
+            }
+        }
+        return false;
+    }
+
+    template <typename T>
+    void mfcc_extractor<T>::reset() noexcept {
+        for (auto& stage : stages_) {
+            stage.reset();
+        }
+    }
+
+    template <typename T>
+    template <typename OutputIt>
+    bool mfcc_extractor<T>::emit(bool ready, OutputIt d_first) {
+        if (ready) {
+            std::copy(std::cbegin(features_), std::cend(features_), d_first);
+        }
+        return ready;
+    }
+
+}}} // namespace edsp::feature::spectral
+
+#endif //EDSP_MFCC_EXTRACTOR_HPP
@@ -24,6 +24,12 @@
 
 #include <edsp/filter/biquad.hpp>
 #include <edsp/filter/biquad_cascade.hpp>
+#include <edsp/filter/biquad_bank.hpp>
+#include <edsp/filter/parallel_biquad.hpp>
+#include <edsp/filter/smoothed_biquad.hpp>
+#include <edsp/filter/state_variable_filter.hpp>
+#include <edsp/filter/fir_filter.hpp>
+#include <edsp/filter/hilbert_filter.hpp>
 #include <edsp/filter/moving_median_filter.hpp>
 #include <edsp/filter/moving_average_filter.hpp>
 #include <edsp/filter/moving_rms_filter.hpp>
@@ -32,6 +32,9 @@
 
 namespace edsp { namespace filter {
 
+    template <typename T, std::size_t N>
+    class biquad_cascade;
+
     /**
     * @brief The filter_type enum defines the different available filters.
     */
@@ -182,6 +185,14 @@ namespace edsp { namespace filter {
         template <typename InputIt, typename OutputIt>
         constexpr void filter(InputIt first, InputIt last, OutputIt d_first);
 
+        /**
+         * @brief Filters in-place a block of samples.
+         * @param data Pointer to the first sample of the block.
+         * @param size Number of samples of the block.
+         * @see filter
+         */
+        constexpr void process(value_type* data, std::size_t size) noexcept;
+
         /**
          * @brief Reset the filter to the original state
          */
@@ -209,6 +220,9 @@ namespace edsp { namespace filter {
         constexpr value_type tick(T value) noexcept;
 
     private:
+        template <typename, std::size_t>
+        friend class biquad_cascade;
+
         value_type b2_{0};
         value_type b1_{0};
         value_type b0_{1};
@@ -317,9 +331,24 @@ namespace edsp { namespace filter {
     template <typename T>
     template <typename InputIt, typename OutputIt>
     constexpr void biquad<T>::filter(InputIt first, InputIt last, OutputIt d_first) {
+        // The coefficients and the state are kept in locals, otherwise every store to the output could alias them
+        // and the compiler would reload them from memory for every sample.
+        const auto b0 = b0_, b1 = b1_, b2 = b2_, a1 = a1_, a2 = a2_;
+        auto w0 = w0_, w1 = w1_;
         for (; first != last; ++first, ++d_first) {
-            *d_first = tick(*first);
+            const value_type value = *first;
+            const auto out         = b0 * value + w0;
+            w0                     = b1 * value - a1 * out + w1;
+            w1                     = b2 * value - a2 * out;
+            *d_first               = out;
         }
+        w0_ = w0;
+        w1_ = w1;
+    }
+
+    template <typename T>
+    constexpr void biquad<T>::process(value_type* data, std::size_t size) noexcept {
+        filter(data, data + size, data);
     }
 
     template <typename T>
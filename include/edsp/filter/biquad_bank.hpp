@@ -0,0 +1,205 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: biquad_bank.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_FILTER_BIQUAD_BANK_HPP
+#define EDSP_FILTER_BIQUAD_BANK_HPP
+
+#include <edsp/filter/biquad.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <array>
+
+namespace edsp { namespace filter {
+
+    /**
+     * @class biquad_bank
+     * @brief This class filters several channels with one biquad per channel, every channel in its own lane.
+     *
+     * The coefficients and the state of the biquads are stored in a Structure of Arrays layout. The samples of an
+     * interleaved buffer, such as the one returned by decoder::read, are contiguous for a given time-step, so every
+     * time-step is computed with the same operations over all the lanes. The recursion only runs across time, never
+     * across lanes, so the compiler vectorizes the lanes for the SIMD instruction set of the target (SSE, AVX or
+     * NEON) and the throughput grows almost linearly with the number of lanes.
+     *
+     * Every lane may have its own coefficients. Several banks can be chained to implement an equalizer of several
+     * sections.
+     *
+     * @tparam T Floating point type.
+     * @tparam Lanes Number of channels.
+     */
+    template <typename T, std::size_t Lanes>
+    class biquad_bank {
+    public:
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        /**
+         * @brief Creates a %biquad_bank where every lane is an identity filter.
+         */
+        constexpr biquad_bank() noexcept;
+
+        /**
+         * @brief Creates a %biquad_bank where every lane uses the coefficients of the given filter.
+         * @param filter Biquad filter.
+         */
+        constexpr explicit biquad_bank(const biquad<T>& filter) noexcept;
+
+        /**
+         * @brief Returns the number of lanes.
+         * @return Number of channels.
+         */
+        constexpr size_type lanes() const noexcept;
+
+        /**
+         * @brief Updates the coefficients of every lane with the ones of the given filter.
+         * @note The state of the filters is not modified.
+         * @param filter Biquad filter.
+         */
+        constexpr void set(const biquad<T>& filter) noexcept;
+
+        /**
+         * @brief Updates the coefficients of a lane with the ones of the given filter.
+         * @note The state of the filter is not modified.
+         * @param lane Index of the lane.
+         * @param filter Biquad filter.
+         */
+        constexpr void set(size_type lane, const biquad<T>& filter);
+
+        /**
+         * @brief Returns the filter of a lane, with its current coefficients and an empty state.
+         * @param lane Index of the lane.
+         * @return Biquad filter.
+         */
+        constexpr biquad<T> get(size_type lane) const;
+
+        /**
+         * @brief Reset the filters of all the lanes to the original state.
+         */
+        constexpr void reset() noexcept;
+
+        /**
+         * @brief Filters in-place an interleaved buffer.
+         *
+         * The buffer may store more channels than lanes: the lane l filters the samples data[n * stride + l], so
+         * the channels beginning at any position can be filtered by offsetting the pointer.
+         * @param data Pointer to the first sample of the first channel to filter.
+         * @param frames Number of time-steps of the buffer.
+         * @param stride Distance between two consecutive samples of the same channel, Lanes by default.
+         */
+        constexpr void process(T* data, size_type frames, size_type stride = Lanes) noexcept;
+
+        /**
+         * @brief Filters an interleaved buffer and stores the result in another interleaved buffer.
+         * @param src Pointer to the first sample of the first channel to filter.
+         * @param dst Pointer to the first sample of the first channel of the destination buffer.
+         * @param frames Number of time-steps of the buffers.
+         * @param src_stride Distance between two consecutive samples of the same channel in the input.
+         * @param dst_stride Distance between two consecutive samples of the same channel in the output.
+         */
+        constexpr void filter(const T* src, T* dst, size_type frames, size_type src_stride = Lanes,
+                              size_type dst_stride = Lanes) noexcept;
+
+    private:
+        // Every time-step is computed in locals, so the stores to the output cannot alias the coefficients nor the
+        // state, which would prevent the vectorization of the lanes.
+        struct lanes_type {
+            std::array<T, Lanes> b0, b1, b2, a1, a2, w0, w1;
+        };
+
+        lanes_type lanes_{};
+    };
+
+    template <typename T, std::size_t Lanes>
+    constexpr biquad_bank<T, Lanes>::biquad_bank() noexcept : biquad_bank(biquad<T>{}) {}
+
+    template <typename T, std::size_t Lanes>
+    constexpr biquad_bank<T, Lanes>::biquad_bank(const biquad<T>& filter) noexcept {
+        static_assert(Lanes > 0, "Expecting at least one lane");
+        set(filter);
+    }
+
+    template <typename T, std::size_t Lanes>
+    constexpr typename biquad_bank<T, Lanes>::size_type biquad_bank<T, Lanes>::lanes() const noexcept {
+        return Lanes;
+    }
+
+    template <typename T, std::size_t Lanes>
+    constexpr void biquad_bank<T, Lanes>::set(const biquad<T>& filter) noexcept {
+        for (size_type lane = 0; lane < Lanes; ++lane) {
+            lanes_.b0[lane] = filter.b0() / filter.a0();
+            lanes_.b1[lane] = filter.b1() / filter.a0();
+            lanes_.b2[lane] = filter.b2() / filter.a0();
+            lanes_.a1[lane] = filter.a1() / filter.a0();
+            lanes_.a2[lane] = filter.a2() / filter.a0();
+        }
+    }
+
+    template <typename T, std::size_t Lanes>
+    constexpr void biquad_bank<T, Lanes>::set(size_type lane, const biquad<T>& filter) {
+        meta::expects(lane < Lanes, "Lane out of range");
+        lanes_.b0[lane] = filter.b0() / filter.a0();
+        lanes_.b1[lane] = filter.b1() / filter.a0();
+        lanes_.b2[lane] = filter.b2() / filter.a0();
+        lanes_.a1[lane] = filter.a1() / filter.a0();
+        lanes_.a2[lane] = filter.a2() / filter.a0();
+    }
+
+    template <typename T, std::size_t Lanes>
+    constexpr biquad<T> biquad_bank<T, Lanes>::get(size_type lane) const {
+        meta::expects(lane < Lanes, "Lane out of range");
+        return biquad<T>(1, lanes_.a1[lane], lanes_.a2[lane], lanes_.b0[lane], lanes_.b1[lane], lanes_.b2[lane]);
+    }
+
+    template <typename T, std::size_t Lanes>
+    constexpr void biquad_bank<T, Lanes>::reset() noexcept {
+        lanes_.w0.fill(0);
+        lanes_.w1.fill(0);
+    }
+
+    template <typename T, std::size_t Lanes>
+    constexpr void biquad_bank<T, Lanes>::process(T* data, size_type frames, size_type stride) noexcept {
+        filter(data, data, frames, stride, stride);
+    }
+
+    template <typename T, std::size_t Lanes>
+    constexpr void biquad_bank<T, Lanes>::filter(const T* src, T* dst, size_type frames, size_type src_stride,
+                                                 size_type dst_stride) noexcept {
+        auto local = lanes_;
+        for (size_type n = 0; n < frames; ++n) {
+            const auto* input = src + n * src_stride;
+            T output[Lanes];
+            for (size_type l = 0; l < Lanes; ++l) {
+                const auto value = input[l];
+                const auto out   = local.b0[l] * value + local.w0[l];
+                local.w0[l]      = local.b1[l] * value - local.a1[l] * out + local.w1[l];
+                local.w1[l]      = local.b2[l] * value - local.a2[l] * out;
+                output[l]        = out;
+            }
+            std::copy_n(output, Lanes, dst + n * dst_stride);
+        }
+        lanes_.w0 = local.w0;
+        lanes_.w1 = local.w1;
+    }
+
+}} // namespace edsp::filter
+
+#endif //EDSP_FILTER_BIQUAD_BANK_HPP
@@ -25,6 +25,7 @@
 #include <edsp/meta/expects.hpp>
 #include <edsp/meta/ensure.hpp>
 #include <edsp/filter/biquad.hpp>
+#include <algorithm>
 #include <array>
 #include <edsp/meta/iterator.hpp>
 
@@ -155,6 +156,18 @@ namespace edsp { namespace filter {
         template <typename InputIt, typename OutputIt>
         constexpr void filter(InputIt first, InputIt last, OutputIt d_first);
 
+        /**
+         * @brief Filters in-place a block of samples.
+         *
+         * The block is processed in tiles of tile_size samples, which stay in the L1 cache across all the stages.
+         * The stages filter the whole tile in groups of up to four before the next group starts, so the coefficients
+         * and the state of a group stay in registers, and the independent recursions of the group hide the latency
+         * of each other.
+         * @param data Pointer to the first sample of the block.
+         * @param size Number of samples of the block.
+         */
+        constexpr void process(T* data, size_type size) noexcept;
+
         /**
          * @brief Computes the output of filtering one digital time-step.
          * @param value Input value to be filtered.
@@ -175,7 +188,15 @@ namespace edsp { namespace filter {
         template <typename... Arg>
         constexpr void emplace_back(Arg... arg);
 
+        /**
+         * @brief Number of samples processed by every stage before moving to the next one.
+         */
+        static constexpr size_type tile_size = 256;
+
     private:
+        template <std::size_t Stages>
+        static constexpr void process_stages(biquad<T>* stages, T* data, size_type size) noexcept;
+
         std::size_t num_stage_{0};
         std::array<biquad<T>, N> cascade_{};
     };
@@ -216,8 +237,81 @@ namespace edsp { namespace filter {
     template <typename T, size_t N>
     template <typename InputIt, typename OutputIt>
     constexpr void biquad_cascade<T, N>::filter(InputIt first, InputIt last, OutputIt d_first) {
-        for (; first != last; ++first, ++d_first) {
-            *d_first = tick(*first);
+        std::array<T, tile_size> tile{};
+        while (first != last) {
+            size_type count = 0;
+            for (; count < tile_size && first != last; ++count, ++first) {
+                tile[count] = *first;
+            }
+            process(tile.data(), count);
+            d_first = std::copy_n(std::cbegin(tile), count, d_first);
+        }
+    }
+
+    template <typename T, size_t N>
+    constexpr void biquad_cascade<T, N>::process(T* data, size_type size) noexcept {
+        for (size_type offset = 0; offset < size; offset += tile_size) {
+            const auto count = (size - offset < tile_size) ? size - offset : tile_size;
+            auto* tile       = data + offset;
+            size_type i      = 0;
+            for (; i + 4 <= num_stage_; i += 4) {
+                process_stages<4>(cascade_.data() + i, tile, count);
+            }
+            for (; i + 2 <= num_stage_; i += 2) {
+                process_stages<2>(cascade_.data() + i, tile, count);
+            }
+            for (; i < num_stage_; ++i) {
+                process_stages<1>(cascade_.data() + i, tile, count);
+            }
+        }
+    }
+
+    inline namespace internal {
+
+        template <typename T>
+        struct biquad_section {
+            T b0, b1, b2, a1, a2, w0, w1;
+        };
+
+        // Unrolls the stages at compile time, so every section is kept in registers instead of an indexed array.
+        template <std::size_t Stage, std::size_t Stages>
+        struct biquad_unroller {
+            template <typename T>
+            static constexpr T tick(biquad_section<T> (&sections)[Stages], T value) noexcept {
+                auto& section  = sections[Stage];
+                const auto out = section.b0 * value + section.w0;
+                section.w0     = section.b1 * value - section.a1 * out + section.w1;
+                section.w1     = section.b2 * value - section.a2 * out;
+                return biquad_unroller<Stage + 1, Stages>::tick(sections, out);
+            }
+        };
+
+        template <std::size_t Stages>
+        struct biquad_unroller<Stages, Stages> {
+            template <typename T>
+            static constexpr T tick(biquad_section<T> (&)[Stages], T value) noexcept {
+                return value;
+            }
+        };
+
+    } // namespace internal
+
+    template <typename T, size_t N>
+    template <std::size_t Stages>
+    constexpr void biquad_cascade<T, N>::process_stages(biquad<T>* stages, T* data, size_type size) noexcept {
+        // The recursion of a single stage is bound by the latency of its feedback path. Running a few stages per
+        // sample keeps that many independent recursions in flight, while their coefficients still fit in registers.
+        internal::biquad_section<T> sections[Stages]{};
+        for (std::size_t j = 0; j < Stages; ++j) {
+            const auto& stage = stages[j];
+            sections[j]       = {stage.b0_, stage.b1_, stage.b2_, stage.a1_, stage.a2_, stage.w0_, stage.w1_};
+        }
+        for (size_type n = 0; n < size; ++n) {
+            data[n] = internal::biquad_unroller<0, Stages>::tick(sections, data[n]);
+        }
+        for (std::size_t j = 0; j < Stages; ++j) {
+            stages[j].w0_ = sections[j].w0;
+            stages[j].w1_ = sections[j].w1;
         }
     }
 
@@ -0,0 +1,287 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: fir_filter.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_FILTER_FIR_FILTER_HPP
+#define EDSP_FILTER_FIR_FILTER_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace edsp { namespace filter {
+
+    /**
+     * @class fir_filter
+     * @brief This class implements a streaming Finite Impulse Response (FIR) filter.
+     *
+     * The output of the filter is the convolution of the input with the coefficients b of the filter:
+     *
+     * \f[
+     *  y[n] = \sum_{k=0}^{N-1} b_k x[n-k]
+     * \f]
+     *
+     * Short kernels are computed in direct form, several outputs at once, so the compiler vectorizes the outputs
+     * without reassociating the additions. Kernels with at least crossover coefficients are computed in blocks with
+     * the FFT overlap-save method. A full block costs O(log N) per sample, but every call pays the FFTs of a whole
+     * block, so a call shorter than fft_threshold() samples is computed in direct form instead: streaming small
+     * blocks never costs more than the direct form.
+     *
+     * Both methods share the same state, the last N - 1 input samples, so the filter does not introduce any latency
+     * and the input can be processed block by block in calls of any length.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class fir_filter {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Default number of coefficients from which the overlap-save method is used.
+         *
+         * Tuned with benchmark/fir_filter_benchmark.cpp: depending on the optimization flags, the overlap-save method
+         * wins from 96 to 192 coefficients in double precision and from 192 to 384 coefficients in single precision.
+         */
+        static constexpr size_type default_crossover = 192;
+
+        /**
+         * @brief Creates a %fir_filter with the coefficients in the range [first, last).
+         * @param first Input iterator defining the beginning of the coefficients range.
+         * @param last Input iterator defining the ending of the coefficients range.
+         * @param crossover Minimum number of coefficients to use the overlap-save method.
+         */
+        template <typename InputIt>
+        fir_filter(InputIt first, InputIt last, size_type crossover = default_crossover);
+
+        /**
+         * @brief Returns the number of coefficients of the filter.
+         * @return Number of coefficients.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Checks if the filter uses the FFT overlap-save method.
+         * @return true if the overlap-save method is used, false if the direct form is used.
+         */
+        bool uses_fft() const noexcept;
+
+        /**
+         * @brief Returns the minimum number of samples of a block computed with the overlap-save method.
+         *
+         * Shorter blocks are computed in direct form.
+         * @return Break-even length of a block, zero if the filter only uses the direct form.
+         */
+        size_type fft_threshold() const noexcept;
+
+        /**
+         * @brief Resets the state of the filter.
+         */
+        void reset();
+
+        /**
+         * @brief Filters the elements in the range [first, last) and stores the result in another range, beginning at
+         * d_first.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         */
+        template <typename InputIt, typename OutputIt>
+        void filter(InputIt first, InputIt last, OutputIt d_first);
+
+        /**
+         * @brief Filters a single element.
+         * @param tick Input sample.
+         * @return The output of the filter.
+         */
+        value_type operator()(value_type tick);
+
+    private:
+        template <typename OutputIt>
+        OutputIt direct(size_type count, OutputIt d_first);
+
+        template <typename OutputIt>
+        OutputIt overlap_save(size_type count, OutputIt d_first);
+
+        void shift(size_type count);
+
+        // Number of outputs computed at once by the direct form.
+        static constexpr size_type lanes = 32;
+
+        // Cost of the overlap-save method for a block, in multiply-adds of the direct form per N log2(N) samples of
+        // the FFT. Tuned with benchmark/fir_filter_benchmark.cpp.
+        static constexpr size_type fft_cost = 12;
+
+        std::unique_ptr<spectral::fft_engine<T>> engine_;
+        std::vector<value_type> reversed_;
+        std::vector<value_type> line_;
+        std::vector<value_type> output_;
+        std::vector<complex_type> response_;
+        std::vector<complex_type> spectrum_;
+        size_type block_size_;
+        size_type threshold_{0};
+    };
+
+    template <typename T>
+    template <typename InputIt>
+    fir_filter<T>::fir_filter(InputIt first, InputIt last, size_type crossover) :
+        reversed_(first, last) {
+        meta::expects(!reversed_.empty(), "Not expecting an empty set of coefficients");
+        std::reverse(std::begin(reversed_), std::end(reversed_));
+        const auto taps = reversed_.size();
+
+        // The delay line stores the last N - 1 input samples followed by the block being processed.
+        size_type nfft = 2;
+        while (nfft < 2 * taps) {
+            nfft *= 2;
+        }
+        block_size_ = nfft - taps + 1;
+        line_.resize(nfft, static_cast<value_type>(0));
+
+        if (taps >= crossover) {
+            engine_ = std::make_unique<spectral::fft_engine<T>>(
+                nfft, std::initializer_list<spectral::fft_kind>{spectral::fft_kind::RealForward,
+                                                                spectral::fft_kind::RealBackward});
+            output_.resize(nfft);
+            response_.resize(spectral::make_fft_size(nfft));
+            spectrum_.resize(spectral::make_fft_size(nfft));
+
+            // The inverse FFT scaling is folded in the response of the filter.
+            std::vector<value_type> coefficients(nfft, static_cast<value_type>(0));
+            std::reverse_copy(std::cbegin(reversed_), std::cend(reversed_), std::begin(coefficients));
+            engine_->dft(coefficients.data(), response_.data());
+            const auto scaling = static_cast<value_type>(nfft);
+            for (auto& value : response_) {
+                value /= scaling;
+            }
+
+            size_type stages = 0;
+            while ((size_type{1} << stages) < nfft) {
+                ++stages;
+            }
+            threshold_ = std::min(block_size_, (fft_cost * nfft * stages + taps - 1) / taps);
+        }
+    }
+
+    template <typename T>
+    typename fir_filter<T>::size_type fir_filter<T>::size() const noexcept {
+        return reversed_.size();
+    }
+
+    template <typename T>
+    bool fir_filter<T>::uses_fft() const noexcept {
+        return engine_ != nullptr;
+    }
+
+    template <typename T>
+    typename fir_filter<T>::size_type fir_filter<T>::fft_threshold() const noexcept {
+        return threshold_;
+    }
+
+    template <typename T>
+    void fir_filter<T>::reset() {
+        std::fill(std::begin(line_), std::end(line_), static_cast<value_type>(0));
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    void fir_filter<T>::filter(InputIt first, InputIt last, OutputIt d_first) {
+        const auto history = reversed_.size() - 1;
+        while (first != last) {
+            const auto remaining = static_cast<size_type>(std::distance(first, last));
+            const auto count     = std::min(block_size_, remaining);
+            std::copy_n(first, count, std::begin(line_) + history);
+            std::advance(first, count);
+            d_first = (uses_fft() && count >= threshold_) ? overlap_save(count, d_first) : direct(count, d_first);
+            shift(count);
+        }
+    }
+
+    template <typename T>
+    typename fir_filter<T>::value_type fir_filter<T>::operator()(value_type tick) {
+        value_type result;
+        line_[reversed_.size() - 1] = tick;
+        direct(1, &result);
+        shift(1);
+        return result;
+    }
+
+    template <typename T>
+    template <typename OutputIt>
+    OutputIt fir_filter<T>::direct(size_type count, OutputIt d_first) {
+        const auto taps = reversed_.size();
+        const auto* b   = reversed_.data();
+        const auto* x   = line_.data();
+
+        // Computes lanes consecutive outputs at once: every coefficient is multiplied by a contiguous run of inputs.
+        // Each output keeps its own accumulator, so the lanes map to SIMD registers without reassociating the
+        // additions, and the independent accumulators hide the latency of the additions.
+        size_type i = 0;
+        for (; i + lanes <= count; i += lanes) {
+            std::array<value_type, lanes> sums{};
+            for (size_type j = 0; j < taps; ++j) {
+                const auto coefficient = b[j];
+                const auto* samples    = x + i + j;
+                for (size_type l = 0; l < lanes; ++l) {
+                    sums[l] += coefficient * samples[l];
+                }
+            }
+            d_first = std::copy_n(std::cbegin(sums), lanes, d_first);
+        }
+        for (; i < count; ++i, ++d_first) {
+            value_type sum = 0;
+            for (size_type j = 0; j < taps; ++j) {
+                sum += b[j] * x[i + j];
+            }
+            *d_first = sum;
+        }
+        return d_first;
+    }
+
+    template <typename T>
+    template <typename OutputIt>
+    OutputIt fir_filter<T>::overlap_save(size_type count, OutputIt d_first) {
+        // A partial block is zero-padded: the circular convolution only wraps into the first N - 1 outputs, which are
+        // discarded anyway.
+        const auto history = reversed_.size() - 1;
+        std::fill(std::begin(line_) + history + count, std::end(line_), static_cast<value_type>(0));
+        engine_->dft(line_.data(), spectrum_.data());
+        std::transform(std::cbegin(spectrum_), std::cend(spectrum_), std::cbegin(response_), std::begin(spectrum_),
+                       std::multiplies<complex_type>());
+        engine_->idft(spectrum_.data(), output_.data());
+        return std::copy_n(std::cbegin(output_) + history, count, d_first);
+    }
+
+    template <typename T>
+    void fir_filter<T>::shift(size_type count) {
+        const auto history = reversed_.size() - 1;
+        std::copy(std::cbegin(line_) + count, std::cbegin(line_) + count + history, std::begin(line_));
+    }
+
+}} // namespace edsp::filter
+
+#endif // EDSP_FILTER_FIR_FILTER_HPP
@@ -0,0 +1,234 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: hilbert_filter.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_FILTER_HILBERT_FILTER_HPP
+#define EDSP_FILTER_HILBERT_FILTER_HPP
+
+#include <edsp/filter/fir_filter.hpp>
+#include <edsp/windowing.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace edsp { namespace filter {
+
+    /**
+     * @class hilbert_filter
+     * @brief This class computes the analytic signal of a stream with a FIR Hilbert transformer.
+     *
+     * The imaginary part is the output of an antisymmetric FIR filter of N = 2M + 1 taps, the windowed ideal
+     * Hilbert transformer:
+     *
+     * \f[
+     *  h[n] = w[n] \frac{2}{\pi (n - M)}, \quad n - M \text{ odd}
+     * \f]
+     *
+     * and zero for the rest of taps. The real part is the input delayed by the M samples of group delay of the
+     * filter, so the analytic signal has a fixed latency of M samples. The approximation is accurate in the band
+     * where the filter response is flat, longer filters extend it to lower frequencies.
+     *
+     * Unlike the FFT based spectral::hilbert_engine, the input can be processed in blocks of any length, which makes
+     * it suitable to extract the envelope or the instantaneous frequency of a stream.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class hilbert_filter {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %hilbert_filter with the given number of taps.
+         * @param taps Number of taps of the filter, it should be odd.
+         * @param window Type of window applied to the ideal response.
+         */
+        explicit hilbert_filter(size_type taps, windowing::WindowType window = windowing::WindowType::Blackman);
+
+        /**
+         * @brief Returns the number of taps of the filter.
+         * @return Number of taps.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Returns the delay between an input sample and its analytic signal.
+         * @return (size() - 1) / 2
+         */
+        size_type latency() const noexcept;
+
+        /**
+         * @brief Resets the state of the filter.
+         */
+        void reset();
+
+        /**
+         * @brief Computes the analytic signal of the samples in the range [first, last) and stores it in another
+         * range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt filter(InputIt first, InputIt last, OutputIt d_first);
+
+        /**
+         * @brief Computes the envelope, the magnitude of the analytic signal, of the samples in the range
+         * [first, last) and stores it in another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt envelope(InputIt first, InputIt last, OutputIt d_first);
+
+        /**
+         * @brief Computes the instantaneous frequency, the derivative of the phase of the analytic signal, of the
+         * samples in the range [first, last) and stores it in another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @param sample_rate Sampling frequency in Hz.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt instantaneous_frequency(InputIt first, InputIt last, OutputIt d_first, value_type sample_rate);
+
+    private:
+        template <typename InputIt, typename OutputIt, typename Function>
+        OutputIt process(InputIt first, InputIt last, OutputIt d_first, Function function);
+
+        static constexpr size_type block_size = 256;
+
+        fir_filter<T> transformer_;
+        std::vector<value_type> delay_;
+        std::vector<value_type> input_;
+        std::vector<value_type> imag_;
+        complex_type previous_{};
+        size_type position_{0};
+    };
+
+    inline namespace internal {
+
+        template <typename T>
+        inline std::vector<T> make_hilbert_taps(std::size_t taps, windowing::WindowType window) {
+            meta::expects(taps % 2 == 1, "The number of taps should be odd");
+            std::vector<T> coefficients(taps);
+            windowing::make_window(window, std::begin(coefficients), std::end(coefficients));
+            const auto middle = static_cast<std::ptrdiff_t>(taps / 2);
+            constexpr auto pi = static_cast<T>(3.141592653589793238462643383279502884L);
+            for (std::size_t i = 0; i < taps; ++i) {
+                const auto n = static_cast<std::ptrdiff_t>(i) - middle;
+                coefficients[i] *= (n % 2 != 0) ? 2 / (pi * static_cast<T>(n)) : 0;
+            }
+            return coefficients;
+        }
+
+    } // namespace internal
+
+    template <typename T>
+    hilbert_filter<T>::hilbert_filter(size_type taps, windowing::WindowType window) :
+        transformer_([&]() {
+            const auto coefficients = internal::make_hilbert_taps<T>(taps, window);
+            return fir_filter<T>(std::cbegin(coefficients), std::cend(coefficients));
+        }()),
+        delay_(taps / 2, 0),
+        input_(block_size),
+        imag_(block_size) {}
+
+    template <typename T>
+    typename hilbert_filter<T>::size_type hilbert_filter<T>::size() const noexcept {
+        return transformer_.size();
+    }
+
+    template <typename T>
+    typename hilbert_filter<T>::size_type hilbert_filter<T>::latency() const noexcept {
+        return delay_.size();
+    }
+
+    template <typename T>
+    void hilbert_filter<T>::reset() {
+        transformer_.reset();
+        std::fill(std::begin(delay_), std::end(delay_), 0);
+        previous_ = complex_type{};
+        position_ = 0;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt hilbert_filter<T>::filter(InputIt first, InputIt last, OutputIt d_first) {
+        return process(first, last, d_first, [](const complex_type& value) { return value; });
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt hilbert_filter<T>::envelope(InputIt first, InputIt last, OutputIt d_first) {
+        return process(first, last, d_first,
+                       [](const complex_type& value) { return std::hypot(value.real(), value.imag()); });
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt hilbert_filter<T>::instantaneous_frequency(InputIt first, InputIt last, OutputIt d_first,
+                                                       value_type sample_rate) {
+        constexpr auto two_pi = static_cast<value_type>(2 * 3.141592653589793238462643383279502884L);
+        const auto scaling    = sample_rate / two_pi;
+        return process(first, last, d_first, [this, scaling](const complex_type& value) {
+            // arg(z[n] conj(z[n - 1])) is the phase increment, wrapped to (-pi, pi].
+            const auto real = value.real() * previous_.real() + value.imag() * previous_.imag();
+            const auto imag = value.imag() * previous_.real() - value.real() * previous_.imag();
+            previous_       = value;
+            return std::atan2(imag, real) * scaling;
+        });
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt, typename Function>
+    OutputIt hilbert_filter<T>::process(InputIt first, InputIt last, OutputIt d_first, Function function) {
+        const auto latency = delay_.size();
+        while (first != last) {
+            size_type count = 0;
+            for (; count < block_size && first != last; ++count, ++first) {
+                input_[count] = *first;
+            }
+            transformer_.filter(std::cbegin(input_), std::cbegin(input_) + count, std::begin(imag_));
+
+            for (size_type i = 0; i < count; ++i, ++d_first) {
+                auto real = input_[i];
+                if (latency > 0) {
+                    std::swap(real, delay_[position_]);
+                    position_ = (position_ + 1 == latency) ? 0 : position_ + 1;
+                }
+                *d_first = function(complex_type(real, imag_[i]));
+            }
+        }
+        return d_first;
+    }
+
+}} // namespace edsp::filter
+
+#endif //EDSP_FILTER_HILBERT_FILTER_HPP
@@ -0,0 +1,364 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: parallel_biquad.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_FILTER_PARALLEL_BIQUAD_HPP
+#define EDSP_FILTER_PARALLEL_BIQUAD_HPP
+
+#include <edsp/filter/biquad.hpp>
+#include <edsp/filter/biquad_cascade.hpp>
+#include <edsp/meta/expects.hpp>
+#include <edsp/meta/ensure.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+namespace edsp { namespace filter {
+
+    /**
+     * @class parallel_biquad
+     * @brief This class implements an IIR filter as a sum of second order sections in parallel.
+     *
+     * The transfer function is expanded in partial fractions:
+     *
+     * \f[
+     *    H(z) = c + \sum_{k} \frac{\beta_{0,k} + \beta_{1,k} z^{-1}}{1 + \alpha_{1,k} z^{-1} + \alpha_{2,k} z^{-2}}
+     * \f]
+     *
+     * Unlike a cascade, where every section waits for the output of the previous one, all the sections read the same
+     * input and are independent. Their coefficients and state are stored in a Structure of Arrays layout, so the
+     * compiler computes the sections of every time-step in parallel SIMD lanes.
+     *
+     * @tparam T Floating point type.
+     * @tparam N Maximum number of sections.
+     * @see make_parallel_biquad
+     */
+    template <typename T, std::size_t N>
+    class parallel_biquad {
+    public:
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        /**
+         * @brief Creates an empty %parallel_biquad, a filter with gain zero.
+         */
+        constexpr parallel_biquad() noexcept = default;
+
+        /**
+         * @brief Returns the number of sections.
+         * @return Number of sections.
+         */
+        constexpr size_type size() const noexcept;
+
+        /**
+         * @brief Returns the maximum number of sections the filter is able to hold.
+         * @return Maximum number of sections.
+         */
+        constexpr size_type max_size() const noexcept;
+
+        /**
+         * @brief Returns the direct gain c, added to the output of the sections.
+         * @return Direct gain.
+         */
+        constexpr value_type gain() const noexcept;
+
+        /**
+         * @brief Updates the direct gain c.
+         * @param gain Direct gain.
+         */
+        constexpr void set_gain(value_type gain) noexcept;
+
+        /**
+         * @brief Returns the section at the specified location, with an empty state.
+         * @param index Position of the section.
+         * @return Biquad filter.
+         */
+        constexpr biquad<T> operator[](size_type index) const;
+
+        /**
+         * @brief Appends the given section.
+         * @note The section should not have any \f$ b_2 \f$ coefficient, it is ignored.
+         * @param section Biquad filter.
+         */
+        constexpr void push_back(const biquad<T>& section);
+
+        /**
+         * @brief Reset all the sections to the original state.
+         */
+        constexpr void reset() noexcept;
+
+        /**
+         * @brief Computes the output of filtering one digital time-step.
+         * @param value Input value to be filtered.
+         * @return Filtered value.
+         */
+        constexpr T tick(T value) noexcept;
+
+        /**
+         * @brief Filters the signal in the range [first, last) and stores the result in another range, beginning at
+         * d_first.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         */
+        template <typename InputIt, typename OutputIt>
+        constexpr void filter(InputIt first, InputIt last, OutputIt d_first);
+
+        /**
+         * @brief Filters in-place a block of samples.
+         * @param data Pointer to the first sample of the block.
+         * @param size Number of samples of the block.
+         */
+        constexpr void process(T* data, size_type size) noexcept;
+
+    private:
+        // The unused sections have all their coefficients set to zero, so the loops always run over the N lanes and
+        // can be vectorized.
+        struct sections_type {
+            std::array<T, N> b0{}, b1{}, a1{}, a2{}, w0{}, w1{};
+        };
+
+        sections_type sections_{};
+        value_type gain_{0};
+        size_type size_{0};
+    };
+
+    template <typename T, std::size_t N>
+    constexpr typename parallel_biquad<T, N>::size_type parallel_biquad<T, N>::size() const noexcept {
+        return size_;
+    }
+
+    template <typename T, std::size_t N>
+    constexpr typename parallel_biquad<T, N>::size_type parallel_biquad<T, N>::max_size() const noexcept {
+        return N;
+    }
+
+    template <typename T, std::size_t N>
+    constexpr typename parallel_biquad<T, N>::value_type parallel_biquad<T, N>::gain() const noexcept {
+        return gain_;
+    }
+
+    template <typename T, std::size_t N>
+    constexpr void parallel_biquad<T, N>::set_gain(value_type gain) noexcept {
+        gain_ = gain;
+    }
+
+    template <typename T, std::size_t N>
+    constexpr biquad<T> parallel_biquad<T, N>::operator[](size_type index) const {
+        meta::expects(index < size_, "Section out of range");
+        return biquad<T>(1, sections_.a1[index], sections_.a2[index], sections_.b0[index], sections_.b1[index], 0);
+    }
+
+    template <typename T, std::size_t N>
+    constexpr void parallel_biquad<T, N>::push_back(const biquad<T>& section) {
+        meta::ensure(size_ < N, "No space available");
+        sections_.b0[size_] = section.b0() / section.a0();
+        sections_.b1[size_] = section.b1() / section.a0();
+        sections_.a1[size_] = section.a1() / section.a0();
+        sections_.a2[size_] = section.a2() / section.a0();
+        ++size_;
+    }
+
+    template <typename T, std::size_t N>
+    constexpr void parallel_biquad<T, N>::reset() noexcept {
+        sections_.w0.fill(0);
+        sections_.w1.fill(0);
+    }
+
+    template <typename T, std::size_t N>
+    constexpr T parallel_biquad<T, N>::tick(T value) noexcept {
+        process(&value, 1);
+        return value;
+    }
+
+    template <typename T, std::size_t N>
+    template <typename InputIt, typename OutputIt>
+    constexpr void parallel_biquad<T, N>::filter(InputIt first, InputIt last, OutputIt d_first) {
+        constexpr size_type tile_size = 256;
+        std::array<T, tile_size> tile{};
+        while (first != last) {
+            size_type count = 0;
+            for (; count < tile_size && first != last; ++count, ++first) {
+                tile[count] = *first;
+            }
+            process(tile.data(), count);
+            d_first = std::copy_n(std::cbegin(tile), count, d_first);
+        }
+    }
+
+    template <typename T, std::size_t N>
+    constexpr void parallel_biquad<T, N>::process(T* data, size_type size) noexcept {
+        auto local = sections_;
+        for (size_type n = 0; n < size; ++n) {
+            const auto value = data[n];
+            T output[N];
+            for (size_type k = 0; k < N; ++k) {
+                const auto out = local.b0[k] * value + local.w0[k];
+                local.w0[k]    = local.b1[k] * value - local.a1[k] * out + local.w1[k];
+                local.w1[k]    = -local.a2[k] * out;
+                output[k]      = out;
+            }
+            auto sum = gain_ * value;
+            for (size_type k = 0; k < N; ++k) {
+                sum += output[k];
+            }
+            data[n] = sum;
+        }
+        sections_.w0 = local.w0;
+        sections_.w1 = local.w1;
+    }
+
+    inline namespace internal {
+
+        // Evaluates the product of second order polynomials in z^-1 at the given point. The product is never
+        // expanded: the expanded numerator of a high order filter cancels catastrophically near its zeros.
+        template <typename T>
+        inline std::complex<T> evaluate_sections(const std::vector<std::array<T, 3>>& sections,
+                                                 const std::complex<T>& w) {
+            std::complex<T> result(1);
+            for (const auto& section : sections) {
+                result *= section[0] + w * (section[1] + w * section[2]);
+            }
+            return result;
+        }
+
+    } // namespace internal
+
+    /**
+     * @brief Converts a cascade of biquads into the equivalent sum of second order sections in parallel.
+     *
+     * The poles of every section of the cascade are computed from its denominator, the residues of the poles from
+     * the whole transfer function, and the pairs of complex conjugate (or real) poles are grouped back into second
+     * order sections. The computation is done in long double precision.
+     *
+     * @note The poles of the cascade should be distinct and non-zero, and the degree of the numerator should not be
+     * greater than the number of poles, which is the case of the filters built by the designers.
+     * @note The parallel form is more sensitive to the rounding of its coefficients than the cascade when the poles are
+     * clustered, as in high order filters with a low cutoff. In single precision a 16th order Butterworth filter loses
+     * about two digits, so double precision is recommended for orders above 8.
+     * @param cascade Cascade of biquads.
+     * @return Equivalent parallel filter.
+     */
+    template <typename T, std::size_t N>
+    parallel_biquad<T, N> make_parallel_biquad(const biquad_cascade<T, N>& cascade) {
+        using real_type    = long double;
+        using complex_type = std::complex<real_type>;
+
+        // Numerator and poles of every section.
+        std::vector<std::array<real_type, 3>> numerators;
+        std::vector<complex_type> poles;
+        std::size_t degree = 0;
+        for (const auto& stage : cascade) {
+            const auto a0 = static_cast<real_type>(stage.a0());
+            const auto a1 = static_cast<real_type>(stage.a1()) / a0;
+            const auto a2 = static_cast<real_type>(stage.a2()) / a0;
+            numerators.push_back({static_cast<real_type>(stage.b0()) / a0, static_cast<real_type>(stage.b1()) / a0,
+                                  static_cast<real_type>(stage.b2()) / a0});
+            degree += (stage.b2() != 0) ? 2 : (stage.b1() != 0) ? 1 : 0;
+            if (a2 != 0) {
+                const auto root = std::sqrt(complex_type(a1 * a1 - 4 * a2));
+                poles.push_back((-a1 + root) / static_cast<real_type>(2));
+                poles.push_back((-a1 - root) / static_cast<real_type>(2));
+            } else if (a1 != 0) {
+                poles.push_back(complex_type(-a1));
+            }
+        }
+        meta::expects(degree <= poles.size(), "The numerator degree exceeds the number of poles");
+
+        // r_i = B(1 / p_i) / prod_{j != i} (1 - p_j / p_i)
+        std::vector<complex_type> residues(poles.size());
+        for (std::size_t i = 0; i < poles.size(); ++i) {
+            meta::expects(poles[i] != complex_type(0), "Expecting non-zero poles");
+            const auto w     = static_cast<real_type>(1) / poles[i];
+            auto denominator = complex_type(1);
+            for (std::size_t j = 0; j < poles.size(); ++j) {
+                if (j != i) {
+                    denominator *= static_cast<real_type>(1) - poles[j] * w;
+                }
+            }
+            meta::expects(std::abs(denominator) > 0, "Expecting distinct poles");
+            residues[i] = internal::evaluate_sections(numerators, w) / denominator;
+        }
+
+        // H(z^-1 = 0) = c + sum r_i.
+        auto direct = internal::evaluate_sections(numerators, complex_type(0));
+        for (const auto& residue : residues) {
+            direct -= residue;
+        }
+
+        parallel_biquad<T, N> result;
+        result.set_gain(static_cast<T>(direct.real()));
+
+        // Every complex pole is paired with its conjugate, the real poles are paired between them.
+        std::vector<bool> used(poles.size(), false);
+        const auto tolerance = std::sqrt(std::numeric_limits<real_type>::epsilon());
+        std::vector<std::size_t> reals;
+        for (std::size_t i = 0; i < poles.size(); ++i) {
+            if (used[i]) {
+                continue;
+            }
+            used[i] = true;
+            if (std::abs(poles[i].imag()) <= tolerance * std::abs(poles[i])) {
+                reals.push_back(i);
+                continue;
+            }
+            std::size_t pair = i;
+            auto distance    = std::numeric_limits<real_type>::max();
+            for (std::size_t j = i + 1; j < poles.size(); ++j) {
+                const auto candidate = std::abs(poles[j] - std::conj(poles[i]));
+                if (!used[j] && candidate < distance) {
+                    distance = candidate;
+                    pair     = j;
+                }
+            }
+            meta::expects(pair != i, "Expecting complex conjugate poles");
+            used[pair]     = true;
+            const auto& p  = poles[i];
+            const auto& r  = residues[i];
+            const auto b0  = 2 * r.real();
+            const auto b1  = -2 * (r * std::conj(p)).real();
+            const auto a1  = -2 * p.real();
+            const auto a2  = std::norm(p);
+            result.push_back(biquad<T>(1, static_cast<T>(a1), static_cast<T>(a2), static_cast<T>(b0),
+                                       static_cast<T>(b1), 0));
+        }
+
+        for (std::size_t i = 0; i < reals.size(); i += 2) {
+            const auto p1 = poles[reals[i]].real();
+            const auto r1 = residues[reals[i]].real();
+            if (i + 1 == reals.size()) {
+                result.push_back(biquad<T>(1, static_cast<T>(-p1), 0, static_cast<T>(r1), 0, 0));
+                break;
+            }
+            const auto p2 = poles[reals[i + 1]].real();
+            const auto r2 = residues[reals[i + 1]].real();
+            result.push_back(biquad<T>(1, static_cast<T>(-(p1 + p2)), static_cast<T>(p1 * p2),
+                                       static_cast<T>(r1 + r2), static_cast<T>(-(r1 * p2 + r2 * p1)), 0));
+        }
+        return result;
+    }
+
+}} // namespace edsp::filter
+
+#endif //EDSP_FILTER_PARALLEL_BIQUAD_HPP
@@ -0,0 +1,261 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: smoothed_biquad.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_FILTER_SMOOTHED_BIQUAD_HPP
+#define EDSP_FILTER_SMOOTHED_BIQUAD_HPP
+
+#include <edsp/filter/biquad.hpp>
+#include <edsp/filter/internal/rbj_designer.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <array>
+
+namespace edsp { namespace filter {
+
+    /**
+     * @class smoothed_biquad
+     * @brief This class implements a biquad filter whose parameters can be automated without clicks.
+     *
+     * Updating the coefficients of a biquad resets its state, and designing a new filter for every sample is
+     * expensive. Instead, set_target designs the target filter once, with the Audio-EQ-Cookbook formulas, and the
+     * normalized coefficients are linearly interpolated from the current ones to the target ones over the ramp. The
+     * trigonometric functions are then evaluated once per ramp, and every sample of the ramp only adds the
+     * increments. The state of the filter is never reset.
+     *
+     * The region of stable \f$ (a_1, a_2) \f$ coefficients is a triangle, a convex set, so every filter of the ramp
+     * between two stable filters is stable when its coefficients are frozen. This does not make the filter stable
+     * while the coefficients change: a direct form II transposed structure whose coefficients vary every sample can
+     * amplify its state even if every frozen filter is stable, specially with poles close to the unit circle (high
+     * quality factors or low frequencies) and short ramps. Once a ramp ends the target filter is stable and the
+     * transient decays, but a target updated before every ramp ends keeps the filter time-varying and its output is
+     * not guaranteed to be bounded. Use longer ramps for such filters, or a state_variable_filter, which remains well
+     * behaved under audio rate modulation.
+     *
+     * @tparam T Floating point type.
+     * @tparam Type Type of filter, one of the types supported by RBJFilterDesigner.
+     */
+    template <typename T, filter_type Type>
+    class smoothed_biquad {
+    public:
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        /**
+         * @brief Creates a %smoothed_biquad with the given parameters.
+         * @param sample_rate The sampling frequency in Hz.
+         * @param fc Center Frequency or Corner Frequency in Hz, or shelf midpoint frequency.
+         * @param Q Quality factor, or shelf slope for the shelving filters.
+         * @param gain_db Gain in dB, used only for the shelving filters.
+         */
+        smoothed_biquad(value_type sample_rate, value_type fc, value_type Q, value_type gain_db = 0);
+
+        /**
+         * @brief Starts a ramp from the current coefficients to the ones of the given parameters.
+         *
+         * If a ramp is in progress, the new one starts from the coefficients reached so far.
+         * @param fc Target Center Frequency or Corner Frequency in Hz.
+         * @param Q Target Quality factor.
+         * @param gain_db Target gain in dB.
+         * @param ramp_samples Number of samples of the ramp, zero to update the coefficients immediately.
+         */
+        void set_target(value_type fc, value_type Q, value_type gain_db, size_type ramp_samples);
+
+        /**
+         * @brief Returns the number of samples left to reach the target coefficients.
+         * @return Remaining samples of the ramp.
+         */
+        size_type remaining() const noexcept;
+
+        /**
+         * @brief Returns the sampling frequency in Hz.
+         * @return Sample rate.
+         */
+        value_type sample_rate() const noexcept;
+
+        /**
+         * @brief Returns a biquad with the current coefficients and an empty state.
+         * @return Biquad filter.
+         */
+        biquad<T> current() const;
+
+        /**
+         * @brief Reset the filter to the original state, the ramp in progress is not modified.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Computes the output of filtering one digital time-step.
+         * @param value Input value to be filtered.
+         * @return Filtered value.
+         */
+        value_type tick(value_type value) noexcept;
+
+        /**
+         * @brief Filters the signal in the range [first, last) and stores the result in another range, beginning at
+         * d_first.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         */
+        template <typename InputIt, typename OutputIt>
+        void filter(InputIt first, InputIt last, OutputIt d_first);
+
+        /**
+         * @brief Filters in-place a block of samples.
+         * @param data Pointer to the first sample of the block.
+         * @param size Number of samples of the block.
+         */
+        void process(value_type* data, size_type size) noexcept;
+
+    private:
+        // Normalized coefficients, in the order b0, b1, b2, a1, a2.
+        using coefficients_type = std::array<value_type, 5>;
+
+        static coefficients_type design(value_type sample_rate, value_type fc, value_type Q, value_type gain_db);
+
+        coefficients_type current_{};
+        coefficients_type target_{};
+        coefficients_type delta_{};
+        value_type sample_rate_;
+        value_type w0_{0};
+        value_type w1_{0};
+        size_type remaining_{0};
+    };
+
+    template <typename T, filter_type Type>
+    smoothed_biquad<T, Type>::smoothed_biquad(value_type sample_rate, value_type fc, value_type Q,
+                                              value_type gain_db) :
+        current_(design(sample_rate, fc, Q, gain_db)),
+        target_(current_),
+        sample_rate_(sample_rate) {}
+
+    template <typename T, filter_type Type>
+    typename smoothed_biquad<T, Type>::coefficients_type
+        smoothed_biquad<T, Type>::design(value_type sample_rate, value_type fc, value_type Q, value_type gain_db) {
+        meta::expects(sample_rate > 0, "The sample rate should be greater than zero");
+        meta::expects(fc > 0 && fc < sample_rate / 2, "The frequency should be in the range (0, sample_rate / 2)");
+        meta::expects(Q > 0, "The quality factor should be greater than zero");
+        const auto filter = RBJFilterDesigner<T, Type>{}(fc, sample_rate, Q, gain_db);
+        const auto a0     = filter.a0();
+        return {filter.b0() / a0, filter.b1() / a0, filter.b2() / a0, filter.a1() / a0, filter.a2() / a0};
+    }
+
+    template <typename T, filter_type Type>
+    void smoothed_biquad<T, Type>::set_target(value_type fc, value_type Q, value_type gain_db,
+                                              size_type ramp_samples) {
+        target_    = design(sample_rate_, fc, Q, gain_db);
+        remaining_ = ramp_samples;
+        if (ramp_samples == 0) {
+            current_ = target_;
+            return;
+        }
+        const auto scaling = 1 / static_cast<value_type>(ramp_samples);
+        for (size_type i = 0; i < current_.size(); ++i) {
+            delta_[i] = (target_[i] - current_[i]) * scaling;
+        }
+    }
+
+    template <typename T, filter_type Type>
+    typename smoothed_biquad<T, Type>::size_type smoothed_biquad<T, Type>::remaining() const noexcept {
+        return remaining_;
+    }
+
+    template <typename T, filter_type Type>
+    typename smoothed_biquad<T, Type>::value_type smoothed_biquad<T, Type>::sample_rate() const noexcept {
+        return sample_rate_;
+    }
+
+    template <typename T, filter_type Type>
+    biquad<T> smoothed_biquad<T, Type>::current() const {
+        return biquad<T>(1, current_[3], current_[4], current_[0], current_[1], current_[2]);
+    }
+
+    template <typename T, filter_type Type>
+    void smoothed_biquad<T, Type>::reset() noexcept {
+        w0_ = 0;
+        w1_ = 0;
+    }
+
+    template <typename T, filter_type Type>
+    typename smoothed_biquad<T, Type>::value_type smoothed_biquad<T, Type>::tick(value_type value) noexcept {
+        process(&value, 1);
+        return value;
+    }
+
+    template <typename T, filter_type Type>
+    template <typename InputIt, typename OutputIt>
+    void smoothed_biquad<T, Type>::filter(InputIt first, InputIt last, OutputIt d_first) {
+        constexpr size_type tile_size = 256;
+        std::array<value_type, tile_size> tile{};
+        while (first != last) {
+            size_type count = 0;
+            for (; count < tile_size && first != last; ++count, ++first) {
+                tile[count] = *first;
+            }
+            process(tile.data(), count);
+            d_first = std::copy_n(std::cbegin(tile), count, d_first);
+        }
+    }
+
+    template <typename T, filter_type Type>
+    void smoothed_biquad<T, Type>::process(value_type* data, size_type size) noexcept {
+        auto b0 = current_[0], b1 = current_[1], b2 = current_[2], a1 = current_[3], a2 = current_[4];
+        auto w0 = w0_, w1 = w1_;
+
+        // During the ramp, the increments are added before every sample.
+        const auto ramp = std::min(remaining_, size);
+        if (ramp > 0) {
+            const auto db0 = delta_[0], db1 = delta_[1], db2 = delta_[2], da1 = delta_[3], da2 = delta_[4];
+            for (size_type n = 0; n < ramp; ++n) {
+                b0 += db0;
+                b1 += db1;
+                b2 += db2;
+                a1 += da1;
+                a2 += da2;
+                const auto value = data[n];
+                const auto out   = b0 * value + w0;
+                w0               = b1 * value - a1 * out + w1;
+                w1               = b2 * value - a2 * out;
+                data[n]          = out;
+            }
+            remaining_ -= ramp;
+            if (remaining_ == 0) {
+                // Snaps to the exact target, removing the rounding errors accumulated by the increments.
+                b0 = target_[0], b1 = target_[1], b2 = target_[2], a1 = target_[3], a2 = target_[4];
+            }
+            current_ = {b0, b1, b2, a1, a2};
+        }
+
+        for (size_type n = ramp; n < size; ++n) {
+            const auto value = data[n];
+            const auto out   = b0 * value + w0;
+            w0               = b1 * value - a1 * out + w1;
+            w1               = b2 * value - a2 * out;
+            data[n]          = out;
+        }
+        w0_ = w0;
+        w1_ = w1;
+    }
+
+}} // namespace edsp::filter
+
+#endif //EDSP_FILTER_SMOOTHED_BIQUAD_HPP
@@ -0,0 +1,359 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: state_variable_filter.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_FILTER_STATE_VARIABLE_FILTER_HPP
+#define EDSP_FILTER_STATE_VARIABLE_FILTER_HPP
+
+#include <edsp/math/constant.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace edsp { namespace filter {
+
+    /**
+     * @brief The responses computed by a state variable filter.
+     */
+    enum class svf_mode {
+        LowPass,  /*!< Low pass response */
+        HighPass, /*!< High pass response */
+        BandPass, /*!< Band pass response */
+        Notch,    /*!< Notch (band stop) response */
+        Peak,     /*!< Peak response, the difference between the low pass and the high pass responses */
+    };
+
+    /**
+     * @brief Outputs of a state variable filter for one time-step.
+     */
+    template <typename T>
+    struct svf_response {
+        T low;
+        T band;
+        T high;
+        T notch;
+        T peak;
+    };
+
+    inline namespace internal {
+
+        /**
+         * @brief Computes \f$ \tan(x) \f$ for \f$ x \in [0, \pi / 2) \f$ without calling the standard library.
+         *
+         * The argument is reduced to \f$ [0, \pi / 4] \f$ with \f$ \tan(x) = 1 / \tan(\pi / 2 - x) \f$, where a
+         * [5/4] Padé approximant has a relative error below 1.4e-8. There are no branches, so the loops calling it
+         * can be vectorized.
+         * @param x Angle in radians.
+         * @return Approximation of the tangent of x.
+         */
+        template <typename T>
+        constexpr T fast_tan(T x) noexcept {
+            const auto reflect = x > constants<T>::half_pi / 2;
+            const auto y       = reflect ? constants<T>::half_pi - x : x;
+            const auto y2      = y * y;
+            const auto p       = y * (945 - 105 * y2 + y2 * y2);
+            const auto q       = 945 - 420 * y2 + 15 * y2 * y2;
+            return reflect ? q / p : p / q;
+        }
+
+        template <typename T, svf_mode Mode>
+        struct svf_tap {};
+
+        template <typename T>
+        struct svf_tap<T, svf_mode::LowPass> {
+            static constexpr T compute(T, T, T v2, T) noexcept {
+                return v2;
+            }
+        };
+
+        template <typename T>
+        struct svf_tap<T, svf_mode::HighPass> {
+            static constexpr T compute(T v0, T v1, T v2, T k) noexcept {
+                return v0 - k * v1 - v2;
+            }
+        };
+
+        template <typename T>
+        struct svf_tap<T, svf_mode::BandPass> {
+            static constexpr T compute(T, T v1, T, T) noexcept {
+                return v1;
+            }
+        };
+
+        template <typename T>
+        struct svf_tap<T, svf_mode::Notch> {
+            static constexpr T compute(T v0, T v1, T, T k) noexcept {
+                return v0 - k * v1;
+            }
+        };
+
+        template <typename T>
+        struct svf_tap<T, svf_mode::Peak> {
+            static constexpr T compute(T v0, T v1, T v2, T k) noexcept {
+                return 2 * v2 - v0 + k * v1;
+            }
+        };
+
+    } // namespace internal
+
+    /**
+     * @class state_variable_filter
+     * @brief This class implements a second order state variable filter with the topology-preserving transform
+     * (TPT) described by Zavalishin in "The Art of VA Filter Design".
+     *
+     * The integrators are discretized with the trapezoidal rule and the zero-delay feedback loop is solved
+     * analytically, so the filter keeps the response of its analog prototype and, unlike a direct form biquad, it
+     * remains well behaved when the cutoff frequency changes every sample. A single pass computes the low pass,
+     * high pass, band pass, notch and peak responses.
+     *
+     * The cutoff frequency may be given as a buffer, one value per sample. The prewarping uses fast_tan, and the
+     * coefficients of a tile of samples are computed in a separate loop, free of recursion, that the compiler
+     * vectorizes. Only the two integrators remain in the serial loop, updated in state-space form so that every
+     * time-step depends on the previous one through a short chain of multiply-adds; the outputs are derived from the
+     * mean of the old and the new states, outside of the recursion.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class state_variable_filter {
+    public:
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        /**
+         * @brief Creates a %state_variable_filter with the given parameters.
+         * @param sample_rate The sampling frequency in Hz.
+         * @param fc Cutoff or center frequency in Hz.
+         * @param Q Quality factor.
+         */
+        state_variable_filter(value_type sample_rate, value_type fc, value_type Q);
+
+        /**
+         * @brief Returns the sampling frequency in Hz.
+         * @return Sample rate.
+         */
+        value_type sample_rate() const noexcept;
+
+        /**
+         * @brief Returns the cutoff frequency in Hz.
+         * @return Cutoff or center frequency.
+         */
+        value_type cutoff() const noexcept;
+
+        /**
+         * @brief Returns the quality factor.
+         * @return Quality factor.
+         */
+        value_type resonance() const noexcept;
+
+        /**
+         * @brief Updates the cutoff frequency, the state of the filter is not modified.
+         * @param fc Cutoff or center frequency in Hz.
+         */
+        void set_cutoff(value_type fc);
+
+        /**
+         * @brief Updates the quality factor, the state of the filter is not modified.
+         * @param Q Quality factor.
+         */
+        void set_resonance(value_type Q);
+
+        /**
+         * @brief Reset the filter to the original state.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Computes all the responses of filtering one digital time-step.
+         * @param value Input value to be filtered.
+         * @return Filtered values.
+         */
+        svf_response<T> tick(value_type value) noexcept;
+
+        /**
+         * @brief Filters in-place a block of samples with the current cutoff frequency.
+         * @tparam Mode Response of the filter.
+         * @param data Pointer to the first sample of the block.
+         * @param size Number of samples of the block.
+         */
+        template <svf_mode Mode>
+        void process(value_type* data, size_type size) noexcept;
+
+        /**
+         * @brief Filters in-place a block of samples, modulating the cutoff frequency every sample.
+         *
+         * The frequencies are clamped to the range [0, 0.49 * sample_rate]. The cutoff frequency of the filter is
+         * updated with the last value of the buffer.
+         * @tparam Mode Response of the filter.
+         * @param data Pointer to the first sample of the block.
+         * @param cutoff Pointer to the size() cutoff frequencies in Hz, one per sample.
+         * @param size Number of samples of the block.
+         */
+        template <svf_mode Mode>
+        void process(value_type* data, const value_type* cutoff, size_type size) noexcept;
+
+    private:
+        static constexpr size_type tile_size = 64;
+
+        value_type sample_rate_;
+        value_type fc_{0};
+        value_type k_{1};
+        value_type g_{0};
+        value_type ic1eq_{0};
+        value_type ic2eq_{0};
+    };
+
+    template <typename T>
+    state_variable_filter<T>::state_variable_filter(value_type sample_rate, value_type fc, value_type Q) :
+        sample_rate_(sample_rate) {
+        meta::expects(sample_rate > 0, "The sample rate should be greater than zero");
+        set_cutoff(fc);
+        set_resonance(Q);
+    }
+
+    template <typename T>
+    typename state_variable_filter<T>::value_type state_variable_filter<T>::sample_rate() const noexcept {
+        return sample_rate_;
+    }
+
+    template <typename T>
+    typename state_variable_filter<T>::value_type state_variable_filter<T>::cutoff() const noexcept {
+        return fc_;
+    }
+
+    template <typename T>
+    typename state_variable_filter<T>::value_type state_variable_filter<T>::resonance() const noexcept {
+        return 1 / k_;
+    }
+
+    template <typename T>
+    void state_variable_filter<T>::set_cutoff(value_type fc) {
+        meta::expects(fc > 0 && fc < sample_rate_ / 2, "The frequency should be in the range (0, sample_rate / 2)");
+        fc_ = fc;
+        g_  = std::tan(constants<T>::pi * fc / sample_rate_);
+    }
+
+    template <typename T>
+    void state_variable_filter<T>::set_resonance(value_type Q) {
+        meta::expects(Q > 0, "The quality factor should be greater than zero");
+        k_ = 1 / Q;
+    }
+
+    template <typename T>
+    void state_variable_filter<T>::reset() noexcept {
+        ic1eq_ = 0;
+        ic2eq_ = 0;
+    }
+
+    template <typename T>
+    svf_response<T> state_variable_filter<T>::tick(value_type value) noexcept {
+        const auto a1 = 1 / (1 + g_ * (g_ + k_));
+        const auto a2 = g_ * a1;
+        const auto a3 = g_ * a2;
+        const auto v3 = value - ic2eq_;
+        const auto v1 = a1 * ic1eq_ + a2 * v3;
+        const auto v2 = ic2eq_ + a2 * ic1eq_ + a3 * v3;
+        ic1eq_        = 2 * v1 - ic1eq_;
+        ic2eq_        = 2 * v2 - ic2eq_;
+        const auto hp = value - k_ * v1 - v2;
+        return {v2, v1, hp, v2 + hp, v2 - hp};
+    }
+
+    template <typename T>
+    template <svf_mode Mode>
+    void state_variable_filter<T>::process(value_type* data, size_type size) noexcept {
+        const auto k   = k_;
+        const auto a   = 1 / (1 + g_ * (g_ + k));
+        const auto m11 = 2 * a - 1;
+        const auto m12 = 2 * g_ * a;
+        const auto m22 = 1 - 2 * g_ * g_ * a;
+        const auto m23 = 2 * g_ * g_ * a;
+        auto ic1eq = ic1eq_, ic2eq = ic2eq_;
+        for (size_type n = 0; n < size; ++n) {
+            const auto v0 = data[n];
+            const auto s1 = (m12 * v0 + m11 * ic1eq) - m12 * ic2eq;
+            const auto s2 = (m23 * v0 + m12 * ic1eq) + m22 * ic2eq;
+            const auto v1 = (ic1eq + s1) / 2;
+            const auto v2 = (ic2eq + s2) / 2;
+            ic1eq         = s1;
+            ic2eq         = s2;
+            data[n]       = svf_tap<T, Mode>::compute(v0, v1, v2, k);
+        }
+        ic1eq_ = ic1eq;
+        ic2eq_ = ic2eq;
+    }
+
+    template <typename T>
+    template <svf_mode Mode>
+    void state_variable_filter<T>::process(value_type* data, const value_type* cutoff, size_type size) noexcept {
+        if (size == 0) {
+            return;
+        }
+
+        const auto k       = k_;
+        const auto scaling = constants<T>::pi / sample_rate_;
+        const auto maximum = static_cast<value_type>(0.49) * constants<T>::pi;
+        auto ic1eq = ic1eq_, ic2eq = ic2eq_;
+
+        std::array<value_type, tile_size> w, m11, m12, m22, m23;
+        for (size_type offset = 0; offset < size; offset += tile_size) {
+            const auto count = (size - offset < tile_size) ? size - offset : tile_size;
+            auto* block      = data + offset;
+
+            // The tail of the last tile is padded, so the coefficients are always computed for a whole tile. With a
+            // constant trip count and no recursion, the compiler vectorizes this loop even at -O2.
+            std::copy_n(cutoff + offset, count, w.begin());
+            std::fill(w.begin() + count, w.end(), w[count - 1]);
+            for (size_type n = 0; n < tile_size; ++n) {
+                auto x     = w[n] * scaling;
+                x          = x < 0 ? value_type{0} : x;
+                x          = x > maximum ? maximum : x;
+                const auto g = fast_tan(x);
+                const auto a = 1 / (1 + g * (g + k));
+                m11[n]       = 2 * a - 1;
+                m12[n]       = 2 * g * a;
+                m22[n]       = 1 - 2 * g * g * a;
+                m23[n]       = 2 * g * g * a;
+            }
+
+            for (size_type n = 0; n < count; ++n) {
+                const auto v0 = block[n];
+                const auto s1 = (m12[n] * v0 + m11[n] * ic1eq) - m12[n] * ic2eq;
+                const auto s2 = (m23[n] * v0 + m12[n] * ic1eq) + m22[n] * ic2eq;
+                const auto v1 = (ic1eq + s1) / 2;
+                const auto v2 = (ic2eq + s2) / 2;
+                ic1eq         = s1;
+                ic2eq         = s2;
+                block[n]      = svf_tap<T, Mode>::compute(v0, v1, v2, k);
+            }
+        }
+        ic1eq_ = ic1eq;
+        ic2eq_ = ic2eq;
+
+        const auto last = std::min(std::max(cutoff[size - 1] * scaling, value_type{0}), maximum);
+        fc_             = last / scaling;
+        g_              = fast_tan(last);
+    }
+
+}} // namespace edsp::filter
+
+#endif //EDSP_FILTER_STATE_VARIABLE_FILTER_HPP
@@ -23,6 +23,7 @@
 #define EDSP_CEPSTRUM_HPP
 
 #include <edsp/spectral/fft_engine.hpp>
+#include <edsp/spectral/spectral_workspace.hpp>
 #include <vector>
 
 namespace edsp { inline namespace spectral {
@@ -36,36 +37,60 @@ namespace edsp { inline namespace spectral {
      * {\displaystyle C_K =\left|{\mathcal {F}}^{-1}\left\{\log \left(\left|{\mathcal {F}}\{f(t)\}\right|^{2}\right)\right\}\right|^{2}}
      * \f]
      *
+     * This overload does not allocate any memory: all the temporary buffers are taken from the workspace.
+     *
      * @param first Input iterator defining the beginning of the input range.
      * @param last Input iterator defining the ending of the input range.
      * @param d_first Output iterator defining the beginning of the destination range.
+     * @param workspace Workspace created for inputs of std::distance(first, last) samples.
      */
-    template <typename InputIt, typename OutputIt, typename RAllocator = std::allocator<meta::value_type_t<InputIt>>,
-              typename CAllocator = std::allocator<std::complex<meta::value_type_t<OutputIt>>>>
-    inline void cepstrum(InputIt first, InputIt last, OutputIt d_first) {
-        meta::expects(std::distance(first, last) > 0, "Not expecting empty input");
-        using value_type = meta::value_type_t<InputIt>;
-        const auto size  = std::distance(first, last);
-        const auto nfft  = 2 * size;
-        fft_engine<value_type> fft_(nfft);
-        fft_engine<value_type> ifft_(nfft);
-
-        std::vector<value_type, RAllocator> temp_input(nfft, static_cast<value_type>(0)), temp_output(nfft);
-        std::copy(first, last, std::begin(temp_input));
+    template <typename InputIt, typename OutputIt, typename T, typename RAllocator, typename CAllocator>
+    inline void cepstrum(InputIt first, InputIt last, OutputIt d_first,
+                         spectral_workspace<T, RAllocator, CAllocator>& workspace) {
+        const auto size = std::distance(first, last);
+        meta::expects(size > 0, "Not expecting empty input");
+        meta::expects(static_cast<std::size_t>(size) == workspace.size(),
+                      "The workspace size does not match the input");
+        auto& engine      = workspace.padded_engine();
+        auto& temp_input  = workspace.real1();
+        auto& temp_output = workspace.real2();
+        auto& fft_data_   = workspace.complex1();
 
-        std::vector<std::complex<value_type>, CAllocator> fft_data_(make_fft_size(nfft));
-        fft_.dft(meta::data(temp_input), meta::data(fft_data_));
+        std::fill(std::copy(first, last, std::begin(temp_input)), std::end(temp_input), static_cast<T>(0));
+        engine.dft(meta::data(temp_input), meta::data(fft_data_));
 
         std::transform(std::cbegin(fft_data_), std::cend(fft_data_), std::begin(fft_data_),
-                       [](const std::complex<value_type>& val) -> std::complex<value_type> {
-                           return std::complex<value_type>(std::log(std::abs(val)), 0);
+                       [](const std::complex<T>& val) -> std::complex<T> {
+                           return std::complex<T>(std::log(std::abs(val)), 0);
                        });
 
-        ifft_.idft(meta::data(fft_data_), meta::data(temp_output));
-        ifft_.idft_scale(meta::data(temp_output));
+        engine.idft(meta::data(fft_data_), meta::data(temp_output));
+        engine.idft_scale(meta::data(temp_output));
         std::copy(std::cbegin(temp_output), std::cbegin(temp_output) + size, d_first);
     }
 
+    /**
+     * @brief Computes the cepstrum of the range [first, last) and stores the result in another range, beginning at d_first.
+     *
+     * The Cepstrum is the result of taking the inverse Fourier transform (IDFT) of the logarithm of the estimated spectrum of a signal:
+     *
+     * \f[
+     * {\displaystyle C_K =\left|{\mathcal {F}}^{-1}\left\{\log \left(\left|{\mathcal {F}}\{f(t)\}\right|^{2}\right)\right\}\right|^{2}}
+     * \f]
+     *
+     * @param first Input iterator defining the beginning of the input range.
+     * @param last Input iterator defining the ending of the input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     */
+    template <typename InputIt, typename OutputIt, typename RAllocator = std::allocator<meta::value_type_t<InputIt>>,
+              typename CAllocator = std::allocator<std::complex<meta::value_type_t<OutputIt>>>>
+    inline void cepstrum(InputIt first, InputIt last, OutputIt d_first) {
+        meta::expects(std::distance(first, last) > 0, "Not expecting empty input");
+        using value_type = meta::value_type_t<InputIt>;
+        spectral_workspace<value_type, RAllocator, CAllocator> workspace(std::distance(first, last));
+        cepstrum(first, last, d_first, workspace);
+    }
+
 }} // namespace edsp::spectral
 
 #endif // EDSP_CEPSTRUM_HPP
@@ -0,0 +1,270 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: cepstrum_engine.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_CEPSTRUM_ENGINE_HPP
+#define EDSP_CEPSTRUM_ENGINE_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @brief The CepstrumMode enum defines the type of cepstrum computed by a cepstrum_engine.
+     */
+    enum class CepstrumMode {
+        Real,   /*!< Real cepstrum, the inverse transform of the logarithm of the magnitude spectrum */
+        Complex /*!< Complex cepstrum, the inverse transform of the complex logarithm with unwrapped phase */
+    };
+
+    /**
+     * @class cepstrum_engine
+     * @brief This class computes the real or complex cepstrum of frames of a fixed size.
+     *
+     * The real cepstrum discards the phase of the spectrum:
+     *
+     * \f[
+     *  c_n = \mathcal{F}^{-1} \left\{ \log \left| \mathcal{F}\{x\} \right| \right\}
+     * \f]
+     *
+     * The complex cepstrum keeps it, using the unwrapped phase of the spectrum. As in MATLAB's cceps, the sign of the
+     * signal is factored out first, so a frame with a negative DC component is processed as its opposite and
+     * sign() returns -1. The linear phase term is removed before the inverse transform, as a circular delay of
+     * delay() samples, so the result does not depend on the position of the signal in the frame. The phases of the
+     * DC and Nyquist bins of a real signal are then multiples of pi and are forced to zero.
+     *
+     * Both spectra are Hermitian, so the engine only computes the positive frequencies, with a Real-to-Complex
+     * forward transform and a Complex-to-Real backward transform. The plans and buffers are created once, during the
+     * construction, and reused by every frame.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class cepstrum_engine {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %cepstrum_engine with the given configuration.
+         * @param size Number of samples of every frame.
+         * @param nfft Size of the FFT, it should be greater or equal than the frame size. The frames are zero-padded.
+         * @param mode Type of cepstrum.
+         */
+        cepstrum_engine(size_type size, size_type nfft, CepstrumMode mode = CepstrumMode::Real);
+
+        /**
+         * @brief Returns the number of samples of every frame.
+         * @return Frame size.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Returns the size of the FFT, the number of cepstral coefficients of every frame.
+         * @return Size of the FFT.
+         */
+        size_type nfft() const noexcept;
+
+        /**
+         * @brief Returns the type of cepstrum computed by the engine.
+         * @return Mode of the engine.
+         */
+        CepstrumMode mode() const noexcept;
+
+        /**
+         * @brief Returns the circular delay removed from the last frame, in complex mode.
+         * @return Delay in samples.
+         */
+        std::ptrdiff_t delay() const noexcept;
+
+        /**
+         * @brief Returns the sign factored out of the last frame, in complex mode.
+         * @return -1 if the DC component of the frame was negative, 1 otherwise.
+         */
+        int sign() const noexcept;
+
+        /**
+         * @brief Computes the cepstrum of a frame of size() samples, beginning at first, and stores the nfft()
+         * coefficients in another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the frame.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt compute(InputIt first, OutputIt d_first);
+
+        /**
+         * @brief Computes the cepstrum of a batch of frames stored one after the other, beginning at first, and stores
+         * the coefficients of every frame one after the other in another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the frames, every one of size() samples.
+         * @param frames Number of frames.
+         * @param d_first Output iterator defining the beginning of the destination range, every frame of nfft()
+         * values.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt compute(InputIt first, size_type frames, OutputIt d_first);
+
+    private:
+        void real_logarithm();
+        void complex_logarithm();
+
+        fft_engine<T> engine_;
+        std::vector<value_type> buffer_;
+        std::vector<complex_type> spectrum_;
+        size_type size_;
+        CepstrumMode mode_;
+        std::ptrdiff_t delay_{0};
+        int sign_{1};
+    };
+
+    template <typename T>
+    cepstrum_engine<T>::cepstrum_engine(size_type size, size_type nfft, CepstrumMode mode) :
+        engine_(nfft, {fft_kind::RealForward, fft_kind::RealBackward}),
+        buffer_(nfft, 0),
+        spectrum_(make_fft_size(nfft)),
+        size_(size),
+        mode_(mode) {
+        meta::expects(size > 0 && size <= nfft, "The frame size should be in the range [1, nfft]");
+    }
+
+    template <typename T>
+    typename cepstrum_engine<T>::size_type cepstrum_engine<T>::size() const noexcept {
+        return size_;
+    }
+
+    template <typename T>
+    typename cepstrum_engine<T>::size_type cepstrum_engine<T>::nfft() const noexcept {
+        return buffer_.size();
+    }
+
+    template <typename T>
+    CepstrumMode cepstrum_engine<T>::mode() const noexcept {
+        return mode_;
+    }
+
+    template <typename T>
+    std::ptrdiff_t cepstrum_engine<T>::delay() const noexcept {
+        return delay_;
+    }
+
+    template <typename T>
+    int cepstrum_engine<T>::sign() const noexcept {
+        return sign_;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt cepstrum_engine<T>::compute(InputIt first, OutputIt d_first) {
+        std::fill(std::copy_n(first, size_, std::begin(buffer_)), std::end(buffer_), static_cast<value_type>(0));
+        engine_.dft(buffer_.data(), spectrum_.data());
+        if (mode_ == CepstrumMode::Real) {
+            real_logarithm();
+        } else {
+            complex_logarithm();
+        }
+        engine_.idft(spectrum_.data(), buffer_.data());
+
+        const auto scaling = 1 / static_cast<value_type>(buffer_.size());
+        for (const auto value : buffer_) {
+            *d_first = value * scaling;
+            ++d_first;
+        }
+        return d_first;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt cepstrum_engine<T>::compute(InputIt first, size_type frames, OutputIt d_first) {
+        for (size_type i = 0; i < frames; ++i) {
+            d_first = compute(first, d_first);
+            std::advance(first, size_);
+        }
+        return d_first;
+    }
+
+    template <typename T>
+    void cepstrum_engine<T>::real_logarithm() {
+        const auto floor = std::numeric_limits<value_type>::min();
+        for (auto& bin : spectrum_) {
+            const auto power = bin.real() * bin.real() + bin.imag() * bin.imag();
+            bin              = complex_type(std::log(std::max(power, floor)) / 2, 0);
+        }
+    }
+
+    template <typename T>
+    void cepstrum_engine<T>::complex_logarithm() {
+        constexpr auto pi     = static_cast<value_type>(3.141592653589793238462643383279502884L);
+        constexpr auto two_pi = 2 * pi;
+        const auto floor      = std::numeric_limits<value_type>::min();
+
+        // A negative DC component has a phase of pi, which would otherwise leak into the whole unwrapped phase. The
+        // sign is factored out by negating the spectrum, the transform of the opposite signal.
+        sign_ = (spectrum_[0].real() < 0) ? -1 : 1;
+        if (sign_ < 0) {
+            for (auto& bin : spectrum_) {
+                bin = -bin;
+            }
+        }
+
+        // The phase is unwrapped in place, correcting every jump by a multiple of 2 pi.
+        value_type previous = 0, unwrapped = 0;
+        for (size_type k = 0; k < spectrum_.size(); ++k) {
+            const auto& bin  = spectrum_[k];
+            const auto phase = std::arg(bin);
+            if (k > 0) {
+                const auto jump = phase - previous;
+                unwrapped += jump - two_pi * std::round(jump / two_pi);
+            } else {
+                unwrapped = phase;
+            }
+            previous         = phase;
+            const auto power = bin.real() * bin.real() + bin.imag() * bin.imag();
+            spectrum_[k]     = complex_type(std::log(std::max(power, floor)) / 2, unwrapped);
+        }
+
+        // A circular delay d adds the linear phase -2 pi k d / N, estimated from the phase of the last bin.
+        const auto last = spectrum_.size() - 1;
+        const auto step = two_pi / static_cast<value_type>(buffer_.size());
+        const auto unit = step * static_cast<value_type>(last);
+        delay_          = (last == 0) ? 0 : static_cast<std::ptrdiff_t>(std::round(-spectrum_[last].imag() / unit));
+        for (size_type k = 0; k < spectrum_.size(); ++k) {
+            const auto linear = step * static_cast<value_type>(k) * static_cast<value_type>(delay_);
+            spectrum_[k].imag(spectrum_[k].imag() + linear);
+        }
+
+        // The DC and Nyquist bins of a real signal are real, only the rounding of the phase remains there.
+        spectrum_[0].imag(0);
+        if (buffer_.size() % 2 == 0) {
+            spectrum_[last].imag(0);
+        }
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_CEPSTRUM_ENGINE_HPP
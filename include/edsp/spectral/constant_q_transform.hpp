@@ -0,0 +1,455 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: constant_q_transform.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_CONSTANT_Q_TRANSFORM_HPP
+#define EDSP_CONSTANT_Q_TRANSFORM_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/windowing.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @class constant_q_transform
+     * @brief This class implements a Constant-Q Transform (CQT) and, more generally, a variable-Q filterbank.
+     *
+     * Every bin k correlates the frame with a windowed complex exponential of frequency \f$ f_k \f$, whose length is
+     * inversely proportional to its bandwidth \f$ B_k = f_k / Q + \gamma \f$:
+     *
+     * \f[
+     *  N_k = \left\lceil \frac{f_s}{B_k} \right\rceil, \quad
+     *  X_k = \sum_{n} x_n \frac{w_{N_k}(n)}{\sum w_{N_k}} e^{-j 2 \pi f_k n / f_s}
+     * \f]
+     *
+     * With \f$ \gamma = 0 \f$ the bins have a constant Q, a positive \f$ \gamma \f$ widens the low frequency bins and
+     * shortens their kernels. The kernels are normalized so a sinusoid of amplitude A centred in a bin produces a
+     * magnitude of A / 2.
+     *
+     * Following Brown and Puckette, the kernels are centred in a frame of nfft samples and transformed once during
+     * the construction. Their spectra are concentrated around \f$ f_k \f$, so the values below a relative threshold
+     * are discarded and the rest are stored as a sparse matrix. Every frame is then evaluated as a single real FFT
+     * followed by a sparse matrix-vector product.
+     *
+     * The frequencies can be given in Hz from any grid, for instance the ones of the auditory module.
+     *
+     * @tparam T Floating point type.
+     * @see make_constant_q_transform
+     */
+    template <typename T>
+    class constant_q_transform {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %constant_q_transform evaluating the frequencies in the range [first, last).
+         * @param first Input iterator defining the beginning of the range of centre frequencies in Hz.
+         * @param last Input iterator defining the ending of the range of centre frequencies in Hz.
+         * @param sample_rate Sampling frequency in Hz.
+         * @param q Quality factor of the bins.
+         * @param hop_size Number of samples between the beginning of two consecutive frames.
+         * @param window Type of window of the kernels.
+         * @param gamma Bandwidth offset in Hz, zero for a constant Q.
+         * @param threshold Relative magnitude below which the spectral kernel values are discarded.
+         */
+        template <typename InputIt>
+        constant_q_transform(InputIt first, InputIt last, value_type sample_rate, value_type q, size_type hop_size,
+                             windowing::WindowType window = windowing::WindowType::Hanning, value_type gamma = 0,
+                             value_type threshold = static_cast<value_type>(0.0005));
+
+        /**
+         * @brief Returns the number of bins of every frame.
+         * @return Number of centre frequencies.
+         */
+        size_type bins() const noexcept;
+
+        /**
+         * @brief Returns the number of samples of every frame, the size of the FFT.
+         * @return Frame size.
+         */
+        size_type nfft() const noexcept;
+
+        /**
+         * @brief Returns the number of samples between two consecutive frames.
+         * @return Hop size.
+         */
+        size_type hop_size() const noexcept;
+
+        /**
+         * @brief Returns the centre frequency of the i-th bin.
+         * @param i Position of the bin.
+         * @return Frequency in Hz.
+         */
+        value_type frequency(size_type i) const;
+
+        /**
+         * @brief Returns the length of the kernel of the i-th bin.
+         * @param i Position of the bin.
+         * @return Number of samples.
+         */
+        size_type length(size_type i) const;
+
+        /**
+         * @brief Returns the number of non-zero values of the sparse spectral kernels.
+         * @return Number of stored values.
+         */
+        size_type nonzeros() const noexcept;
+
+        /**
+         * @brief Returns the number of frames emitted if the given number of samples is pushed.
+         *
+         * Use this function to size the output storage of %push.
+         * @param samples Number of samples to be pushed.
+         * @return Number of frames.
+         */
+        size_type frames(size_type samples) const noexcept;
+
+        /**
+         * @brief Discards the buffered samples.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Pushes the samples in the range [first, last) and stores the transform of every completed frame in
+         * another range, beginning at d_first.
+         *
+         * The frames are stored one after the other, every frame containing bins() complex numbers.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Number of emitted frames.
+         * @see frames
+         */
+        template <typename InputIt, typename OutputIt>
+        size_type push(InputIt first, InputIt last, OutputIt d_first);
+
+        /**
+         * @brief Computes the transform of all the frames of the range [first, last) and stores them in another
+         * range, beginning at d_first.
+         *
+         * The frames begin every hop_size() samples, the trailing samples that do not complete a frame are ignored.
+         * The frames are distributed between the given number of threads, every thread using its own buffers, so
+         * this function does not modify the state of the object and can be used concurrently.
+         * @param first Random access iterator defining the beginning of the input range.
+         * @param last Random access iterator defining the ending of the input range.
+         * @param d_first Random access iterator defining the beginning of the destination range.
+         * @param threads Number of threads.
+         * @return Number of computed frames.
+         */
+        template <typename RandomIt, typename OutputIt>
+        size_type compute(RandomIt first, RandomIt last, OutputIt d_first, size_type threads = 1) const;
+
+    private:
+        template <typename OutputIt>
+        OutputIt evaluate(const complex_type* spectrum, OutputIt d_first) const;
+
+        std::unique_ptr<fft_engine<T>> engine_;
+        std::vector<value_type> frequencies_;
+        std::vector<size_type> lengths_;
+        std::vector<size_type> offsets_;
+        std::vector<size_type> columns_;
+        std::vector<value_type> kernel_real_;
+        std::vector<value_type> kernel_imag_;
+        std::vector<value_type> frame_;
+        std::vector<complex_type> spectrum_;
+        size_type hop_size_;
+        size_type filled_{0};
+        size_type skip_{0};
+    };
+
+    namespace internal {
+
+        template <typename T, typename InputIt>
+        inline std::size_t cqt_nfft(InputIt first, InputIt last, T sample_rate, T q, T gamma) {
+            meta::expects(std::distance(first, last) > 0, "Expecting at least one frequency");
+            const auto lowest = *std::min_element(first, last);
+            meta::expects(lowest > 0, "The frequencies should be greater than zero");
+            const auto longest = static_cast<std::size_t>(std::ceil(sample_rate / (lowest / q + gamma)));
+            std::size_t nfft   = 1;
+            while (nfft < longest) {
+                nfft *= 2;
+            }
+            return nfft;
+        }
+
+    } // namespace internal
+
+    template <typename T>
+    template <typename InputIt>
+    constant_q_transform<T>::constant_q_transform(InputIt first, InputIt last, value_type sample_rate, value_type q,
+                                                  size_type hop_size, windowing::WindowType window, value_type gamma,
+                                                  value_type threshold) :
+        frequencies_(first, last),
+        lengths_(frequencies_.size()),
+        offsets_(1, 0),
+        hop_size_(hop_size) {
+        meta::expects(q > 0 && gamma >= 0, "The quality factor should be positive and gamma non-negative");
+        meta::expects(hop_size > 0, "The hop size should be greater than zero");
+        meta::expects(threshold >= 0 && threshold < 1, "The threshold should be in the range [0, 1)");
+
+        const auto nfft = internal::cqt_nfft(std::cbegin(frequencies_), std::cend(frequencies_), sample_rate, q, gamma);
+        engine_         = std::make_unique<fft_engine<T>>(nfft, std::initializer_list<fft_kind>{fft_kind::RealForward});
+        frame_.resize(nfft);
+        spectrum_.resize(make_fft_size(nfft));
+
+        // The kernels are transformed with a temporary complex engine, only the positive frequencies are kept.
+        fft_engine<T> kernel_engine(nfft, {fft_kind::ComplexForward});
+        std::vector<complex_type> temporal(nfft), spectral(nfft);
+        std::vector<value_type> shape;
+        constexpr auto two_pi = 2 * 3.141592653589793238462643383279502884L;
+        for (size_type k = 0; k < frequencies_.size(); ++k) {
+            const auto frequency = frequencies_[k];
+            meta::expects(frequency > 0 && frequency < sample_rate / 2, "The frequencies should be below Nyquist");
+            const auto length = static_cast<size_type>(std::ceil(sample_rate / (frequency / q + gamma)));
+            lengths_[k]       = length;
+
+            shape.resize(length);
+            windowing::make_window(window, std::begin(shape), std::end(shape));
+            value_type sum = 0;
+            for (const auto value : shape) {
+                sum += value;
+            }
+
+            // The kernel is centred in the frame, its phase is referred to the beginning of the frame.
+            std::fill(std::begin(temporal), std::end(temporal), complex_type{});
+            const auto start = (nfft - length) / 2;
+            for (size_type n = 0; n < length; ++n) {
+                const auto phase = two_pi * static_cast<long double>(frequency) *
+                                   static_cast<long double>(start + n) / static_cast<long double>(sample_rate);
+                temporal[start + n] = std::polar(shape[n] / sum, static_cast<value_type>(phase));
+            }
+            kernel_engine.dft(temporal.data(), spectral.data());
+
+            // By Parseval, X_k = 1 / N sum_j X[j] conj(K[j]).
+            const auto half = make_fft_size(nfft);
+            value_type peak = 0;
+            for (size_type j = 0; j < half; ++j) {
+                peak = std::max(peak, std::abs(spectral[j]));
+            }
+            const auto scaling = static_cast<value_type>(nfft);
+            for (size_type j = 0; j < half; ++j) {
+                if (std::abs(spectral[j]) > threshold * peak) {
+                    columns_.push_back(j);
+                    kernel_real_.push_back(spectral[j].real() / scaling);
+                    kernel_imag_.push_back(-spectral[j].imag() / scaling);
+                }
+            }
+            offsets_.push_back(columns_.size());
+        }
+    }
+
+    template <typename T>
+    typename constant_q_transform<T>::size_type constant_q_transform<T>::bins() const noexcept {
+        return frequencies_.size();
+    }
+
+    template <typename T>
+    typename constant_q_transform<T>::size_type constant_q_transform<T>::nfft() const noexcept {
+        return frame_.size();
+    }
+
+    template <typename T>
+    typename constant_q_transform<T>::size_type constant_q_transform<T>::hop_size() const noexcept {
+        return hop_size_;
+    }
+
+    template <typename T>
+    typename constant_q_transform<T>::value_type constant_q_transform<T>::frequency(size_type i) const {
+        return frequencies_[i];
+    }
+
+    template <typename T>
+    typename constant_q_transform<T>::size_type constant_q_transform<T>::length(size_type i) const {
+        return lengths_[i];
+    }
+
+    template <typename T>
+    typename constant_q_transform<T>::size_type constant_q_transform<T>::nonzeros() const noexcept {
+        return columns_.size();
+    }
+
+    template <typename T>
+    typename constant_q_transform<T>::size_type constant_q_transform<T>::frames(size_type samples) const noexcept {
+        if (samples <= skip_) {
+            return 0;
+        }
+        const auto available = filled_ + samples - skip_;
+        return (available < frame_.size()) ? 0 : (available - frame_.size()) / hop_size_ + 1;
+    }
+
+    template <typename T>
+    void constant_q_transform<T>::reset() noexcept {
+        filled_ = 0;
+        skip_   = 0;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    typename constant_q_transform<T>::size_type constant_q_transform<T>::push(InputIt first, InputIt last,
+                                                                               OutputIt d_first) {
+        const auto frame_size = frame_.size();
+        size_type emitted     = 0;
+        while (first != last) {
+            if (skip_ > 0) {
+                --skip_;
+                ++first;
+                continue;
+            }
+
+            const auto needed = static_cast<std::ptrdiff_t>(frame_size - filled_);
+            const auto count  = std::min(needed, static_cast<std::ptrdiff_t>(std::distance(first, last)));
+            std::copy_n(first, count, std::begin(frame_) + filled_);
+            std::advance(first, count);
+            filled_ += static_cast<size_type>(count);
+
+            if (filled_ == frame_size) {
+                engine_->dft(frame_.data(), spectrum_.data());
+                d_first = evaluate(spectrum_.data(), d_first);
+                ++emitted;
+                if (hop_size_ < frame_size) {
+                    std::copy(std::begin(frame_) + hop_size_, std::end(frame_), std::begin(frame_));
+                    filled_ = frame_size - hop_size_;
+                } else {
+                    skip_   = hop_size_ - frame_size;
+                    filled_ = 0;
+                }
+            }
+        }
+        return emitted;
+    }
+
+    template <typename T>
+    template <typename RandomIt, typename OutputIt>
+    typename constant_q_transform<T>::size_type constant_q_transform<T>::compute(RandomIt first, RandomIt last,
+                                                                                  OutputIt d_first,
+                                                                                  size_type threads) const {
+        const auto samples = static_cast<size_type>(std::distance(first, last));
+        const auto nfft    = frame_.size();
+        if (samples < nfft) {
+            return 0;
+        }
+        const auto frames = (samples - nfft) / hop_size_ + 1;
+        const auto bins   = frequencies_.size();
+
+        const auto worker = [&](size_type begin, size_type end) {
+            fft_engine<T> engine(nfft, {fft_kind::RealForward});
+            std::vector<value_type> frame(nfft);
+            std::vector<complex_type> spectrum(make_fft_size(nfft));
+            for (size_type i = begin; i < end; ++i) {
+                const auto position = first + static_cast<std::ptrdiff_t>(i * hop_size_);
+                std::copy(position, position + static_cast<std::ptrdiff_t>(nfft), std::begin(frame));
+                engine.dft(frame.data(), spectrum.data());
+                evaluate(spectrum.data(), d_first + static_cast<std::ptrdiff_t>(i * bins));
+            }
+        };
+
+        // The futures of std::async wait for their task when destroyed, so an exception thrown by any of the workers
+        // never leaves a running thread behind. The first exception, in frame order, is rethrown.
+        threads = std::max(std::min(threads, frames), static_cast<size_type>(1));
+        std::vector<std::future<void>> pool;
+        pool.reserve(threads - 1);
+        const auto chunk = (frames + threads - 1) / threads;
+        for (size_type t = 1; t < threads; ++t) {
+            pool.push_back(std::async(std::launch::async, worker, std::min(t * chunk, frames),
+                                      std::min((t + 1) * chunk, frames)));
+        }
+        std::exception_ptr error;
+        try {
+            worker(0, std::min(chunk, frames));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        for (auto& task : pool) {
+            try {
+                task.get();
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return frames;
+    }
+
+    template <typename T>
+    template <typename OutputIt>
+    OutputIt constant_q_transform<T>::evaluate(const complex_type* spectrum, OutputIt d_first) const {
+        const auto* offset = offsets_.data();
+        const auto* column = columns_.data();
+        const auto* kr     = kernel_real_.data();
+        const auto* ki     = kernel_imag_.data();
+        for (size_type k = 0; k < frequencies_.size(); ++k, ++d_first) {
+            value_type real = 0, imag = 0;
+            for (auto e = offset[k]; e < offset[k + 1]; ++e) {
+                const auto xr = spectrum[column[e]].real();
+                const auto xi = spectrum[column[e]].imag();
+                real += xr * kr[e] - xi * ki[e];
+                imag += xr * ki[e] + xi * kr[e];
+            }
+            *d_first = complex_type(real, imag);
+        }
+        return d_first;
+    }
+
+    /**
+     * @brief Creates a %constant_q_transform with geometrically spaced bins, as used in music analysis.
+     *
+     * The k-th bin has a centre frequency of \f$ f_{min} 2^{k / b} \f$, where b is the number of bins per octave,
+     * and the quality factor is \f$ Q = 1 / (2^{1 / b} - 1) \f$, so consecutive bins do not overlap.
+     * @param sample_rate Sampling frequency in Hz.
+     * @param min_frequency Frequency of the first bin in Hz.
+     * @param bins_per_octave Number of bins per octave.
+     * @param bins Number of bins.
+     * @param hop_size Number of samples between the beginning of two consecutive frames.
+     * @param window Type of window of the kernels.
+     * @return Transform with the given configuration.
+     */
+    template <typename T>
+    inline constant_q_transform<T>
+        make_constant_q_transform(T sample_rate, T min_frequency, std::size_t bins_per_octave, std::size_t bins,
+                                  std::size_t hop_size, windowing::WindowType window = windowing::WindowType::Hanning) {
+        meta::expects(bins_per_octave > 0 && bins > 0, "The number of bins should be greater than zero");
+        std::vector<T> frequencies(bins);
+        for (std::size_t k = 0; k < bins; ++k) {
+            frequencies[k] = min_frequency * std::pow(static_cast<T>(2), static_cast<T>(k) / bins_per_octave);
+        }
+        const auto q = 1 / (std::pow(static_cast<T>(2), static_cast<T>(1) / bins_per_octave) - 1);
+        return constant_q_transform<T>(std::cbegin(frequencies), std::cend(frequencies), sample_rate, q, hop_size,
+                                       window);
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_CONSTANT_Q_TRANSFORM_HPP
@@ -24,10 +24,50 @@
 #define EDSP_CONVOLUTION_HPP
 
 #include <edsp/spectral/fft_engine.hpp>
+#include <edsp/spectral/spectral_workspace.hpp>
 #include <vector>
 
 namespace edsp { inline namespace spectral {
 
+    /**
+     * @brief Computes the convolution between the range [first1, last1) and the range [first2, last2), and stores the result in another range,
+     * beginning at d_first.
+     *
+     * This overload does not allocate any memory: all the temporary buffers are taken from the workspace.
+     *
+     * @param first1 Input iterator defining the beginning of the first input range.
+     * @param last1 Input iterator defining the ending of the first input range.
+     * @param first2 Input iterator defining the beginning of the second input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param workspace Workspace created for inputs of std::distance(first1, last1) samples.
+     */
+    template <typename InputIt, typename OutputIt, typename T, typename RAllocator, typename CAllocator>
+    inline void conv(InputIt first1, InputIt last1, InputIt first2, OutputIt d_first,
+                     spectral_workspace<T, RAllocator, CAllocator>& workspace) {
+        const auto size = std::distance(first1, last1);
+        meta::expects(size > 0, "Not expecting empty input");
+        meta::expects(static_cast<std::size_t>(size) == workspace.size(),
+                      "The workspace size does not match the input");
+        auto& engine      = workspace.padded_engine();
+        auto& temp_input1 = workspace.real1();
+        auto& temp_input2 = workspace.real2();
+        auto& fft_data1   = workspace.complex1();
+        auto& fft_data2   = workspace.complex2();
+
+        std::fill(std::copy(first1, last1, std::begin(temp_input1)), std::end(temp_input1), static_cast<T>(0));
+        std::fill(std::copy_n(first2, size, std::begin(temp_input2)), std::end(temp_input2), static_cast<T>(0));
+
+        engine.dft(meta::data(temp_input1), meta::data(fft_data1));
+        engine.dft(meta::data(temp_input2), meta::data(fft_data2));
+
+        std::transform(std::cbegin(fft_data1), std::cend(fft_data1), std::cbegin(fft_data2), std::begin(fft_data1),
+                       std::multiplies<>());
+
+        engine.idft(meta::data(fft_data1), meta::data(temp_input1));
+        engine.idft_scale(meta::data(temp_input1));
+        std::copy(std::cbegin(temp_input1), std::cbegin(temp_input1) + size, d_first);
+    }
+
     /**
      * @brief Computes the convolution between the range [first1, last1) and the range [first2, last2), and stores the result in another range,
      * beginning at d_first.
@@ -50,28 +90,8 @@ namespace edsp { inline namespace spectral {
     inline void conv(InputIt first1, InputIt last1, InputIt first2, OutputIt d_first) {
         meta::expects(std::distance(first1, last1) > 0, "Not expecting empty input");
         using value_type = meta::value_type_t<InputIt>;
-        const auto size  = std::distance(first1, last1);
-        const auto nfft  = 2 * size;
-        fft_engine<value_type> fft_(nfft);
-        fft_engine<value_type> ifft_(nfft);
-
-        std::vector<value_type, RAllocator> temp_input1(nfft, static_cast<value_type>(0)),
-            temp_input2(nfft, static_cast<value_type>(0)), temp_output(nfft);
-        std::copy(first1, last1, std::begin(temp_input1));
-        std::copy(first2, meta::advance(first2, size), std::begin(temp_input2));
-
-        std::vector<std::complex<value_type>, CAllocator> fft_data1(make_fft_size(nfft));
-        std::vector<std::complex<value_type>, CAllocator> fft_data2(make_fft_size(nfft));
-
-        fft_.dft(meta::data(temp_input1), meta::data(fft_data1));
-        fft_.dft(meta::data(temp_input2), meta::data(fft_data2));
-
-        std::transform(std::cbegin(fft_data1), std::cend(fft_data1), std::cbegin(fft_data2), std::begin(fft_data1),
-                       std::multiplies<>());
-
-        ifft_.idft(meta::data(fft_data1), meta::data(temp_output));
-        ifft_.idft_scale(meta::data(temp_output));
-        std::copy(std::cbegin(temp_output), std::cbegin(temp_output) + size, d_first);
+        spectral_workspace<value_type, RAllocator, CAllocator> workspace(std::distance(first1, last1));
+        conv(first1, last1, first2, d_first, workspace);
     }
 
 }} // namespace edsp::spectral
@@ -24,6 +24,11 @@
 #define EDSP_AUTOCORRELATION_HPP
 
 #include <edsp/spectral/fft_engine.hpp>
+#include <edsp/spectral/spectral_workspace.hpp>
+#include <edsp/meta/is_iterator.hpp>
+#include <edsp/meta/type_traits.hpp>
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
 namespace edsp { inline namespace spectral {
@@ -37,6 +42,123 @@ namespace edsp { inline namespace spectral {
         Unbiased /*!< Unbiased estimate of the cross-correlation. */
     };
 
+    /**
+     * @brief The CorrelationMode enum defines which lags of the correlation are computed.
+     *
+     * Given two inputs of N and M samples, the lag k of their correlation is defined for
+     * \f$ -(M-1) \leq k \leq N-1 \f$.
+     */
+    enum class CorrelationMode {
+        Full,  /*!< All the N + M - 1 lags of the correlation. */
+        Same,  /*!< The central max(N, M) lags of the full correlation. */
+        Valid  /*!< Only the lags where the shortest input completely overlaps with the longest one. */
+    };
+
+    namespace internal {
+
+        /**
+         * @brief Computes the correlation lags in the range [first_lag, last_lag] of two spectra and stores the scaled
+         * result in another range, beginning at d_first.
+         *
+         * The spectra should be computed with an FFT size of at least max(N - first_lag, M + last_lag) samples to
+         * avoid the circular aliasing of the lags.
+         */
+        template <typename T, typename OutputIt, typename RAllocator, typename CAllocator>
+        inline OutputIt correlate_spectra(fft_engine<T>& engine, std::vector<std::complex<T>, CAllocator>& spectrum1,
+                                          const std::vector<std::complex<T>, CAllocator>& spectrum2,
+                                          std::vector<T, RAllocator>& output, std::ptrdiff_t size1,
+                                          std::ptrdiff_t size2, std::ptrdiff_t first_lag, std::ptrdiff_t last_lag,
+                                          OutputIt d_first, CorrelationScale scale) {
+            std::transform(std::cbegin(spectrum1), std::cend(spectrum1), std::cbegin(spectrum2), std::begin(spectrum1),
+                           [](const std::complex<T>& left, const std::complex<T>& right) -> std::complex<T> {
+                               return left * std::conj(right);
+                           });
+            engine.idft(meta::data(spectrum1), meta::data(output));
+
+            const auto nfft   = static_cast<std::ptrdiff_t>(output.size());
+            const auto factor = static_cast<T>(nfft * (scale == CorrelationScale::Biased ? std::max(size1, size2) : 1));
+            for (auto lag = first_lag; lag <= last_lag; ++lag, ++d_first) {
+                auto value = output[static_cast<std::size_t>((lag + nfft) % nfft)] / factor;
+                if (scale == CorrelationScale::Unbiased) {
+                    const auto overlap = std::min(size2, size1 - lag) - std::max(std::ptrdiff_t{0}, -lag);
+                    value              = (overlap > 0) ? value / static_cast<T>(overlap) : T{0};
+                }
+                *d_first = value;
+            }
+            return d_first;
+        }
+
+        template <typename T, typename OutputIt, typename InputIt1, typename InputIt2,
+                  typename RAllocator = std::allocator<T>, typename CAllocator = std::allocator<std::complex<T>>>
+        inline void correlate_lags(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first,
+                                   std::ptrdiff_t first_lag, std::ptrdiff_t last_lag, CorrelationScale scale) {
+            const auto size1 = std::distance(first1, last1);
+            const auto size2 = std::distance(first2, last2);
+            const auto size  = static_cast<std::size_t>(std::max(size1 - first_lag, size2 + last_lag));
+            const auto nfft  = make_fast_fft_size(size);
+            fft_engine<T> engine(nfft);
+
+            std::vector<T, RAllocator> temp_input1(nfft, static_cast<T>(0)), temp_input2(nfft, static_cast<T>(0)),
+                temp_output(nfft);
+            std::copy(first1, last1, std::begin(temp_input1));
+            std::copy(first2, last2, std::begin(temp_input2));
+
+            std::vector<std::complex<T>, CAllocator> fft_data1(make_fft_size(nfft));
+            std::vector<std::complex<T>, CAllocator> fft_data2(make_fft_size(nfft));
+            engine.dft(meta::data(temp_input1), meta::data(fft_data1));
+            engine.dft(meta::data(temp_input2), meta::data(fft_data2));
+            correlate_spectra(engine, fft_data1, fft_data2, temp_output, size1, size2, first_lag, last_lag, d_first,
+                              scale);
+        }
+
+    } // namespace internal
+
+    /**
+     * @brief Computes the autocorrelation of the range [first, last) and stores the result in another range, beginning at d_first.
+     *
+     * The result of xcorr can be interpreted as an estimate of the correlation between two random sequences or as the deterministic
+     * correlation between two deterministic signals.
+     *
+     * \f[
+     *
+     *  R_{xx}(k) = \sum_{n=-\infty}^{\infty} x(n)x(n-k)
+     *
+     * \f]
+     *
+     * This overload does not allocate any memory: all the temporary buffers are taken from the workspace.
+     *
+     * @param first Input iterator defining the beginning of the input range.
+     * @param last Input iterator defining the ending of the input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param workspace Workspace created for inputs of std::distance(first, last) samples.
+     * @param scale Scale factor to use.
+     */
+    template <typename InputIt, typename OutputIt, typename T, typename RAllocator, typename CAllocator>
+    inline void xcorr(InputIt first, InputIt last, OutputIt d_first,
+                      spectral_workspace<T, RAllocator, CAllocator>& workspace,
+                      CorrelationScale scale = CorrelationScale::None) {
+        const auto size = std::distance(first, last);
+        meta::expects(size > 0, "Not expecting empty input");
+        meta::expects(static_cast<std::size_t>(size) == workspace.size(),
+                      "The workspace size does not match the input");
+        const auto nfft   = workspace.required_size(workspace.size());
+        auto& engine      = workspace.padded_engine();
+        auto& temp_input  = workspace.real1();
+        auto& temp_output = workspace.real2();
+        auto& fft_data_   = workspace.complex1();
+
+        std::fill(std::copy(first, last, std::begin(temp_input)), std::end(temp_input), static_cast<T>(0));
+        engine.dft(meta::data(temp_input), meta::data(fft_data_));
+
+        std::transform(std::cbegin(fft_data_), std::cend(fft_data_), std::begin(fft_data_),
+                       [](const std::complex<T>& val) -> std::complex<T> { return val * std::conj(val); });
+
+        engine.idft(meta::data(fft_data_), meta::data(temp_output));
+        const auto factor = static_cast<T>(nfft * (scale == CorrelationScale::Biased ? nfft : 1));
+        std::transform(std::cbegin(temp_output), std::cbegin(temp_output) + size, d_first,
+                       [factor](T val) { return val / factor; });
+    }
+
     /**
      * @brief Computes the autocorrelation of the range [first, last) and stores the result in another range, beginning at d_first.
      *
@@ -59,25 +181,62 @@ namespace edsp { inline namespace spectral {
     inline void xcorr(InputIt first, InputIt last, OutputIt d_first, CorrelationScale scale = CorrelationScale::None) {
         meta::expects(std::distance(first, last) > 0, "Not expecting empty input");
         using value_type = meta::value_type_t<InputIt>;
-        const auto size  = std::distance(first, last);
-        const auto nfft  = 2 * size;
-        fft_engine<value_type> fft_(nfft);
-        fft_engine<value_type> ifft_(nfft);
+        spectral_workspace<value_type, RAllocator, CAllocator> workspace(std::distance(first, last));
+        xcorr(first, last, d_first, workspace, scale);
+    }
 
-        std::vector<value_type, RAllocator> temp_input(nfft, static_cast<value_type>(0)), temp_output(nfft);
-        std::copy(first, last, std::begin(temp_input));
+    /**
+     * @brief Computes the correlation between the range [first1, last1) and the [first2, last2), and stores the result in another range,
+     * beginning at d_first.
+     *
+     * The result of xcorr can be interpreted as an estimate of the correlation between two random sequences or as the deterministic
+     * correlation between two deterministic signals.
+     *
+     * \f[
+     *
+     *  R_{x_1 x_2}(k) = \sum_{n=-\infty}^{\infty} x_1(n)x_2(n-k)
+     *
+     * \f]
+     *
+     * This overload does not allocate any memory: all the temporary buffers are taken from the workspace.
+     *
+     * @param first1 Input iterator defining the beginning of the first input range.
+     * @param last1 Input iterator defining the ending of the first input range.
+     * @param first2 Input iterator defining the beginning of the second input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param workspace Workspace created for inputs of std::distance(first1, last1) samples.
+     * @param scale Scale factor to use.
+     */
+    template <typename InputIt, typename OutputIt, typename T, typename RAllocator, typename CAllocator>
+    inline void xcorr(InputIt first1, InputIt last1, InputIt first2, OutputIt d_first,
+                      spectral_workspace<T, RAllocator, CAllocator>& workspace,
+                      CorrelationScale scale = CorrelationScale::None) {
+        const auto size = std::distance(first1, last1);
+        meta::expects(size > 0, "Not expecting empty input");
+        meta::expects(static_cast<std::size_t>(size) == workspace.size(),
+                      "The workspace size does not match the input");
+        const auto nfft   = workspace.required_size(workspace.size());
+        auto& engine      = workspace.padded_engine();
+        auto& temp_input1 = workspace.real1();
+        auto& temp_input2 = workspace.real2();
+        auto& fft_data1   = workspace.complex1();
+        auto& fft_data2   = workspace.complex2();
 
-        std::vector<std::complex<value_type>, CAllocator> fft_data_(make_fft_size(nfft));
-        fft_.dft(meta::data(temp_input), meta::data(fft_data_));
+        std::fill(std::copy(first1, last1, std::begin(temp_input1)), std::end(temp_input1), static_cast<T>(0));
+        std::fill(std::copy_n(first2, size, std::begin(temp_input2)), std::end(temp_input2), static_cast<T>(0));
 
-        std::transform(
-            std::cbegin(fft_data_), std::cend(fft_data_), std::begin(fft_data_),
-            [](const std::complex<value_type>& val) -> std::complex<value_type> { return val * std::conj(val); });
+        engine.dft(meta::data(temp_input1), meta::data(fft_data1));
+        engine.dft(meta::data(temp_input2), meta::data(fft_data2));
 
-        ifft_.idft(meta::data(fft_data_), meta::data(temp_output));
-        const auto factor = static_cast<value_type>(nfft * (scale == CorrelationScale::Biased ? nfft : 1));
-        std::transform(std::cbegin(temp_output), std::cbegin(temp_output) + size, d_first,
-                       [factor](value_type val) { return val / factor; });
+        std::transform(std::cbegin(fft_data1), std::cend(fft_data1), std::cbegin(fft_data2), std::begin(fft_data1),
+                       [](const std::complex<T>& left, const std::complex<T>& right) -> std::complex<T> {
+                           return left * std::conj(right);
+                       });
+
+        engine.idft(meta::data(fft_data1), meta::data(temp_input1));
+        const auto factor = static_cast<T>(nfft * (scale == CorrelationScale::Biased ? nfft : 1));
+        std::transform(std::cbegin(temp_input1), std::cbegin(temp_input1) + size, d_first,
+                       [factor](T val) { return val / factor; });
     }
 
     /**
@@ -100,35 +259,200 @@ namespace edsp { inline namespace spectral {
      * @param scale Scale factor to use.
      */
     template <typename InputIt, typename OutputIt, typename RAllocator = std::allocator<meta::value_type_t<InputIt>>,
-              typename CAllocator = std::allocator<std::complex<meta::value_type_t<OutputIt>>>>
+              typename CAllocator = std::allocator<std::complex<meta::value_type_t<OutputIt>>>,
+              typename = meta::enable_if_t<meta::is_iterator_v<OutputIt>>>
     inline void xcorr(InputIt first1, InputIt last1, InputIt first2, OutputIt d_first,
                       CorrelationScale scale = CorrelationScale::None) {
         meta::expects(std::distance(first1, last1) > 0, "Not expecting empty input");
         using value_type = meta::value_type_t<InputIt>;
-        const auto size  = std::distance(first1, last1);
-        const auto nfft  = 2 * size;
-        fft_engine<value_type> fft_(nfft);
-        fft_engine<value_type> ifft_(nfft);
+        spectral_workspace<value_type, RAllocator, CAllocator> workspace(std::distance(first1, last1));
+        xcorr(first1, last1, first2, d_first, workspace, scale);
+    }
 
-        std::vector<value_type, RAllocator> temp_input1(nfft, static_cast<value_type>(0)),
-            temp_input2(nfft, static_cast<value_type>(0)), temp_output(nfft);
-        std::copy(first1, last1, std::begin(temp_input1));
-        std::copy(first2, meta::advance(first2, size), std::begin(temp_input2));
+    /**
+     * @brief Computes the correlation between the range [first1, last1) of N samples and the range [first2, last2) of M
+     * samples, and stores the lags selected by the given mode in another range, beginning at d_first.
+     *
+     * \f[
+     *
+     *  R_{x_1 x_2}(k) = \sum_{n=0}^{M-1} x_1(n+k)x_2(n), \quad -(M-1) \leq k \leq N-1
+     *
+     * \f]
+     *
+     * The lags are stored in increasing order: the Full mode stores N + M - 1 lags starting at -(M-1), the Same mode
+     * stores max(N, M) lags starting at \f$ \lfloor min(N, M) / 2 \rfloor - (M-1) \f$ and the Valid mode stores
+     * |N - M| + 1 lags starting at min(0, N - M).
+     *
+     * @param first1 Input iterator defining the beginning of the first input range.
+     * @param last1 Input iterator defining the ending of the first input range.
+     * @param first2 Input iterator defining the beginning of the second input range.
+     * @param last2 Input iterator defining the ending of the second input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param mode Lags to compute.
+     * @param scale Scale factor to use.
+     */
+    template <typename InputIt1, typename InputIt2, typename OutputIt>
+    inline void xcorr(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first,
+                      CorrelationMode mode, CorrelationScale scale = CorrelationScale::None) {
+        const auto size1 = std::distance(first1, last1);
+        const auto size2 = std::distance(first2, last2);
+        meta::expects(size1 > 0 && size2 > 0, "Not expecting empty input");
+        using value_type = meta::value_type_t<InputIt1>;
 
-        std::vector<std::complex<value_type>, CAllocator> fft_data1(make_fft_size(nfft));
-        std::vector<std::complex<value_type>, CAllocator> fft_data2(make_fft_size(nfft));
+        std::ptrdiff_t first_lag = -(size2 - 1);
+        std::ptrdiff_t last_lag  = size1 - 1;
+        if (mode == CorrelationMode::Same) {
+            first_lag += (std::min(size1, size2) - 1) - std::min(size1, size2) / 2;
+            last_lag = first_lag + std::max(size1, size2) - 1;
+        } else if (mode == CorrelationMode::Valid) {
+            first_lag = std::min(std::ptrdiff_t{0}, size1 - size2);
+            last_lag  = std::max(std::ptrdiff_t{0}, size1 - size2);
+        }
+        internal::correlate_lags<value_type>(first1, last1, first2, last2, d_first, first_lag, last_lag, scale);
+    }
 
-        fft_.dft(meta::data(temp_input1), meta::data(fft_data1));
-        fft_.dft(meta::data(temp_input2), meta::data(fft_data2));
+    /**
+     * @brief Computes the lags [-max_lag, max_lag] of the correlation between the range [first1, last1) of N samples
+     * and the range [first2, last2) of M samples, and stores the 2 * max_lag + 1 values in another range, beginning at
+     * d_first.
+     *
+     * Only max(N, M) + max_lag samples are transformed, instead of the N + M - 1 samples needed by the full
+     * correlation, which makes this function suitable to estimate small delays between long signals. Both sizes are
+     * rounded up to the next power of two, the fastest size of every FFT backend.
+     *
+     * @param first1 Input iterator defining the beginning of the first input range.
+     * @param last1 Input iterator defining the ending of the first input range.
+     * @param first2 Input iterator defining the beginning of the second input range.
+     * @param last2 Input iterator defining the ending of the second input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param max_lag Maximum lag to compute.
+     * @param scale Scale factor to use.
+     * @see CorrelationMode
+     */
+    template <typename InputIt1, typename InputIt2, typename OutputIt>
+    inline void xcorr(InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, OutputIt d_first,
+                      std::size_t max_lag, CorrelationScale scale = CorrelationScale::None) {
+        meta::expects(std::distance(first1, last1) > 0 && std::distance(first2, last2) > 0,
+                      "Not expecting empty input");
+        using value_type = meta::value_type_t<InputIt1>;
+        const auto lag   = static_cast<std::ptrdiff_t>(max_lag);
+        internal::correlate_lags<value_type>(first1, last1, first2, last2, d_first, -lag, lag, scale);
+    }
 
-        std::transform(std::cbegin(fft_data1), std::cend(fft_data1), std::cbegin(fft_data2), std::begin(fft_data1),
-                       [](const std::complex<value_type>& left, const std::complex<value_type>& right)
-                           -> std::complex<value_type> { return left * std::conj(right); });
+    /**
+     * @class cross_correlator
+     * @brief This class computes the correlation of a stream of frames against a fixed reference signal.
+     *
+     * The spectrum of the reference is computed once, during the construction, so every frame only requires one
+     * forward and one inverse FFT. All the memory is allocated during the construction.
+     *
+     * @tparam T Floating point type.
+     * @see xcorr
+     */
+    template <typename T>
+    class cross_correlator {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
 
-        ifft_.idft(meta::data(fft_data1), meta::data(temp_output));
-        const auto factor = static_cast<value_type>(nfft * (scale == CorrelationScale::Biased ? nfft : 1));
-        std::transform(std::cbegin(temp_output), std::cbegin(temp_output) + size, d_first,
-                       [factor](value_type val) { return val / factor; });
+        /**
+         * @brief Creates a %cross_correlator with the reference signal in the range [first, last).
+         * @param first Input iterator defining the beginning of the reference range.
+         * @param last Input iterator defining the ending of the reference range.
+         * @param frame_size Number of samples of every frame.
+         * @param max_lag Maximum lag to compute.
+         * @param scale Scale factor to use.
+         */
+        template <typename InputIt>
+        cross_correlator(InputIt first, InputIt last, size_type frame_size, size_type max_lag,
+                         CorrelationScale scale = CorrelationScale::None);
+
+        /**
+         * @brief Returns the number of samples of every frame.
+         * @return Frame size.
+         */
+        size_type frame_size() const noexcept;
+
+        /**
+         * @brief Returns the maximum computed lag.
+         * @return Maximum lag.
+         */
+        size_type max_lag() const noexcept;
+
+        /**
+         * @brief Returns the number of lags computed for every frame.
+         * @return 2 * max_lag + 1
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Computes the lags [-max_lag, max_lag] of the correlation between the frame beginning at first and the
+         * reference signal, and stores the result in another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the frame.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element written.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt compute(InputIt first, OutputIt d_first);
+
+    private:
+        fft_engine<T> engine_;
+        std::vector<value_type> input_;
+        std::vector<value_type> output_;
+        std::vector<complex_type> spectrum_;
+        std::vector<complex_type> reference_;
+        size_type frame_size_;
+        size_type reference_size_;
+        size_type max_lag_;
+        CorrelationScale scale_;
+    };
+
+    template <typename T>
+    template <typename InputIt>
+    cross_correlator<T>::cross_correlator(InputIt first, InputIt last, size_type frame_size, size_type max_lag,
+                                          CorrelationScale scale) :
+        engine_(make_fast_fft_size(std::max(frame_size, static_cast<size_type>(std::distance(first, last))) +
+                                   max_lag),
+                {fft_kind::RealForward, fft_kind::RealBackward}),
+        input_(engine_.size(), static_cast<value_type>(0)),
+        output_(engine_.size()),
+        spectrum_(make_fft_size(engine_.size())),
+        reference_(make_fft_size(engine_.size())),
+        frame_size_(frame_size),
+        reference_size_(static_cast<size_type>(std::distance(first, last))),
+        max_lag_(max_lag),
+        scale_(scale) {
+        meta::expects(frame_size_ > 0 && reference_size_ > 0, "Not expecting empty input");
+        std::copy(first, last, std::begin(input_));
+        engine_.dft(meta::data(input_), meta::data(reference_));
+        std::fill(std::begin(input_), std::end(input_), static_cast<value_type>(0));
+    }
+
+    template <typename T>
+    typename cross_correlator<T>::size_type cross_correlator<T>::frame_size() const noexcept {
+        return frame_size_;
+    }
+
+    template <typename T>
+    typename cross_correlator<T>::size_type cross_correlator<T>::max_lag() const noexcept {
+        return max_lag_;
+    }
+
+    template <typename T>
+    typename cross_correlator<T>::size_type cross_correlator<T>::size() const noexcept {
+        return 2 * max_lag_ + 1;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt cross_correlator<T>::compute(InputIt first, OutputIt d_first) {
+        std::copy_n(first, frame_size_, std::begin(input_));
+        engine_.dft(meta::data(input_), meta::data(spectrum_));
+        const auto lag = static_cast<std::ptrdiff_t>(max_lag_);
+        return internal::correlate_spectra(engine_, spectrum_, reference_, output_,
+                                           static_cast<std::ptrdiff_t>(frame_size_),
+                                           static_cast<std::ptrdiff_t>(reference_size_), -lag, lag, d_first, scale_);
     }
 
 }}     // namespace edsp::spectral
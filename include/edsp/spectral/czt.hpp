@@ -0,0 +1,279 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: czt.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_CZT_HPP
+#define EDSP_CZT_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @class czt_engine
+     * @brief This class computes the Chirp Z-Transform (CZT) of sequences of a fixed size.
+     *
+     * The CZT evaluates the Z-transform of a sequence of N samples in M points of a spiral arc of the z-plane,
+     * starting at the point a and separated by the ratio w:
+     *
+     * \f[
+     *  X_k = \sum_{n=0}^{N-1} x_n z_k^{-n}, \quad z_k = a w^{-k}, \quad k = 0, \dots, M - 1
+     * \f]
+     *
+     * It is computed with the Bluestein algorithm, as a circular convolution of size L >= N + M - 1, so the cost of
+     * every transform is O(L log L) independently of the resolution of the arc. The chirps and the spectrum of the
+     * convolution kernel are computed once, during the construction, so the same engine can be reused for many
+     * frames without allocating memory.
+     *
+     * @tparam T Floating point type.
+     * @see make_zoom_fft
+     */
+    template <typename T>
+    class czt_engine {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %czt_engine with the given configuration.
+         *
+         * The arc is given in extended precision, the chirps raise it to powers up to the square of the input size.
+         * @param size Number of samples of the input sequences.
+         * @param points Number of points of the arc.
+         * @param w Ratio between two consecutive points of the arc.
+         * @param a Starting point of the arc.
+         */
+        czt_engine(size_type size, size_type points, const std::complex<long double>& w,
+                   const std::complex<long double>& a = std::complex<long double>(1));
+
+        /**
+         * @brief Returns the number of samples of the input sequences.
+         * @return Input size.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Returns the number of points of the arc.
+         * @return Number of output samples.
+         */
+        size_type points() const noexcept;
+
+        /**
+         * @brief Returns the size of the FFT used to compute the convolution.
+         * @return Size of the FFT.
+         */
+        size_type nfft() const noexcept;
+
+        /**
+         * @brief Computes the CZT of the range [first, last) and stores the result in another range, beginning at
+         * d_first.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range, it stores points() complex
+         * numbers.
+         * @note The number of input samples should be size(). The samples can be real or complex.
+         */
+        template <typename InputIt, typename OutputIt>
+        void compute(InputIt first, InputIt last, OutputIt d_first);
+
+    private:
+        static complex_type power(long double radius, long double angle, long double exponent);
+
+        std::unique_ptr<fft_engine<T>> engine_;
+        std::vector<complex_type> pre_;
+        std::vector<complex_type> post_;
+        std::vector<complex_type> kernel_;
+        std::vector<complex_type> buffer_;
+        std::vector<complex_type> spectrum_;
+        size_type size_;
+        size_type points_;
+    };
+
+    template <typename T>
+    czt_engine<T>::czt_engine(size_type size, size_type points, const std::complex<long double>& w,
+                              const std::complex<long double>& a) :
+        pre_(size),
+        post_(points),
+        size_(size),
+        points_(points) {
+        meta::expects(size > 0 && points > 0, "The input size and the number of points should be greater than zero");
+        meta::expects(std::abs(a) > 0 && std::abs(w) > 0, "The starting point and the ratio should be non-zero");
+
+        size_type nfft = 1;
+        while (nfft < size + points - 1) {
+            nfft *= 2;
+        }
+        engine_ = std::make_unique<fft_engine<T>>(nfft, std::initializer_list<fft_kind>{fft_kind::ComplexForward,
+                                                                                       fft_kind::ComplexBackward});
+        kernel_.resize(nfft);
+        buffer_.resize(nfft);
+        spectrum_.resize(nfft);
+
+        // n k = (n^2 + k^2 - (k - n)^2) / 2, so the transform is a convolution with the chirp w^(-n^2 / 2).
+        const auto w_radius = std::abs(w);
+        const auto w_angle  = std::arg(w);
+        const auto a_radius = std::abs(a);
+        const auto a_angle  = std::arg(a);
+        for (size_type n = 0; n < size; ++n) {
+            const auto squared = static_cast<long double>(n) * static_cast<long double>(n) / 2;
+            pre_[n] = power(a_radius, a_angle, -static_cast<long double>(n)) * power(w_radius, w_angle, squared);
+        }
+        for (size_type k = 0; k < points; ++k) {
+            const auto squared = static_cast<long double>(k) * static_cast<long double>(k) / 2;
+            post_[k]           = power(w_radius, w_angle, squared);
+        }
+
+        // The inverse FFT scaling is folded in the spectrum of the kernel.
+        const auto length = std::max(size, points);
+        for (size_type j = 0; j < length; ++j) {
+            const auto value = power(w_radius, w_angle, -static_cast<long double>(j) * static_cast<long double>(j) / 2);
+            if (j < points) {
+                buffer_[j] = value;
+            }
+            if (j > 0 && j < size) {
+                buffer_[nfft - j] = value;
+            }
+        }
+        engine_->dft(buffer_.data(), kernel_.data());
+        const auto scaling = static_cast<value_type>(nfft);
+        for (auto& value : kernel_) {
+            value /= scaling;
+        }
+    }
+
+    template <typename T>
+    typename czt_engine<T>::size_type czt_engine<T>::size() const noexcept {
+        return size_;
+    }
+
+    template <typename T>
+    typename czt_engine<T>::size_type czt_engine<T>::points() const noexcept {
+        return points_;
+    }
+
+    template <typename T>
+    typename czt_engine<T>::size_type czt_engine<T>::nfft() const noexcept {
+        return kernel_.size();
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    void czt_engine<T>::compute(InputIt first, InputIt last, OutputIt d_first) {
+        meta::expects(static_cast<size_type>(std::distance(first, last)) == size_,
+                      "The number of samples does not match the size of the engine");
+        for (size_type n = 0; n < size_; ++n, ++first) {
+            buffer_[n] = complex_type(*first) * pre_[n];
+        }
+        std::fill(std::begin(buffer_) + size_, std::end(buffer_), complex_type{});
+
+        engine_->dft(buffer_.data(), spectrum_.data());
+        std::transform(std::cbegin(spectrum_), std::cend(spectrum_), std::cbegin(kernel_), std::begin(spectrum_),
+                       std::multiplies<complex_type>());
+        engine_->idft(spectrum_.data(), buffer_.data());
+        std::transform(std::cbegin(post_), std::cend(post_), std::cbegin(buffer_), d_first,
+                       std::multiplies<complex_type>());
+    }
+
+    template <typename T>
+    typename czt_engine<T>::complex_type czt_engine<T>::power(long double radius, long double angle,
+                                                              long double exponent) {
+        const auto magnitude = std::pow(radius, exponent);
+        const auto phase     = angle * exponent;
+        return {static_cast<value_type>(magnitude * std::cos(phase)),
+                static_cast<value_type>(magnitude * std::sin(phase))};
+    }
+
+    /**
+     * @brief Creates a %czt_engine that computes a zoom FFT: the spectrum of the frequency band [start, stop] with
+     * the given number of equally spaced points.
+     *
+     * The arc is the segment of the unit circle between both frequencies, so the frequency resolution is
+     * (stop - start) / (points - 1) Hz, independently of the number of input samples.
+     * @param size Number of samples of the input sequences.
+     * @param points Number of frequencies evaluated.
+     * @param start First frequency of the band in Hz.
+     * @param stop Last frequency of the band in Hz.
+     * @param sample_rate Sampling frequency in Hz.
+     * @return Engine computing the zoom FFT.
+     */
+    template <typename T>
+    inline czt_engine<T> make_zoom_fft(std::size_t size, std::size_t points, T start, T stop, T sample_rate) {
+        meta::expects(sample_rate > 0, "The sample rate should be greater than zero");
+        constexpr auto two_pi = 2 * 3.141592653589793238462643383279502884L;
+        const auto step =
+            (points > 1) ? static_cast<long double>(stop - start) / static_cast<long double>(points - 1) : 0.0L;
+        const auto w_angle = -two_pi * step / static_cast<long double>(sample_rate);
+        const auto a_angle = two_pi * static_cast<long double>(start) / static_cast<long double>(sample_rate);
+        return czt_engine<T>(size, points, std::polar(1.0L, w_angle), std::polar(1.0L, a_angle));
+    }
+
+    /**
+     * @brief Computes the Chirp Z-Transform of the range [first, last) and stores the result in another range,
+     * beginning at d_first.
+     *
+     * To compute several transforms of the same size, create a %czt_engine once and reuse it.
+     * @param first Input iterator defining the beginning of the input range.
+     * @param last Input iterator defining the ending of the input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param points Number of points of the arc.
+     * @param w Ratio between two consecutive points of the arc.
+     * @param a Starting point of the arc.
+     * @see czt_engine
+     */
+    template <typename InputIt, typename OutputIt, typename T>
+    inline void czt(InputIt first, InputIt last, OutputIt d_first, std::size_t points, const std::complex<T>& w,
+                    const std::complex<T>& a = std::complex<T>(1)) {
+        const auto size = static_cast<std::size_t>(std::distance(first, last));
+        czt_engine<T> engine(size, points, std::complex<long double>(w), std::complex<long double>(a));
+        engine.compute(first, last, d_first);
+    }
+
+    /**
+     * @brief Computes the spectrum of the range [first, last) in the frequency band [start, stop] and stores the
+     * result in another range, beginning at d_first.
+     * @param first Input iterator defining the beginning of the input range.
+     * @param last Input iterator defining the ending of the input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param points Number of frequencies evaluated.
+     * @param start First frequency of the band in Hz.
+     * @param stop Last frequency of the band in Hz.
+     * @param sample_rate Sampling frequency in Hz.
+     * @see make_zoom_fft
+     */
+    template <typename InputIt, typename OutputIt, typename T>
+    inline void zoom_fft(InputIt first, InputIt last, OutputIt d_first, std::size_t points, T start, T stop,
+                         T sample_rate) {
+        const auto size = static_cast<std::size_t>(std::distance(first, last));
+        auto engine     = make_zoom_fft(size, points, start, stop, sample_rate);
+        engine.compute(first, last, d_first);
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_CZT_HPP
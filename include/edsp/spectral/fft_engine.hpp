@@ -24,6 +24,10 @@
 #define EDSP_FFT_HPP
 
 #include <edsp/spectral/internal/fft_impl.hpp>
+#include <edsp/spectral/fft_plan_cache.hpp>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
 
 namespace edsp { inline namespace spectral {
 
@@ -45,16 +49,39 @@ namespace edsp { inline namespace spectral {
         return 2 * (complex_size - 1);
     }
 
+    /**
+     * @brief Computes the smallest power of two greater than or equal to the given size.
+     *
+     * Every backend computes power of two sizes with its fastest algorithm, so zero-padded transforms, as the
+     * convolutions and correlations, should use this size instead of the minimum one.
+     * @returns Size of the DFT
+     */
+    template <typename Integer>
+    constexpr Integer make_fast_fft_size(Integer size) noexcept {
+        Integer fast = 1;
+        while (fast < size) {
+            fast *= 2;
+        }
+        return fast;
+    }
+
     /**
      * @brief This class contains an instance of an FFT engine. Use this class to perform
      * an FFT internally in any algorithm and only for performance reason. There are wrappers
      * around this class to perform basic operations.
+     *
+     * The native and FFTW backends support float, double and long double (FFTW requires the fftw3f and fftw3l
+     * libraries for float and long double). The PFFFT backend only supports float. Use mixed_fft_engine to compute
+     * the butterflies of single precision buffers in a wider type.
      * @tparam T Floating point type.
      */
     template <typename T>
     class fft_engine {
     public:
-        //static_assert(std::is_floating_point<T>::value, "Expecting floating point numbers");
+        static_assert(std::is_floating_point<T>::value, "Expecting floating point numbers");
+#if defined(USE_LIBPFFFT)
+        static_assert(std::is_same<T, float>::value, "The PFFFT backend only supports single precision");
+#endif
 
         using value_type   = T;
         using complex_type = std::complex<T>;
@@ -63,14 +90,73 @@ namespace edsp { inline namespace spectral {
         /**
          * @brief Creates a FFT engine of the given size
          * @param nfft Number of samples of the FFT
+         * @param policy Policy used to create the plans of the engine.
+         */
+        explicit fft_engine(size_type nfft, const fft_plan_policy& policy = {}) :
+            impl_(nfft, policy),
+            policy_(policy),
+            nfft_(nfft) {}
+
+        /**
+         * @brief Creates a FFT engine of the given size and eagerly prepares the plans of the given transforms.
+         * @param nfft Number of samples of the FFT
+         * @param kinds List of transforms to prepare.
+         * @param policy Policy used to create the plans of the engine.
+         * @see prepare
          */
-        explicit fft_engine(size_type nfft) : impl_(nfft) {}
+        fft_engine(size_type nfft, std::initializer_list<fft_kind> kinds, const fft_plan_policy& policy = {}) :
+            fft_engine(nfft, policy) {
+            for (const auto kind : kinds) {
+                prepare(kind);
+            }
+        }
 
         /**
          * @brief Default destructor
          */
         ~fft_engine() = default;
 
+        /**
+         * @brief Returns the number of samples of the FFT.
+         * @return Size of the engine.
+         */
+        constexpr size_type size() const noexcept {
+            return nfft_;
+        }
+
+        /**
+         * @brief Returns the policy used to create the plans of the engine.
+         * @return Planning policy.
+         */
+        constexpr const fft_plan_policy& policy() const noexcept {
+            return policy_;
+        }
+
+        /**
+         * @brief Creates the plans needed to compute the given transform.
+         *
+         * Every transform has its own plan. By default, the plans are created the first time a transform is
+         * executed, so preparing them in advance guarantees that no planning happens in a real-time thread.
+         *
+         * @note The plans depend on the layout of the buffers. This function prepares the plans for both aligned and
+         * unaligned buffers, either for out-of-place (the default) or in-place transforms.
+         * @param kind Type of transform to prepare.
+         * @param in_place True if the transform will be executed with the same input and output buffer.
+         */
+        inline void prepare(fft_kind kind, bool in_place = false) {
+            impl_.prepare(kind, in_place);
+        }
+
+        /**
+         * @brief Checks if the plans of the given transform have already been created.
+         * @param kind Type of transform.
+         * @param in_place True to check the plans of the in-place transform.
+         * @return true if the transform is prepared, false otherwise.
+         */
+        inline bool prepared(fft_kind kind, bool in_place = false) const {
+            return impl_.prepared(kind, in_place);
+        }
+
         /**
          * @brief Performs a Complex-to-Complex FFT
          * @note The buffer size should be the engine's size.
@@ -141,6 +227,173 @@ namespace edsp { inline namespace spectral {
             impl_.idct(src, dst);
         }
 
+        /**
+         * @brief Creates the plans needed to compute a batch of transforms with the given memory layout.
+         * @param kind Type of transform to prepare.
+         * @param layout Memory layout of the batch.
+         * @param in_place True if the transforms will be executed with the same input and output buffer.
+         * @see prepare
+         */
+        inline void prepare_batch(fft_kind kind, const fft_batch_layout& layout, bool in_place = false) {
+            impl_.prepare_batch(kind, layout, in_place);
+        }
+
+        /**
+         * @brief Performs several Complex-to-Complex FFTs with a single call.
+         *
+         * The i-th transform reads the samples src[i * idist + j * istride] and writes the samples
+         * dst[i * odist + j * ostride]. Computing all the frames of a signal at once lets the backend reuse a single
+         * plan and vectorize across the transforms.
+         * @param src Buffer storing the input samples
+         * @param dst Buffer storing the computed spectral samples.
+         * @param howmany Number of transforms.
+         * @param istride Distance between two consecutive input samples of the same transform.
+         * @param idist Distance between the first input samples of two consecutive transforms.
+         * @param ostride Distance between two consecutive output samples of the same transform.
+         * @param odist Distance between the first output samples of two consecutive transforms.
+         */
+        inline void dft_batch(const complex_type* src, complex_type* dst, size_type howmany, size_type istride,
+                              size_type idist, size_type ostride, size_type odist) {
+            impl_.dft_batch(src, dst, {howmany, istride, idist, ostride, odist});
+        }
+
+        /**
+         * @brief Performs several contiguous Complex-to-Complex FFTs with a single call.
+         * @param src Buffer storing the howmany * size() input samples.
+         * @param dst Buffer storing the howmany * size() computed spectral samples.
+         * @param howmany Number of transforms.
+         */
+        inline void dft_batch(const complex_type* src, complex_type* dst, size_type howmany) {
+            dft_batch(src, dst, howmany, 1, nfft_, 1, nfft_);
+        }
+
+        /**
+         * @brief Performs several Complex-to-Complex IFFTs with a single call.
+         * @param src Buffer storing the computed spectral samples.
+         * @param dst Buffer storing the transformed samples.
+         * @param howmany Number of transforms.
+         * @param istride Distance between two consecutive input samples of the same transform.
+         * @param idist Distance between the first input samples of two consecutive transforms.
+         * @param ostride Distance between two consecutive output samples of the same transform.
+         * @param odist Distance between the first output samples of two consecutive transforms.
+         * @see dft_batch
+         */
+        inline void idft_batch(const complex_type* src, complex_type* dst, size_type howmany, size_type istride,
+                               size_type idist, size_type ostride, size_type odist) {
+            impl_.idft_batch(src, dst, {howmany, istride, idist, ostride, odist});
+        }
+
+        /**
+         * @brief Performs several contiguous Complex-to-Complex IFFTs with a single call.
+         * @param src Buffer storing the howmany * size() spectral samples.
+         * @param dst Buffer storing the howmany * size() transformed samples.
+         * @param howmany Number of transforms.
+         */
+        inline void idft_batch(const complex_type* src, complex_type* dst, size_type howmany) {
+            idft_batch(src, dst, howmany, 1, nfft_, 1, nfft_);
+        }
+
+        /**
+         * @brief Performs several Real-to-Complex-Hermitian FFTs with a single call.
+         *
+         * @note Every transform reads size() real samples and writes size() / 2 + 1 complex samples.
+         * @param src Buffer storing purely real numbers
+         * @param dst Buffer storing the computed spectral samples.
+         * @param howmany Number of transforms.
+         * @param istride Distance between two consecutive input samples of the same transform.
+         * @param idist Distance between the first input samples of two consecutive transforms.
+         * @param ostride Distance between two consecutive output samples of the same transform.
+         * @param odist Distance between the first output samples of two consecutive transforms.
+         * @see dft_batch
+         */
+        inline void dft_batch(const value_type* src, complex_type* dst, size_type howmany, size_type istride,
+                              size_type idist, size_type ostride, size_type odist) {
+            impl_.dft_batch(src, dst, {howmany, istride, idist, ostride, odist});
+        }
+
+        /**
+         * @brief Performs several contiguous Real-to-Complex-Hermitian FFTs with a single call.
+         * @param src Buffer storing the howmany * size() real samples.
+         * @param dst Buffer storing the howmany * (size() / 2 + 1) computed spectral samples.
+         * @param howmany Number of transforms.
+         */
+        inline void dft_batch(const value_type* src, complex_type* dst, size_type howmany) {
+            dft_batch(src, dst, howmany, 1, nfft_, 1, make_fft_size(nfft_));
+        }
+
+        /**
+         * @brief Performs several Complex-Hermitian-to-Real IFFTs with a single call.
+         *
+         * @note Every transform reads size() / 2 + 1 complex samples and writes size() real samples.
+         * @param src Buffer storing the computed spectral samples.
+         * @param dst Buffer storing the transformed samples.
+         * @param howmany Number of transforms.
+         * @param istride Distance between two consecutive input samples of the same transform.
+         * @param idist Distance between the first input samples of two consecutive transforms.
+         * @param ostride Distance between two consecutive output samples of the same transform.
+         * @param odist Distance between the first output samples of two consecutive transforms.
+         * @see dft_batch
+         */
+        inline void idft_batch(const complex_type* src, value_type* dst, size_type howmany, size_type istride,
+                               size_type idist, size_type ostride, size_type odist) {
+            impl_.idft_batch(src, dst, {howmany, istride, idist, ostride, odist});
+        }
+
+        /**
+         * @brief Performs several contiguous Complex-Hermitian-to-Real IFFTs with a single call.
+         * @param src Buffer storing the howmany * (size() / 2 + 1) spectral samples.
+         * @param dst Buffer storing the howmany * size() real samples.
+         * @param howmany Number of transforms.
+         */
+        inline void idft_batch(const complex_type* src, value_type* dst, size_type howmany) {
+            idft_batch(src, dst, howmany, 1, make_fft_size(nfft_), 1, nfft_);
+        }
+
+        /**
+         * @brief Performs several Discrete Hartley Transforms (DHT) with a single call.
+         * @param src Buffer storing the input samples.
+         * @param dst Buffer storing the transformed samples.
+         * @param howmany Number of transforms.
+         * @param stride Distance between two consecutive samples of the same transform.
+         * @param dist Distance between the first samples of two consecutive transforms, size() if zero.
+         * @see dft_batch
+         */
+        inline void dht_batch(const value_type* src, value_type* dst, size_type howmany, size_type stride = 1,
+                              size_type dist = 0) {
+            dist = (dist == 0) ? nfft_ : dist;
+            impl_.dht_batch(src, dst, {howmany, stride, dist, stride, dist});
+        }
+
+        /**
+         * @brief Performs several Discrete Cosine Transforms (DCT) with a single call.
+         * @param src Buffer storing the input samples.
+         * @param dst Buffer storing the transformed samples.
+         * @param howmany Number of transforms.
+         * @param stride Distance between two consecutive samples of the same transform.
+         * @param dist Distance between the first samples of two consecutive transforms, size() if zero.
+         * @see dft_batch
+         */
+        inline void dct_batch(const value_type* src, value_type* dst, size_type howmany, size_type stride = 1,
+                              size_type dist = 0) {
+            dist = (dist == 0) ? nfft_ : dist;
+            impl_.dct_batch(src, dst, {howmany, stride, dist, stride, dist});
+        }
+
+        /**
+         * @brief Performs several Inverse Discrete Cosine Transforms (IDCT) with a single call.
+         * @param src Buffer storing the previously transformed samples.
+         * @param dst Buffer storing the computed samples.
+         * @param howmany Number of transforms.
+         * @param stride Distance between two consecutive samples of the same transform.
+         * @param dist Distance between the first samples of two consecutive transforms, size() if zero.
+         * @see dft_batch
+         */
+        inline void idct_batch(const value_type* src, value_type* dst, size_type howmany, size_type stride = 1,
+                               size_type dist = 0) {
+            dist = (dist == 0) ? nfft_ : dist;
+            impl_.idct_batch(src, dst, {howmany, stride, dist, stride, dist});
+        }
+
         /**
          * @brief Scales the computed IFFT to match the original input
          * @param dst Buffer containing the samples to be scaled
@@ -158,8 +411,74 @@ namespace edsp { inline namespace spectral {
             impl_.idct_scale(dst);
         }
 
+        /**
+         * @brief Scales a batch of computed IFFTs to match the original inputs
+         * @param dst Buffer containing the samples to be scaled
+         * @param howmany Number of transforms.
+         * @param stride Distance between two consecutive samples of the same transform.
+         * @param dist Distance between the first samples of two consecutive transforms, size() if zero.
+         */
+        template <typename R>
+        inline void idft_scale(R* dst, size_type howmany, size_type stride = 1, size_type dist = 0) const {
+            scale_batch(dst, howmany, stride, dist, static_cast<value_type>(nfft_));
+        }
+
+        /**
+         * @brief Scales a batch of computed IDCTs to match the original inputs
+         * @param dst Buffer containing the samples to be scaled
+         * @param howmany Number of transforms.
+         * @param stride Distance between two consecutive samples of the same transform.
+         * @param dist Distance between the first samples of two consecutive transforms, size() if zero.
+         */
+        inline void idct_scale(value_type* dst, size_type howmany, size_type stride = 1, size_type dist = 0) const {
+            scale_batch(dst, howmany, stride, dist, static_cast<value_type>(2 * nfft_));
+        }
+
+        /**
+         * @brief Saves the accumulated planning knowledge (wisdom) of the backend into a file.
+         *
+         * Measuring the plans is expensive. A long-running service can pay that cost once, export the wisdom and
+         * import it at startup to create the optimal plans almost instantly.
+         * @param path Path of the output file.
+         * @return true if the wisdom has been exported, false otherwise or if the backend does not support it.
+         */
+        static bool export_wisdom(const std::string& path) {
+            return internal::fft_impl<T>::export_wisdom(path);
+        }
+
+        /**
+         * @brief Loads the planning knowledge (wisdom) of the backend from a file.
+         *
+         * @note The wisdom is only used by the plans created afterwards, plans already stored in the fft_plan_cache
+         * are not affected.
+         * @param path Path of the input file.
+         * @return true if the wisdom has been imported, false otherwise or if the backend does not support it.
+         */
+        static bool import_wisdom(const std::string& path) {
+            return internal::fft_impl<T>::import_wisdom(path);
+        }
+
+        /**
+         * @brief Discards all the planning knowledge (wisdom) accumulated by the backend.
+         */
+        static void forget_wisdom() {
+            internal::fft_impl<T>::forget_wisdom();
+        }
+
     private:
+        template <typename R>
+        inline void scale_batch(R* dst, size_type howmany, size_type stride, size_type dist, value_type scaling) const {
+            dist = (dist == 0) ? nfft_ : dist;
+            for (size_type i = 0; i < howmany; ++i) {
+                for (size_type j = 0; j < nfft_; ++j) {
+                    dst[i * dist + j * stride] /= scaling;
+                }
+            }
+        }
+
         internal::fft_impl<T> impl_;
+        fft_plan_policy policy_;
+        size_type nfft_;
     };
 
 }} // namespace edsp::spectral
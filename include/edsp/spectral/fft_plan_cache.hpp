@@ -0,0 +1,338 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: fft_plan_cache.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_FFT_PLAN_CACHE_HPP
+#define EDSP_FFT_PLAN_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @brief The fft_kind enum defines the different transforms an FFT plan can compute.
+     */
+    enum class fft_kind {
+        ComplexForward,  /*!< Complex-to-Complex forward transform */
+        ComplexBackward, /*!< Complex-to-Complex backward transform */
+        RealForward,     /*!< Real-to-Complex-Hermitian forward transform */
+        RealBackward,    /*!< Complex-Hermitian-to-Real backward transform */
+        Hartley,         /*!< Discrete Hartley Transform */
+        Cosine,          /*!< Discrete Cosine Transform (DCT-II) */
+        InverseCosine    /*!< Inverse Discrete Cosine Transform (DCT-III) */
+    };
+
+    /**
+     * @brief Number of elements of the fft_kind enum.
+     */
+    constexpr std::size_t fft_kind_count = 7;
+
+    /**
+     * @brief The fft_rigor enum defines how much effort is spent looking for the fastest plan.
+     */
+    enum class fft_rigor {
+        Estimate,  /*!< Uses a simple heuristic to pick a plan, no measurements are performed */
+        Measure,   /*!< Measures the execution time of several candidate plans */
+        Patient,   /*!< Like Measure, but considers a wider range of algorithms */
+        Exhaustive /*!< Like Patient, but considers an even wider range of algorithms */
+    };
+
+    /**
+     * @brief The fft_plan_policy struct defines how the plans of an FFT engine are created.
+     */
+    struct fft_plan_policy {
+        fft_rigor rigor{fft_rigor::Estimate}; /*!< Planning rigor */
+        double time_limit{-1};                /*!< Maximum planning time in seconds, a negative value means no limit */
+    };
+
+    /**
+     * @brief The fft_batch_layout struct describes how several transforms of the same size are stored in memory.
+     *
+     * The strides and distances are expressed in number of elements of the input and output types.
+     */
+    struct fft_batch_layout {
+        std::size_t howmany{1}; /*!< Number of transforms */
+        std::size_t istride{1}; /*!< Distance between two consecutive samples of the same input transform */
+        std::size_t idist{0};   /*!< Distance between the first samples of two consecutive input transforms */
+        std::size_t ostride{1}; /*!< Distance between two consecutive samples of the same output transform */
+        std::size_t odist{0};   /*!< Distance between the first samples of two consecutive output transforms */
+
+        bool operator==(const fft_batch_layout& other) const noexcept {
+            return howmany == other.howmany && istride == other.istride && idist == other.idist &&
+                   ostride == other.ostride && odist == other.odist;
+        }
+
+        bool operator!=(const fft_batch_layout& other) const noexcept {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * @brief The fft_plan_key struct identifies a plan stored in the fft_plan_cache.
+     */
+    struct fft_plan_key {
+        std::size_t size;          /*!< Number of samples of the transform */
+        std::type_index precision; /*!< Floating point type of the transform */
+        fft_kind kind;             /*!< Type of transform */
+        fft_rigor rigor;           /*!< Rigor used to create the plan */
+        bool aligned;              /*!< True if the plan requires SIMD-aligned buffers */
+        bool in_place;             /*!< True if the plan is executed with the same input and output buffer */
+        fft_batch_layout layout{}; /*!< Memory layout of the transforms, a single contiguous transform by default */
+
+        bool operator==(const fft_plan_key& other) const noexcept {
+            return size == other.size && precision == other.precision && kind == other.kind &&
+                   rigor == other.rigor && aligned == other.aligned && in_place == other.in_place &&
+                   layout == other.layout;
+        }
+    };
+
+    /**
+     * @brief Hash function of the fft_plan_key struct.
+     */
+    struct fft_plan_key_hash {
+        std::size_t operator()(const fft_plan_key& key) const noexcept {
+            std::size_t seed = std::hash<std::size_t>{}(key.size);
+            seed ^= key.precision.hash_code() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= static_cast<std::size_t>(key.kind) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= static_cast<std::size_t>(key.rigor) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= (static_cast<std::size_t>(key.aligned) << 1 | static_cast<std::size_t>(key.in_place)) +
+                    0x9e3779b9 + (seed << 6) + (seed >> 2);
+            for (const auto value : {key.layout.howmany, key.layout.istride, key.layout.idist, key.layout.ostride,
+                                     key.layout.odist}) {
+                seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            }
+            return seed;
+        }
+    };
+
+    /**
+     * @brief The fft_plan_cache_stats struct stores the usage counters of the fft_plan_cache.
+     */
+    struct fft_plan_cache_stats {
+        std::size_t hits;      /*!< Number of requests served with an existing plan */
+        std::size_t misses;    /*!< Number of requests that required the creation of a new plan */
+        std::size_t evictions; /*!< Number of plans removed to keep the cache under its capacity */
+        std::size_t size;      /*!< Number of plans currently stored */
+        std::size_t capacity;  /*!< Maximum number of plans stored */
+    };
+
+    /**
+     * @brief This class implements a process-wide, thread-safe registry of FFT plans.
+     *
+     * Creating a plan is usually much more expensive than executing it. The FFT backends request their plans from
+     * this cache, so every %fft_engine with the same configuration shares the same plan, no matter if it has been
+     * created by the user or internally by one of the spectral functions.
+     *
+     * The number of stored plans is bounded: when the capacity is exceeded the least recently used plan is evicted.
+     * The plans are reference counted, evicting a plan never invalidates an engine that is still using it.
+     */
+    class fft_plan_cache {
+    public:
+        using size_type   = std::size_t;
+        using plan_handle = std::shared_ptr<void>;
+
+        /**
+         * @brief Default maximum number of stored plans.
+         */
+        static constexpr size_type default_capacity = 64;
+
+        /**
+         * @brief Returns the process-wide instance of the cache.
+         *
+         * @note The instance is never destroyed, so the engines with static storage duration are still able to
+         * release their plans during the shutdown of the process.
+         * @return Reference to the global cache.
+         */
+        static fft_plan_cache& instance() {
+            static auto* cache = new fft_plan_cache();
+            return *cache;
+        }
+
+        fft_plan_cache(const fft_plan_cache&) = delete;
+        fft_plan_cache& operator=(const fft_plan_cache&) = delete;
+
+        /**
+         * @brief Returns the plan identified by the given key, creating it if it does not exist.
+         *
+         * The factory is called without holding the lock of the cache: creating a plan with a high rigor may take
+         * minutes, and it never blocks the requests of the plans already stored. A placeholder is published before
+         * the creation, so the concurrent requests of the same key wait for that plan instead of creating another.
+         * If the factory throws, the placeholder is removed and the exception is propagated to all the waiting
+         * requests.
+         * @param key Key identifying the plan.
+         * @param factory Callable creating the plan if it is not stored in the cache.
+         * @return Handle to the requested plan.
+         */
+        template <typename Factory>
+        plan_handle acquire(const fft_plan_key& key, Factory&& factory) {
+            std::promise<plan_handle> promise;
+            std::shared_future<plan_handle> plan;
+            size_type id = 0;
+            list_type evicted;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                const auto it = index_.find(key);
+                if (it != std::end(index_)) {
+                    ++hits_;
+                    entries_.splice(std::begin(entries_), entries_, it->second);
+                    plan = it->second->plan;
+                } else {
+                    ++misses_;
+                    id   = ++last_id_;
+                    plan = promise.get_future().share();
+                    entries_.push_front(entry_type{key, plan, id});
+                    index_.emplace(key, std::begin(entries_));
+                    shrink(capacity_, evicted);
+                }
+            }
+            evicted.clear();
+
+            if (id != 0) {
+                try {
+                    promise.set_value(factory());
+                } catch (...) {
+                    promise.set_exception(std::current_exception());
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    const auto it = index_.find(key);
+                    if (it != std::end(index_) && it->second->id == id) {
+                        entries_.erase(it->second);
+                        index_.erase(it);
+                    }
+                }
+            }
+            return plan.get();
+        }
+
+        /**
+         * @brief Returns the maximum number of plans stored in the cache.
+         * @return Capacity of the cache.
+         */
+        size_type capacity() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return capacity_;
+        }
+
+        /**
+         * @brief Updates the maximum number of plans stored in the cache.
+         *
+         * If needed, the least recently used plans are evicted.
+         * @param capacity New capacity of the cache.
+         */
+        void set_capacity(size_type capacity) {
+            list_type evicted;
+            std::lock_guard<std::mutex> lock(mutex_);
+            capacity_ = capacity;
+            shrink(capacity_, evicted);
+        }
+
+        /**
+         * @brief Returns the number of plans stored in the cache.
+         * @return Number of stored plans.
+         */
+        size_type size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entries_.size();
+        }
+
+        /**
+         * @brief Removes all the stored plans.
+         */
+        void clear() {
+            list_type evicted;
+            std::lock_guard<std::mutex> lock(mutex_);
+            index_.clear();
+            evicted.swap(entries_);
+        }
+
+        /**
+         * @brief Returns the usage counters of the cache.
+         * @return Current statistics.
+         */
+        fft_plan_cache_stats stats() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return {hits_, misses_, evictions_, entries_.size(), capacity_};
+        }
+
+        /**
+         * @brief Resets the hits, misses and evictions counters.
+         */
+        void reset_stats() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            hits_      = 0;
+            misses_    = 0;
+            evictions_ = 0;
+        }
+
+        /**
+         * @brief Returns the mutex serializing the calls to the planner of the FFT backend.
+         *
+         * Some backends, as FFTW, only allow to execute plans concurrently: creating and destroying a plan must be
+         * done by one thread at a time.
+         * @return Reference to the planner mutex.
+         */
+        std::mutex& planner_mutex() noexcept {
+            return planner_mutex_;
+        }
+
+    private:
+        // The plans are stored as futures, so a plan being created is already visible to the other requests.
+        struct entry_type {
+            fft_plan_key key;
+            std::shared_future<plan_handle> plan;
+            size_type id;
+        };
+        using list_type = std::list<entry_type>;
+
+        fft_plan_cache() = default;
+
+        // The evicted plans are moved to the given list, so they are destroyed once the lock has been released:
+        // destroying a plan may wait for the planner of the backend.
+        void shrink(size_type capacity, list_type& evicted) {
+            while (entries_.size() > capacity) {
+                index_.erase(entries_.back().key);
+                evicted.splice(std::begin(evicted), entries_, std::prev(std::end(entries_)));
+                ++evictions_;
+            }
+        }
+
+        std::mutex planner_mutex_;
+        mutable std::mutex mutex_;
+        list_type entries_;
+        std::unordered_map<fft_plan_key, list_type::iterator, fft_plan_key_hash> index_;
+        size_type capacity_{default_capacity};
+        size_type hits_{0};
+        size_type misses_{0};
+        size_type evictions_{0};
+        size_type last_id_{0};
+    };
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_FFT_PLAN_CACHE_HPP
@@ -0,0 +1,305 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: goertzel_bank.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_GOERTZEL_BANK_HPP
+#define EDSP_GOERTZEL_BANK_HPP
+
+#include <edsp/types/ring_buffer.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @class goertzel_bank
+     * @brief This class implements a bank of sliding Goertzel filters, tracking the DFT of the last N samples at a
+     * set of frequencies.
+     *
+     * Every frequency is tracked by a second order real resonator fed with the difference x[n] - x[n - N]:
+     *
+     * \f[
+     *  s_k[n] = x[n] - x[n - N] + 2 \cos(\omega_k) s_k[n - 1] - s_k[n - 2]
+     * \f]
+     *
+     * The updates use real arithmetic only. The complex value of the bin, \f$ e^{j \omega_k} s_k[n] - s_k[n - 1] \f$,
+     * is only computed when it is read, and the power of the bin can be computed with real arithmetic only.
+     *
+     * The frequencies are rounded to the nearest DFT bin, so the resolution is sample_rate / N Hz. The resonators
+     * have their poles on the unit circle (a double pole for the DC and Nyquist bins), so their rounding errors are
+     * never forgotten. A second resonator per frequency is therefore fed with x[n] alone, from a zero state, and
+     * replaces the first one every N samples: after N samples it holds the same bin computed from the samples of the
+     * window only. The error never accumulates over more than two windows, for a bounded cost of two resonators per
+     * frequency and update.
+     *
+     * A damping factor r < 1 moves the poles inside the circle: the bins then compute the DFT of the window weighted
+     * by r^age, where age is the number of samples since the sample arrived.
+     *
+     * The states are stored in contiguous arrays, so the update loop is vectorized across the frequencies by the
+     * compiler. The result of %magnitude can be used as input of the spectral feature extractors.
+     *
+     * @tparam T Floating point type.
+     * @tparam Allocator Allocator type of the window, defaults to std::allocator<T>.
+     */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class goertzel_bank {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %goertzel_bank tracking the frequencies in the range [first, last).
+         * @param first Input iterator defining the beginning of the range of frequencies in Hz.
+         * @param last Input iterator defining the ending of the range of frequencies in Hz.
+         * @param sample_rate Sampling frequency in Hz.
+         * @param size Number of samples of the sliding window.
+         * @param damping Damping factor of the resonators, in the range (0, 1].
+         */
+        template <typename InputIt>
+        goertzel_bank(InputIt first, InputIt last, value_type sample_rate, size_type size,
+                      value_type damping = static_cast<value_type>(1));
+
+        /**
+         * @brief Returns the number of samples of the sliding window.
+         * @return Size of the window.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Returns the number of tracked frequencies.
+         * @return Number of bins.
+         */
+        size_type bins() const noexcept;
+
+        /**
+         * @brief Returns the frequency of the i-th bin, after rounding it to the nearest DFT bin.
+         * @param i Position of the bin.
+         * @return Frequency in Hz.
+         */
+        value_type frequency(size_type i) const;
+
+        /**
+         * @brief Resets the window and the resonators.
+         */
+        void reset();
+
+        /**
+         * @brief Updates the resonators with a new sample.
+         * @param tick Input sample.
+         */
+        void update(value_type tick);
+
+        /**
+         * @brief Updates the resonators with the samples in the range [first, last).
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         */
+        template <typename InputIt>
+        void update(InputIt first, InputIt last);
+
+        /**
+         * @brief Returns the current value of the i-th bin.
+         * @param i Position of the bin.
+         * @return DFT of the last size() samples at the frequency of the bin.
+         */
+        complex_type operator[](size_type i) const;
+
+        /**
+         * @brief Stores the current value of the bins in the range beginning at d_first.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename OutputIt>
+        OutputIt spectrum(OutputIt d_first) const;
+
+        /**
+         * @brief Stores the magnitude of the bins in the range beginning at d_first.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename OutputIt>
+        OutputIt magnitude(OutputIt d_first) const;
+
+        /**
+         * @brief Stores the power (squared magnitude) of the bins in the range beginning at d_first.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename OutputIt>
+        OutputIt power(OutputIt d_first) const;
+
+    private:
+        value_type bin_power(size_type i) const;
+
+        edsp::ring_buffer<T, Allocator> window_;
+        std::vector<value_type> frequencies_;
+        std::vector<value_type> cosine_;
+        std::vector<value_type> sine_;
+        std::vector<value_type> coefficients_;
+        std::vector<value_type> state1_;
+        std::vector<value_type> state2_;
+        std::vector<value_type> shadow1_;
+        std::vector<value_type> shadow2_;
+        value_type damping_;
+        value_type comb_;
+        size_type elapsed_{0};
+    };
+
+    template <typename T, typename Allocator>
+    template <typename InputIt>
+    goertzel_bank<T, Allocator>::goertzel_bank(InputIt first, InputIt last, value_type sample_rate, size_type size,
+                                               value_type damping) :
+        window_(size, T()),
+        frequencies_(first, last),
+        cosine_(frequencies_.size()),
+        sine_(frequencies_.size()),
+        coefficients_(frequencies_.size()),
+        state1_(frequencies_.size(), 0),
+        state2_(frequencies_.size(), 0),
+        shadow1_(frequencies_.size(), 0),
+        shadow2_(frequencies_.size(), 0),
+        damping_(damping),
+        comb_(static_cast<value_type>(std::pow(damping, static_cast<value_type>(size)))) {
+        meta::expects(size > 0, "The size of the window should be greater than zero");
+        meta::expects(sample_rate > 0, "The sample rate should be greater than zero");
+        meta::expects(damping > 0 && damping <= 1, "The damping factor should be in the range (0, 1]");
+        for (size_type i = 0; i < frequencies_.size(); ++i) {
+            const auto bin   = std::round(static_cast<long double>(frequencies_[i]) * size / sample_rate);
+            const auto angle = 2 * 3.141592653589793238462643383279502884L * bin / static_cast<long double>(size);
+            frequencies_[i]  = static_cast<value_type>(bin * sample_rate / size);
+            cosine_[i]       = static_cast<value_type>(std::cos(angle));
+            sine_[i]         = static_cast<value_type>(std::sin(angle));
+            coefficients_[i] = 2 * damping * cosine_[i];
+        }
+    }
+
+    template <typename T, typename Allocator>
+    typename goertzel_bank<T, Allocator>::size_type goertzel_bank<T, Allocator>::size() const noexcept {
+        return window_.capacity();
+    }
+
+    template <typename T, typename Allocator>
+    typename goertzel_bank<T, Allocator>::size_type goertzel_bank<T, Allocator>::bins() const noexcept {
+        return frequencies_.size();
+    }
+
+    template <typename T, typename Allocator>
+    typename goertzel_bank<T, Allocator>::value_type goertzel_bank<T, Allocator>::frequency(size_type i) const {
+        return frequencies_[i];
+    }
+
+    template <typename T, typename Allocator>
+    void goertzel_bank<T, Allocator>::reset() {
+        std::fill(std::begin(window_), std::end(window_), T());
+        std::fill(std::begin(state1_), std::end(state1_), 0);
+        std::fill(std::begin(state2_), std::end(state2_), 0);
+        std::fill(std::begin(shadow1_), std::end(shadow1_), 0);
+        std::fill(std::begin(shadow2_), std::end(shadow2_), 0);
+        elapsed_ = 0;
+    }
+
+    template <typename T, typename Allocator>
+    void goertzel_bank<T, Allocator>::update(value_type tick) {
+        const auto input = tick - comb_ * window_.front();
+        window_.push_back(tick);
+
+        const auto count        = frequencies_.size();
+        const auto squared      = damping_ * damping_;
+        const auto* coefficient = coefficients_.data();
+        auto* state1            = state1_.data();
+        auto* state2            = state2_.data();
+        auto* shadow1           = shadow1_.data();
+        auto* shadow2           = shadow2_.data();
+        for (size_type i = 0; i < count; ++i) {
+            const auto state  = input + coefficient[i] * state1[i] - squared * state2[i];
+            const auto shadow = tick + coefficient[i] * shadow1[i] - squared * shadow2[i];
+            state2[i]         = state1[i];
+            state1[i]         = state;
+            shadow2[i]        = shadow1[i];
+            shadow1[i]        = shadow;
+        }
+
+        // After N samples, the shadow resonators compute the same bins from the samples of the window only.
+        if (++elapsed_ == window_.capacity()) {
+            state1_.swap(shadow1_);
+            state2_.swap(shadow2_);
+            std::fill(std::begin(shadow1_), std::end(shadow1_), 0);
+            std::fill(std::begin(shadow2_), std::end(shadow2_), 0);
+            elapsed_ = 0;
+        }
+    }
+
+    template <typename T, typename Allocator>
+    template <typename InputIt>
+    void goertzel_bank<T, Allocator>::update(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            update(*first);
+        }
+    }
+
+    template <typename T, typename Allocator>
+    typename goertzel_bank<T, Allocator>::complex_type goertzel_bank<T, Allocator>::operator[](size_type i) const {
+        return {cosine_[i] * state1_[i] - damping_ * state2_[i], sine_[i] * state1_[i]};
+    }
+
+    template <typename T, typename Allocator>
+    template <typename OutputIt>
+    OutputIt goertzel_bank<T, Allocator>::spectrum(OutputIt d_first) const {
+        for (size_type i = 0; i < frequencies_.size(); ++i, ++d_first) {
+            *d_first = (*this)[i];
+        }
+        return d_first;
+    }
+
+    template <typename T, typename Allocator>
+    template <typename OutputIt>
+    OutputIt goertzel_bank<T, Allocator>::magnitude(OutputIt d_first) const {
+        for (size_type i = 0; i < frequencies_.size(); ++i, ++d_first) {
+            *d_first = std::sqrt(bin_power(i));
+        }
+        return d_first;
+    }
+
+    template <typename T, typename Allocator>
+    template <typename OutputIt>
+    OutputIt goertzel_bank<T, Allocator>::power(OutputIt d_first) const {
+        for (size_type i = 0; i < frequencies_.size(); ++i, ++d_first) {
+            *d_first = bin_power(i);
+        }
+        return d_first;
+    }
+
+    template <typename T, typename Allocator>
+    typename goertzel_bank<T, Allocator>::value_type goertzel_bank<T, Allocator>::bin_power(size_type i) const {
+        // |e^{jw} s1 - r s2|^2 = s1^2 + r^2 s2^2 - 2 r cos(w) s1 s2
+        const auto s1 = state1_[i];
+        const auto s2 = state2_[i];
+        return std::max(s1 * s1 + damping_ * damping_ * s2 * s2 - coefficients_[i] * s1 * s2,
+                        static_cast<value_type>(0));
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_GOERTZEL_BANK_HPP
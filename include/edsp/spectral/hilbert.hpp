@@ -23,12 +23,70 @@
 #define EDSP_HILBERT_HPP
 
 #include <edsp/spectral/fft_engine.hpp>
+#include <edsp/spectral/spectral_workspace.hpp>
 #include <edsp/converter/real2complex.hpp>
 #include <edsp/math/numeric.hpp>
 #include <vector>
 
 namespace edsp { inline namespace spectral {
 
+    namespace internal {
+
+        // The buffers hold at least N complex samples.
+        template <typename InputIt, typename OutputIt, typename T, typename CBuffer>
+        inline void hilbert(InputIt first, InputIt last, OutputIt d_first, fft_engine<T>& engine,
+                            CBuffer& input_data, CBuffer& complex_data) {
+            const auto nfft = static_cast<std::size_t>(std::distance(first, last));
+            edsp::real2complex(first, last, std::begin(input_data));
+
+            engine.dft(meta::data(input_data), meta::data(complex_data));
+
+            const auto limit_1 = math::is_even(nfft) ? nfft / 2 : (nfft + 1) / 2;
+            const auto limit_2 = math::is_even(nfft) ? limit_1 + 1 : limit_1;
+            for (auto i = 1ul; i < limit_1; ++i) {
+                complex_data[i] *= 2;
+            }
+
+            for (auto i = limit_2; i < nfft; ++i) {
+                complex_data[i] = std::complex<T>(0, 0);
+            }
+
+            engine.idft(meta::data(complex_data), &(*d_first));
+            engine.idft_scale(&(*d_first));
+        }
+
+    } // namespace internal
+
+    /**
+     * @brief Computes the Discrete-Time analytic signal using Hilbert transform of the range [first, last)
+     * and stores the result in another range, beginning at d_first.
+     *
+     * The Discrete-time analytic is the complex helical sequence obtained from a real data sequence.
+     * The analytic signal \f$ A_k = A_r + iA_i \f$ has a real part, \f$ A_r \f$, which is the original data,
+     * and an imaginary part, \f$ A_i \f$, which contains the Hilbert transform. The imaginary part is a version of the original real sequence with a 90° phase shift.
+     *
+     * The Hilbert transform is computed as follows:
+     * \f[
+     * {\displaystyle {\widehat {s}}(t)={\mathcal {H}}\{s\}(t)=(h*s)(t)={\frac {1}{\pi }}\int _{-\infty }^{\infty }{\frac {s(\tau )}{t-\tau }}\,d\tau .\,}
+     * \f]
+     *
+     * This overload does not allocate any memory: all the temporary buffers are taken from the workspace.
+     *
+     * @param first Input iterator defining the beginning of the input range.
+     * @param last Input iterator defining the ending of the input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param workspace Workspace created for inputs of std::distance(first, last) samples.
+     * @see complex_idft
+     */
+    template <typename InputIt, typename OutputIt, typename T, typename RAllocator, typename CAllocator>
+    inline void hilbert(InputIt first, InputIt last, OutputIt d_first,
+                        spectral_workspace<T, RAllocator, CAllocator>& workspace) {
+        const auto nfft = static_cast<std::size_t>(std::distance(first, last));
+        meta::expects(nfft > 0, "Not expecting empty input");
+        meta::expects(nfft == workspace.size(), "The workspace size does not match the input");
+        internal::hilbert(first, last, d_first, workspace.engine(), workspace.complex1(), workspace.complex2());
+    }
+
     /**
      * @brief Computes the Discrete-Time analytic signal using Hilbert transform of the range [first, last)
      * and stores the result in another range, beginning at d_first.
@@ -52,28 +110,11 @@ namespace edsp { inline namespace spectral {
     inline void hilbert(InputIt first, InputIt last, OutputIt d_first) {
         // TODO: add the static assertion, the input should be a complex array
         using value_type = meta::value_type_t<InputIt>;
-        const auto nfft  = static_cast<typename fft_engine<value_type>::size_type>(std::distance(first, last));
-
+        const auto nfft  = static_cast<std::size_t>(std::distance(first, last));
+        fft_engine<value_type> engine(nfft);
         std::vector<std::complex<value_type>, Allocator> input_data(nfft);
         std::vector<std::complex<value_type>, Allocator> complex_data(nfft);
-        edsp::real2complex(first, last, std::begin(input_data));
-
-        fft_engine<value_type> fft(nfft);
-        fft.dft(meta::data(input_data), meta::data(complex_data));
-
-        const auto limit_1 = math::is_even(nfft) ? nfft / 2 : (nfft + 1) / 2;
-        const auto limit_2 = math::is_even(nfft) ? limit_1 + 1 : limit_1;
-        for (auto i = 1ul; i < limit_1; ++i) {
-            complex_data[i] *= 2;
-        }
-
-        for (auto i = limit_2; i < nfft; ++i) {
-            complex_data[i] = std::complex<value_type>(0, 0);
-        }
-
-        fft_engine<value_type> ifft(nfft);
-        ifft.idft(meta::data(complex_data), &(*d_first));
-        ifft.idft_scale(&(*d_first));
+        internal::hilbert(first, last, d_first, engine, input_data, complex_data);
     }
 
 }} // namespace edsp::spectral
@@ -0,0 +1,149 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: hilbert_engine.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_HILBERT_ENGINE_HPP
+#define EDSP_HILBERT_ENGINE_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @class hilbert_engine
+     * @brief This class computes the analytic signal of real frames of a fixed size.
+     *
+     * The analytic signal \f$ x_a = x + j \mathcal{H}\{x\} \f$ has the same spectrum as the real signal at the
+     * positive frequencies, doubled, and no negative frequencies. The spectrum of a real signal is Hermitian, so the
+     * positive frequencies are computed with a Real-to-Complex transform, half the cost of the complex transform of
+     * the whole frame, and the analytic signal with a single Complex-to-Complex inverse transform.
+     *
+     * The plans and buffers are created once, during the construction, and reused by every frame.
+     *
+     * @tparam T Floating point type.
+     * @see filter::hilbert_filter
+     */
+    template <typename T>
+    class hilbert_engine {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %hilbert_engine for frames of the given size.
+         * @param size Number of samples of every frame.
+         */
+        explicit hilbert_engine(size_type size);
+
+        /**
+         * @brief Returns the number of samples of every frame.
+         * @return Frame size.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Computes the analytic signal of a frame of size() samples, beginning at first, and stores it in
+         * another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the frame.
+         * @param d_first Output iterator defining the beginning of the destination range, it stores size() complex
+         * numbers.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt compute(InputIt first, OutputIt d_first);
+
+        /**
+         * @brief Computes the envelope, the magnitude of the analytic signal, of a frame of size() samples,
+         * beginning at first, and stores it in another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the frame.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt envelope(InputIt first, OutputIt d_first);
+
+    private:
+        void analytic();
+
+        fft_engine<T> engine_;
+        std::vector<value_type> input_;
+        std::vector<complex_type> spectrum_;
+        std::vector<complex_type> output_;
+    };
+
+    template <typename T>
+    hilbert_engine<T>::hilbert_engine(size_type size) :
+        engine_(size, {fft_kind::RealForward, fft_kind::ComplexBackward}),
+        input_(size),
+        spectrum_(size),
+        output_(size) {
+        meta::expects(size > 0, "The frame size should be greater than zero");
+    }
+
+    template <typename T>
+    typename hilbert_engine<T>::size_type hilbert_engine<T>::size() const noexcept {
+        return input_.size();
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt hilbert_engine<T>::compute(InputIt first, OutputIt d_first) {
+        std::copy_n(first, input_.size(), std::begin(input_));
+        analytic();
+        return std::copy(std::cbegin(output_), std::cend(output_), d_first);
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt hilbert_engine<T>::envelope(InputIt first, OutputIt d_first) {
+        std::copy_n(first, input_.size(), std::begin(input_));
+        analytic();
+        return std::transform(std::cbegin(output_), std::cend(output_), d_first,
+                              [](const complex_type& value) { return std::hypot(value.real(), value.imag()); });
+    }
+
+    template <typename T>
+    void hilbert_engine<T>::analytic() {
+        // The r2c transform fills the first N / 2 + 1 bins, the negative frequencies are set to zero.
+        const auto size = input_.size();
+        const auto half = make_fft_size(size);
+        engine_.dft(input_.data(), spectrum_.data());
+        std::fill(std::begin(spectrum_) + half, std::end(spectrum_), complex_type{});
+
+        // DC and Nyquist are kept, the rest of the positive frequencies are doubled. The 1 / N scaling is folded in.
+        const auto scaling = 1 / static_cast<value_type>(size);
+        const auto nyquist = (size % 2 == 0) ? half - 1 : half;
+        for (size_type k = 0; k < half; ++k) {
+            const auto gain = (k == 0 || k == nyquist) ? scaling : 2 * scaling;
+            spectrum_[k] *= gain;
+        }
+        engine_.idft(spectrum_.data(), output_.data());
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_HILBERT_ENGINE_HPP
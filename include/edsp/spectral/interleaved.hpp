@@ -0,0 +1,151 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: interleaved.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_INTERLEAVED_HPP
+#define EDSP_INTERLEAVED_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/types/strided_iterator.hpp>
+#include <edsp/meta/expects.hpp>
+#include <edsp/meta/iterator.hpp>
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+/**
+ * The functions in this file process the channels of an interleaved buffer, such as the one returned by
+ * decoder::read, where the sample n of the channel c is stored at the position n * channels + c. All the channels
+ * are transformed with a single batched plan that reads the samples with a stride of channels elements, so no
+ * channel is de-interleaved into a temporary buffer. The results are interleaved too: the value k of the channel c
+ * is stored at the position k * channels + c.
+ *
+ * The iterators should refer to contiguous memory. The streaming transforms and the feature extractors take any
+ * random access iterator, so a channel can be passed to them with make_channel_iterator.
+ */
+namespace edsp { inline namespace spectral {
+
+    namespace internal {
+
+        template <typename InputIt>
+        inline std::size_t interleaved_frames(InputIt first, InputIt last, std::size_t channels) {
+            meta::expects(channels > 0, "The number of channels should be greater than zero");
+            const auto size = static_cast<std::size_t>(std::distance(first, last));
+            meta::expects(size > 0 && size % channels == 0, "The input should store the same samples per channel");
+            return size / channels;
+        }
+
+    } // namespace internal
+
+    /**
+     * @brief Computes the DFT of every channel of the interleaved range [first, last) and stores the result in another
+     * range, beginning at d_first.
+     *
+     * The output stores N / 2 + 1 interleaved complex bins per channel, where N is the number of frames of the input.
+     *
+     * @param first Input iterator defining the beginning of the interleaved input range.
+     * @param last Input iterator defining the ending of the interleaved input range.
+     * @param channels Number of channels of the input.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     */
+    template <typename InputIt, typename OutputIt>
+    inline void interleaved_dft(InputIt first, InputIt last, std::size_t channels, OutputIt d_first) {
+        using value_type  = meta::value_type_t<InputIt>;
+        const auto frames = internal::interleaved_frames(first, last, channels);
+        fft_engine<value_type> plan(frames);
+        plan.dft_batch(&(*first), &(*d_first), channels, channels, 1, channels, 1);
+    }
+
+    /**
+     * @brief Computes the spectrum of every channel of the interleaved range [first, last) and stores the result in
+     * another range, beginning at d_first.
+     *
+     * The output stores N / 2 + 1 interleaved bins per channel, where N is the number of frames of the input.
+     *
+     * @param first Input iterator defining the beginning of the interleaved input range.
+     * @param last Input iterator defining the ending of the interleaved input range.
+     * @param channels Number of channels of the input.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @see spectrum
+     */
+    template <typename InputIt, typename OutputIt>
+    inline void interleaved_spectrum(InputIt first, InputIt last, std::size_t channels, OutputIt d_first) {
+        using value_type  = meta::value_type_t<InputIt>;
+        const auto frames = internal::interleaved_frames(first, last, channels);
+        fft_engine<value_type> plan(frames);
+        std::vector<std::complex<value_type>> fft_data(make_fft_size(frames) * channels);
+        plan.dft_batch(&(*first), fft_data.data(), channels, channels, 1, channels, 1);
+        std::transform(std::cbegin(fft_data), std::cend(fft_data), d_first, [](const std::complex<value_type>& bin) {
+            return bin.real() * bin.real() + bin.imag() * bin.imag();
+        });
+    }
+
+    /**
+     * @brief Computes the convolution of every channel of the interleaved range [first1, last1) with the same channel
+     * of the interleaved range beginning at first2, and stores the result in another range, beginning at d_first.
+     *
+     * Both inputs store the same number of channels and frames. The output stores the first N interleaved samples of
+     * every convolution, where N is the number of frames of the inputs, as conv does for a single channel.
+     *
+     * @param first1 Input iterator defining the beginning of the first interleaved input range.
+     * @param last1 Input iterator defining the ending of the first interleaved input range.
+     * @param first2 Input iterator defining the beginning of the second interleaved input range.
+     * @param channels Number of channels of the inputs.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @see conv
+     */
+    template <typename InputIt, typename OutputIt>
+    inline void interleaved_conv(InputIt first1, InputIt last1, InputIt first2, std::size_t channels,
+                                 OutputIt d_first) {
+        using value_type   = meta::value_type_t<InputIt>;
+        using complex_type = std::complex<value_type>;
+        const auto frames  = internal::interleaved_frames(first1, last1, channels);
+        const auto samples = frames * channels;
+        const auto nfft    = 2 * frames;
+        const auto bins    = make_fft_size(nfft) * channels;
+
+        // The zero-padding keeps the interleaved layout, so the inputs are copied as a single contiguous block.
+        std::vector<value_type> input1(nfft * channels, 0), input2(nfft * channels, 0);
+        std::copy(first1, last1, std::begin(input1));
+        std::copy_n(first2, samples, std::begin(input2));
+
+        fft_engine<value_type> plan(nfft);
+        std::vector<complex_type> fft_data1(bins), fft_data2(bins);
+        plan.dft_batch(input1.data(), fft_data1.data(), channels, channels, 1, channels, 1);
+        plan.dft_batch(input2.data(), fft_data2.data(), channels, channels, 1, channels, 1);
+
+        // The 1 / N scaling of the inverse transform is folded into the product.
+        const auto scaling = 1 / static_cast<value_type>(nfft);
+        auto* x            = fft_data1.data();
+        const auto* y      = fft_data2.data();
+        for (std::size_t k = 0; k < bins; ++k) {
+            const auto real = x[k].real() * y[k].real() - x[k].imag() * y[k].imag();
+            const auto imag = x[k].real() * y[k].imag() + x[k].imag() * y[k].real();
+            x[k]            = complex_type(real * scaling, imag * scaling);
+        }
+
+        plan.idft_batch(fft_data1.data(), input1.data(), channels, channels, 1, channels, 1);
+        std::copy_n(std::cbegin(input1), samples, d_first);
+    }
+
+}} // namespace edsp::spectral
+
+#endif // EDSP_INTERLEAVED_HPP
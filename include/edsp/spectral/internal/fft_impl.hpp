@@ -27,6 +27,8 @@
 #    include <edsp/spectral/internal/libfftw_impl.hpp>
 #elif defined(USE_LIBPFFFT)
 #    include <edsp/spectral/internal/libpffft_impl.hpp>
+#elif !defined(USE_LIBACCELERATE)
+#    include <edsp/spectral/internal/native_fft_impl.hpp>
 #endif
 
 namespace edsp { inline namespace spectral { namespace internal {
@@ -40,7 +42,8 @@ namespace edsp { inline namespace spectral { namespace internal {
 #elif defined(USE_LIBACCELERATE)
 #    error "Not implemented yet"
 #else
-#    error "Library not found"
+    template <typename T>
+    using fft_impl = spectral::native_fft_impl<T>;
 #endif
 
 }}} // namespace edsp::spectral::internal
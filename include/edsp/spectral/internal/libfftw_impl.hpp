@@ -23,13 +23,18 @@
 #ifndef EDSP_FFTW_IMPL_HPP
 #define EDSP_FFTW_IMPL_HPP
 
+#include <edsp/spectral/fft_plan_cache.hpp>
 #include <edsp/meta/is_null.hpp>
 #include <edsp/meta/advance.hpp>
 #include <edsp/meta/iterator.hpp>
 #include <edsp/meta/expects.hpp>
 #include <edsp/meta/data.hpp>
 
+#include <array>
 #include <complex>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <fftw3.h>
 #include <algorithm>
 
@@ -47,78 +52,375 @@ namespace edsp { inline namespace spectral {
         inline fftw_complex* fftw_cast(const std::complex<double>* p) {
             return const_cast<fftw_complex*>(reinterpret_cast<const fftw_complex*>(p));
         }
+
+        inline fftwl_complex* fftw_cast(const std::complex<long double>* p) {
+            return const_cast<fftwl_complex*>(reinterpret_cast<const fftwl_complex*>(p));
+        }
+
+        template <typename T>
+        struct fftw_traits {
+            static_assert(!std::is_same<T, float>::value,
+                          "The FFTW backend requires the fftw3f library (EDSP_HAS_FFTWF) to support float");
+            static_assert(!std::is_same<T, long double>::value,
+                          "The FFTW backend requires the fftw3l library (EDSP_HAS_FFTWL) to support long double");
+        };
+
+#if defined(EDSP_HAS_FFTWF)
+        template <>
+        struct fftw_traits<float> {
+            using plan_type    = ::fftwf_plan;
+            using complex_type = ::fftwf_complex;
+
+            static plan_type plan_dft(int n, int howmany, complex_type* src, int istride, int idist, complex_type* dst,
+                                      int ostride, int odist, int sign, unsigned flags) {
+                return fftwf_plan_many_dft(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride, odist,
+                                           sign, flags);
+            }
+
+            static plan_type plan_dft_r2c(int n, int howmany, float* src, int istride, int idist, complex_type* dst,
+                                          int ostride, int odist, unsigned flags) {
+                return fftwf_plan_many_dft_r2c(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride,
+                                               odist, flags);
+            }
+
+            static plan_type plan_dft_c2r(int n, int howmany, complex_type* src, int istride, int idist, float* dst,
+                                          int ostride, int odist, unsigned flags) {
+                return fftwf_plan_many_dft_c2r(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride,
+                                               odist, flags);
+            }
+
+            static plan_type plan_r2r(int n, int howmany, float* src, int istride, int idist, float* dst, int ostride,
+                                      int odist, fftw_r2r_kind kind, unsigned flags) {
+                return fftwf_plan_many_r2r(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride, odist,
+                                           &kind, flags);
+            }
+
+            static void execute_dft(plan_type plan, complex_type* src, complex_type* dst) {
+                fftwf_execute_dft(plan, src, dst);
+            }
+
+            static void execute_dft_r2c(plan_type plan, float* src, complex_type* dst) {
+                fftwf_execute_dft_r2c(plan, src, dst);
+            }
+
+            static void execute_dft_c2r(plan_type plan, complex_type* src, float* dst) {
+                fftwf_execute_dft_c2r(plan, src, dst);
+            }
+
+            static void execute_r2r(plan_type plan, float* src, float* dst) {
+                fftwf_execute_r2r(plan, src, dst);
+            }
+
+            static void destroy_plan(plan_type plan) {
+                fftwf_destroy_plan(plan);
+            }
+
+            static int alignment_of(const void* p) {
+                return fftwf_alignment_of(static_cast<float*>(const_cast<void*>(p)));
+            }
+
+            static void* malloc(std::size_t n) {
+                return fftwf_malloc(n);
+            }
+
+            static void free(void* p) {
+                fftwf_free(p);
+            }
+
+            static void set_timelimit(double seconds) {
+                fftwf_set_timelimit(seconds);
+            }
+
+            static bool export_wisdom(const char* path) {
+                return fftwf_export_wisdom_to_filename(path) != 0;
+            }
+
+            static bool import_wisdom(const char* path) {
+                return fftwf_import_wisdom_from_filename(path) != 0;
+            }
+
+            static void forget_wisdom() {
+                fftwf_forget_wisdom();
+            }
+        };
+#endif
+
+        template <>
+        struct fftw_traits<double> {
+            using plan_type    = ::fftw_plan;
+            using complex_type = ::fftw_complex;
+
+            static plan_type plan_dft(int n, int howmany, complex_type* src, int istride, int idist, complex_type* dst,
+                                      int ostride, int odist, int sign, unsigned flags) {
+                return fftw_plan_many_dft(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride, odist,
+                                          sign, flags);
+            }
+
+            static plan_type plan_dft_r2c(int n, int howmany, double* src, int istride, int idist, complex_type* dst,
+                                          int ostride, int odist, unsigned flags) {
+                return fftw_plan_many_dft_r2c(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride,
+                                              odist, flags);
+            }
+
+            static plan_type plan_dft_c2r(int n, int howmany, complex_type* src, int istride, int idist, double* dst,
+                                          int ostride, int odist, unsigned flags) {
+                return fftw_plan_many_dft_c2r(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride,
+                                              odist, flags);
+            }
+
+            static plan_type plan_r2r(int n, int howmany, double* src, int istride, int idist, double* dst, int ostride,
+                                      int odist, fftw_r2r_kind kind, unsigned flags) {
+                return fftw_plan_many_r2r(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride, odist,
+                                          &kind, flags);
+            }
+
+            static void execute_dft(plan_type plan, complex_type* src, complex_type* dst) {
+                fftw_execute_dft(plan, src, dst);
+            }
+
+            static void execute_dft_r2c(plan_type plan, double* src, complex_type* dst) {
+                fftw_execute_dft_r2c(plan, src, dst);
+            }
+
+            static void execute_dft_c2r(plan_type plan, complex_type* src, double* dst) {
+                fftw_execute_dft_c2r(plan, src, dst);
+            }
+
+            static void execute_r2r(plan_type plan, double* src, double* dst) {
+                fftw_execute_r2r(plan, src, dst);
+            }
+
+            static void destroy_plan(plan_type plan) {
+                fftw_destroy_plan(plan);
+            }
+
+            static int alignment_of(const void* p) {
+                return fftw_alignment_of(static_cast<double*>(const_cast<void*>(p)));
+            }
+
+            static void* malloc(std::size_t n) {
+                return fftw_malloc(n);
+            }
+
+            static void free(void* p) {
+                fftw_free(p);
+            }
+
+            static void set_timelimit(double seconds) {
+                fftw_set_timelimit(seconds);
+            }
+
+            static bool export_wisdom(const char* path) {
+                return fftw_export_wisdom_to_filename(path) != 0;
+            }
+
+            static bool import_wisdom(const char* path) {
+                return fftw_import_wisdom_from_filename(path) != 0;
+            }
+
+            static void forget_wisdom() {
+                fftw_forget_wisdom();
+            }
+        };
+
+#if defined(EDSP_HAS_FFTWL)
+        template <>
+        struct fftw_traits<long double> {
+            using plan_type    = ::fftwl_plan;
+            using complex_type = ::fftwl_complex;
+
+            static plan_type plan_dft(int n, int howmany, complex_type* src, int istride, int idist, complex_type* dst,
+                                      int ostride, int odist, int sign, unsigned flags) {
+                return fftwl_plan_many_dft(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride, odist,
+                                           sign, flags);
+            }
+
+            static plan_type plan_dft_r2c(int n, int howmany, long double* src, int istride, int idist,
+                                          complex_type* dst, int ostride, int odist, unsigned flags) {
+                return fftwl_plan_many_dft_r2c(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride,
+                                               odist, flags);
+            }
+
+            static plan_type plan_dft_c2r(int n, int howmany, complex_type* src, int istride, int idist,
+                                          long double* dst, int ostride, int odist, unsigned flags) {
+                return fftwl_plan_many_dft_c2r(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride,
+                                               odist, flags);
+            }
+
+            static plan_type plan_r2r(int n, int howmany, long double* src, int istride, int idist, long double* dst,
+                                      int ostride, int odist, fftw_r2r_kind kind, unsigned flags) {
+                return fftwl_plan_many_r2r(1, &n, howmany, src, nullptr, istride, idist, dst, nullptr, ostride, odist,
+                                           &kind, flags);
+            }
+
+            static void execute_dft(plan_type plan, complex_type* src, complex_type* dst) {
+                fftwl_execute_dft(plan, src, dst);
+            }
+
+            static void execute_dft_r2c(plan_type plan, long double* src, complex_type* dst) {
+                fftwl_execute_dft_r2c(plan, src, dst);
+            }
+
+            static void execute_dft_c2r(plan_type plan, complex_type* src, long double* dst) {
+                fftwl_execute_dft_c2r(plan, src, dst);
+            }
+
+            static void execute_r2r(plan_type plan, long double* src, long double* dst) {
+                fftwl_execute_r2r(plan, src, dst);
+            }
+
+            static void destroy_plan(plan_type plan) {
+                fftwl_destroy_plan(plan);
+            }
+
+            static int alignment_of(const void* p) {
+                return fftwl_alignment_of(static_cast<long double*>(const_cast<void*>(p)));
+            }
+
+            static void* malloc(std::size_t n) {
+                return fftwl_malloc(n);
+            }
+
+            static void free(void* p) {
+                fftwl_free(p);
+            }
+
+            static void set_timelimit(double seconds) {
+                fftwl_set_timelimit(seconds);
+            }
+
+            static bool export_wisdom(const char* path) {
+                return fftwl_export_wisdom_to_filename(path) != 0;
+            }
+
+            static bool import_wisdom(const char* path) {
+                return fftwl_import_wisdom_from_filename(path) != 0;
+            }
+
+            static void forget_wisdom() {
+                fftwl_forget_wisdom();
+            }
+        };
+#endif
+
     } // namespace internal
 
     template <typename T>
-    struct fftw_impl {};
-
-    template <>
-    struct fftw_impl<float> {
-        using value_type   = float;
-        using complex_type = std::complex<float>;
+    struct fftw_impl {
+        using value_type   = T;
+        using complex_type = std::complex<T>;
         using size_type    = int;
 
-        explicit fftw_impl(size_type nfft) : nfft_(nfft) {}
+        fftw_impl(size_type nfft, const fft_plan_policy& policy) : policy_(policy), nfft_(nfft) {}
 
-        ~fftw_impl() {
-            if (!meta::is_null(plan_)) {
-                fftwf_destroy_plan(plan_);
+        static bool export_wisdom(const std::string& path) {
+            std::lock_guard<std::mutex> lock(fft_plan_cache::instance().planner_mutex());
+            return traits::export_wisdom(path.c_str());
+        }
+
+        static bool import_wisdom(const std::string& path) {
+            std::lock_guard<std::mutex> lock(fft_plan_cache::instance().planner_mutex());
+            return traits::import_wisdom(path.c_str());
+        }
+
+        static void forget_wisdom() {
+            std::lock_guard<std::mutex> lock(fft_plan_cache::instance().planner_mutex());
+            traits::forget_wisdom();
+        }
+
+        inline void prepare(fft_kind kind, bool in_place) {
+            auto& handles = plans_[static_cast<std::size_t>(kind)];
+            for (const auto aligned : {true, false}) {
+                auto& handle = handles[variant(aligned, in_place)];
+                if (meta::is_null(handle)) {
+                    handle = acquire(kind, aligned, in_place, fft_batch_layout{});
+                }
+            }
+        }
+
+        inline bool prepared(fft_kind kind, bool in_place) const {
+            const auto& handles = plans_[static_cast<std::size_t>(kind)];
+            return !meta::is_null(handles[variant(true, in_place)]) &&
+                   !meta::is_null(handles[variant(false, in_place)]);
+        }
+
+        inline void prepare_batch(fft_kind kind, const fft_batch_layout& layout, bool in_place) {
+            auto& slot = batch_slot(kind, layout);
+            for (const auto aligned : {true, false}) {
+                auto& handle = slot.handles[variant(aligned, in_place)];
+                if (meta::is_null(handle)) {
+                    handle = acquire(kind, aligned, in_place, layout);
+                }
             }
         }
 
         inline void dft(const complex_type* src, complex_type* dst) {
-            if (meta::is_null(plan_))
-                plan_ = fftwf_plan_dft_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_FORWARD,
-                                          FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            fftwf_execute_dft(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+            traits::execute_dft(plan(fft_kind::ComplexForward, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
         }
 
         inline void idft(const complex_type* src, complex_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftwf_plan_dft_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_BACKWARD,
-                                          FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            }
-            fftwf_execute_dft(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+            traits::execute_dft(plan(fft_kind::ComplexBackward, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
         }
 
         inline void dft(const value_type* src, complex_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftwf_plan_dft_r2c_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst),
-                                              FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            }
-            fftwf_execute_dft_r2c(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+            traits::execute_dft_r2c(plan(fft_kind::RealForward, src, dst), internal::fftw_cast(src),
+                                    internal::fftw_cast(dst));
         }
 
         inline void idft(const complex_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftwf_plan_dft_c2r_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst),
-                                              FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            }
-            fftwf_execute_dft_c2r(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+            traits::execute_dft_c2r(plan(fft_kind::RealBackward, src, dst), internal::fftw_cast(src),
+                                    internal::fftw_cast(dst));
         }
 
         inline void dht(const value_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftwf_plan_r2r_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_DHT,
-                                          FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            }
-            fftwf_execute_r2r(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+            traits::execute_r2r(plan(fft_kind::Hartley, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
         }
 
         inline void dct(const value_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftwf_plan_r2r_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_REDFT10,
-                                          FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            }
-            fftwf_execute_r2r(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+            traits::execute_r2r(plan(fft_kind::Cosine, src, dst), internal::fftw_cast(src), internal::fftw_cast(dst));
         }
 
         inline void idct(const value_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftwf_plan_r2r_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_REDFT01,
-                                          FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            }
-            fftwf_execute_r2r(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+            traits::execute_r2r(plan(fft_kind::InverseCosine, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
+        }
+
+        inline void dft_batch(const complex_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            traits::execute_dft(batch_plan(fft_kind::ComplexForward, layout, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
+        }
+
+        inline void idft_batch(const complex_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            traits::execute_dft(batch_plan(fft_kind::ComplexBackward, layout, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
+        }
+
+        inline void dft_batch(const value_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            traits::execute_dft_r2c(batch_plan(fft_kind::RealForward, layout, src, dst), internal::fftw_cast(src),
+                                    internal::fftw_cast(dst));
+        }
+
+        inline void idft_batch(const complex_type* src, value_type* dst, const fft_batch_layout& layout) {
+            traits::execute_dft_c2r(batch_plan(fft_kind::RealBackward, layout, src, dst), internal::fftw_cast(src),
+                                    internal::fftw_cast(dst));
+        }
+
+        inline void dht_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            traits::execute_r2r(batch_plan(fft_kind::Hartley, layout, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
+        }
+
+        inline void dct_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            traits::execute_r2r(batch_plan(fft_kind::Cosine, layout, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
+        }
+
+        inline void idct_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            traits::execute_r2r(batch_plan(fft_kind::InverseCosine, layout, src, dst), internal::fftw_cast(src),
+                                internal::fftw_cast(dst));
         }
 
         inline void idft_scale(value_type* dst) const {
@@ -143,99 +445,147 @@ namespace edsp { inline namespace spectral {
         }
 
     private:
-        ::fftwf_plan plan_{nullptr};
-        size_type nfft_;
-    };
+        using traits      = internal::fftw_traits<T>;
+        using plan_type   = typename traits::plan_type;
+        using handle_list = std::array<fft_plan_cache::plan_handle, 4>;
 
-    template <>
-    struct fftw_impl<double> {
-        using value_type   = double;
-        using complex_type = std::complex<double>;
-        using size_type    = int;
-
-        explicit fftw_impl(size_type nfft) : nfft_(nfft) {}
-
-        ~fftw_impl() {
-            if (!meta::is_null(plan_)) {
-                fftw_destroy_plan(plan_);
-            }
-        }
+        struct batch_entry {
+            fft_batch_layout layout{};
+            handle_list handles{};
+        };
 
-        inline void dft(const complex_type* src, complex_type* dst) {
-            if (meta::is_null(plan_))
-                plan_ = fftw_plan_dft_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_FORWARD,
-                                         FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            fftw_execute_dft(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+        static constexpr std::size_t variant(bool aligned, bool in_place) noexcept {
+            return (aligned ? 1u : 0u) | (in_place ? 2u : 0u);
         }
 
-        inline void idft(const complex_type* src, complex_type* dst) {
-            if (meta::is_null(plan_))
-                plan_ = fftw_plan_dft_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_BACKWARD,
-                                         FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            fftw_execute_dft(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+        inline fft_plan_cache::plan_handle acquire(fft_kind kind, bool aligned, bool in_place,
+                                                   const fft_batch_layout& layout) const {
+            const fft_plan_key key{static_cast<std::size_t>(nfft_), typeid(T), kind, policy_.rigor, aligned, in_place,
+                                   layout};
+            return fft_plan_cache::instance().acquire(key, [this, &key]() { return make_plan(key, policy_); });
         }
 
-        inline void dft(const value_type* src, complex_type* dst) {
-            if (meta::is_null(plan_))
-                plan_ = fftw_plan_dft_r2c_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst),
-                                             FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            fftw_execute_dft_r2c(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+        inline plan_type lookup(handle_list& handles, fft_kind kind, const fft_batch_layout& layout, const void* src,
+                                const void* dst) {
+            const bool aligned  = traits::alignment_of(src) == 0 && traits::alignment_of(dst) == 0;
+            const bool in_place = src == dst;
+            auto& handle        = handles[variant(aligned, in_place)];
+            if (meta::is_null(handle)) {
+                handle = acquire(kind, aligned, in_place, layout);
+            }
+            return static_cast<plan_type>(handle.get());
         }
 
-        inline void idft(const complex_type* src, value_type* dst) {
-            if (meta::is_null(plan_))
-                plan_ = fftw_plan_dft_c2r_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst),
-                                             FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            fftw_execute_dft_c2r(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+        inline plan_type plan(fft_kind kind, const void* src, const void* dst) {
+            return lookup(plans_[static_cast<std::size_t>(kind)], kind, fft_batch_layout{}, src, dst);
         }
 
-        inline void dht(const value_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftw_plan_r2r_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_DHT,
-                                         FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
+        inline batch_entry& batch_slot(fft_kind kind, const fft_batch_layout& layout) {
+            // Only the last layout of every kind is kept locally, the rest of them are still in the global cache.
+            auto& slot = batches_[static_cast<std::size_t>(kind)];
+            if (slot.layout != layout) {
+                slot.layout  = layout;
+                slot.handles = handle_list{};
             }
-            fftw_execute_r2r(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+            return slot;
         }
 
-        inline void dct(const value_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftw_plan_r2r_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_REDFT10,
-                                         FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
-            }
-            fftw_execute_r2r(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
+        inline plan_type batch_plan(fft_kind kind, const fft_batch_layout& layout, const void* src, const void* dst) {
+            return lookup(batch_slot(kind, layout).handles, kind, layout, src, dst);
         }
 
-        inline void idct(const value_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = fftw_plan_r2r_1d(nfft_, internal::fftw_cast(src), internal::fftw_cast(dst), FFTW_REDFT01,
-                                         FFTW_ESTIMATE | FFTW_PRESERVE_INPUT);
+        static constexpr unsigned rigor_flag(fft_rigor rigor) noexcept {
+            switch (rigor) {
+                case fft_rigor::Measure:
+                    return FFTW_MEASURE;
+                case fft_rigor::Patient:
+                    return FFTW_PATIENT;
+                case fft_rigor::Exhaustive:
+                    return FFTW_EXHAUSTIVE;
+                default:
+                    return FFTW_ESTIMATE;
             }
-            fftw_execute_r2r(plan_, internal::fftw_cast(src), internal::fftw_cast(dst));
         }
 
-        inline void idft_scale(value_type* dst) const {
-            const auto scaling = static_cast<value_type>(nfft_);
-            for (size_type i = 0; i < nfft_; ++i) {
-                dst[i] /= scaling;
-            }
+        static constexpr std::size_t extent(std::size_t n, std::size_t stride, std::size_t dist,
+                                            std::size_t howmany) noexcept {
+            return (howmany - 1) * dist + (n - 1) * stride + 1;
         }
 
-        inline void idft_scale(complex_type* dst) const {
-            const auto scaling = static_cast<value_type>(nfft_);
-            for (size_type i = 0; i < nfft_; ++i) {
-                dst[i] /= scaling;
+        static fft_plan_cache::plan_handle make_plan(const fft_plan_key& key, const fft_plan_policy& policy) {
+            auto& cache = fft_plan_cache::instance();
+            std::lock_guard<std::mutex> lock(cache.planner_mutex());
+
+            const auto& layout       = key.layout;
+            const bool complex_input = key.kind == fft_kind::ComplexForward || key.kind == fft_kind::ComplexBackward ||
+                                       key.kind == fft_kind::RealBackward;
+            const bool complex_output = key.kind == fft_kind::ComplexForward ||
+                                        key.kind == fft_kind::ComplexBackward || key.kind == fft_kind::RealForward;
+            const auto input_size  = (key.kind == fft_kind::RealBackward) ? key.size / 2 + 1 : key.size;
+            const auto output_size = (key.kind == fft_kind::RealForward) ? key.size / 2 + 1 : key.size;
+            const auto input_bytes = extent(input_size, layout.istride, layout.idist, layout.howmany) *
+                                     (complex_input ? sizeof(complex_type) : sizeof(value_type));
+            const auto output_bytes = extent(output_size, layout.ostride, layout.odist, layout.howmany) *
+                                      (complex_output ? sizeof(complex_type) : sizeof(value_type));
+
+            // The plans are created with scratch buffers: the measuring rigors overwrite the buffers while planning,
+            // the real buffers are only given at execution time.
+            auto* input  = traits::malloc(key.in_place ? std::max(input_bytes, output_bytes) : input_bytes);
+            auto* output = key.in_place ? input : traits::malloc(output_bytes);
+            auto* complex_in  = static_cast<typename traits::complex_type*>(input);
+            auto* complex_out = static_cast<typename traits::complex_type*>(output);
+            auto* real_in     = static_cast<value_type*>(input);
+            auto* real_out    = static_cast<value_type*>(output);
+
+            const auto n         = static_cast<int>(key.size);
+            const auto howmany   = static_cast<int>(layout.howmany);
+            const auto is        = static_cast<int>(layout.istride);
+            const auto id        = static_cast<int>(layout.idist);
+            const auto os        = static_cast<int>(layout.ostride);
+            const auto od        = static_cast<int>(layout.odist);
+            const unsigned flags = rigor_flag(key.rigor) | FFTW_PRESERVE_INPUT | (key.aligned ? 0u : FFTW_UNALIGNED);
+            traits::set_timelimit(policy.time_limit < 0 ? FFTW_NO_TIMELIMIT : policy.time_limit);
+
+            plan_type plan = nullptr;
+            switch (key.kind) {
+                case fft_kind::ComplexForward:
+                    plan = traits::plan_dft(n, howmany, complex_in, is, id, complex_out, os, od, FFTW_FORWARD, flags);
+                    break;
+                case fft_kind::ComplexBackward:
+                    plan = traits::plan_dft(n, howmany, complex_in, is, id, complex_out, os, od, FFTW_BACKWARD, flags);
+                    break;
+                case fft_kind::RealForward:
+                    plan = traits::plan_dft_r2c(n, howmany, real_in, is, id, complex_out, os, od, flags);
+                    break;
+                case fft_kind::RealBackward:
+                    plan = traits::plan_dft_c2r(n, howmany, complex_in, is, id, real_out, os, od, flags);
+                    break;
+                case fft_kind::Hartley:
+                    plan = traits::plan_r2r(n, howmany, real_in, is, id, real_out, os, od, FFTW_DHT, flags);
+                    break;
+                case fft_kind::Cosine:
+                    plan = traits::plan_r2r(n, howmany, real_in, is, id, real_out, os, od, FFTW_REDFT10, flags);
+                    break;
+                case fft_kind::InverseCosine:
+                    plan = traits::plan_r2r(n, howmany, real_in, is, id, real_out, os, od, FFTW_REDFT01, flags);
+                    break;
             }
-        }
 
-        inline void idct_scale(value_type* dst) const {
-            const auto scaling = 2 * nfft_;
-            for (size_type i = 0; i < nfft_; ++i) {
-                dst[i] /= scaling;
+            if (output != input) {
+                traits::free(output);
             }
+            traits::free(input);
+            meta::expects(!meta::is_null(plan), "Unable to create the FFTW plan");
+
+            return fft_plan_cache::plan_handle(plan, [](void* p) {
+                std::lock_guard<std::mutex> guard(fft_plan_cache::instance().planner_mutex());
+                traits::destroy_plan(static_cast<plan_type>(p));
+            });
         }
 
-    private:
-        ::fftw_plan plan_{nullptr};
+        std::array<handle_list, fft_kind_count> plans_{};
+        std::array<batch_entry, fft_kind_count> batches_{};
+        fft_plan_policy policy_;
         size_type nfft_;
     };
 }} // namespace edsp::spectral
@@ -22,6 +22,7 @@
 #ifndef EDSP_LIBPFFFT_IMPL_HPP
 #define EDSP_LIBPFFFT_IMPL_HPP
 
+#include <edsp/spectral/fft_plan_cache.hpp>
 #include <edsp/meta/is_null.hpp>
 #include <edsp/meta/advance.hpp>
 #include <edsp/meta/iterator.hpp>
@@ -29,6 +30,8 @@
 #include <edsp/meta/data.hpp>
 
 #include <complex>
+#include <string>
+#include <typeinfo>
 #include <pffft.h>
 #include <algorithm>
 
@@ -130,48 +133,65 @@ namespace edsp { inline namespace spectral {
         using complex_type = std::complex<float>;
         using size_type    = int;
 
-        explicit pffft_impl(size_type nfft) : nfft_(nfft) {
-            work_ = (float*) pffft_aligned_malloc(2 * nfft * sizeof(float));
+        pffft_impl(size_type nfft, const fft_plan_policy& policy) : nfft_(nfft) {
+            meta::unused(policy);
+            work_   = (float*) pffft_aligned_malloc(2 * nfft * sizeof(float));
+            input_  = (float*) pffft_aligned_malloc(2 * nfft * sizeof(float));
+            output_ = (float*) pffft_aligned_malloc(2 * nfft * sizeof(float));
             meta::expects(
                 nfft_ % 16 == 0,
                 "Unfortunately, the fft_engine size must be a multiple of 16 for complex FFTs  and 32 for real FFTs");
         }
 
         ~pffft_impl() {
-            if (!meta::is_null(plan_)) {
-                pffft_destroy_setup(plan_);
-            }
+            pffft_aligned_free(output_);
+            pffft_aligned_free(input_);
             pffft_aligned_free(work_);
         }
 
+        static bool export_wisdom(const std::string& path) {
+            meta::unused(path);
+            return false;
+        }
+
+        static bool import_wisdom(const std::string& path) {
+            meta::unused(path);
+            return false;
+        }
+
+        static void forget_wisdom() {}
+
+        inline void prepare(fft_kind kind, bool in_place) {
+            meta::unused(in_place);
+            setup(domain(kind));
+        }
+
+        inline bool prepared(fft_kind kind, bool in_place) const {
+            meta::unused(in_place);
+            return !meta::is_null(domain(kind) == PFFFT_REAL ? real_setup_ : complex_setup_);
+        }
+
+        inline void prepare_batch(fft_kind kind, const fft_batch_layout& layout, bool in_place) {
+            meta::unused(layout);
+            prepare(kind, in_place);
+        }
+
         inline void dft(const complex_type* src, complex_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = pffft_new_setup(nfft_, PFFFT_COMPLEX);
-            }
-            pffft_transform_ordered(plan_, reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), work_,
-                                    PFFFT_FORWARD);
+            pffft_transform_ordered(setup(PFFFT_COMPLEX), reinterpret_cast<const float*>(src),
+                                    reinterpret_cast<float*>(dst), work_, PFFFT_FORWARD);
         }
 
         inline void idft(const complex_type* src, complex_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = pffft_new_setup(nfft_, PFFFT_COMPLEX);
-            }
-            pffft_transform_ordered(plan_, reinterpret_cast<const float*>(src), reinterpret_cast<float*>(dst), work_,
-                                    PFFFT_BACKWARD);
+            pffft_transform_ordered(setup(PFFFT_COMPLEX), reinterpret_cast<const float*>(src),
+                                    reinterpret_cast<float*>(dst), work_, PFFFT_BACKWARD);
         }
 
         inline void dft(const value_type* src, complex_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = pffft_new_setup(nfft_, PFFFT_REAL);
-            }
-            pffft_transform_ordered(plan_, src, reinterpret_cast<float*>(dst), work_, PFFFT_FORWARD);
+            pffft_transform_ordered(setup(PFFFT_REAL), src, reinterpret_cast<float*>(dst), work_, PFFFT_FORWARD);
         }
 
         inline void idft(const complex_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = pffft_new_setup(nfft_, PFFFT_REAL);
-            }
-            pffft_transform_ordered(plan_, reinterpret_cast<const float*>(src), dst, work_, PFFFT_BACKWARD);
+            pffft_transform_ordered(setup(PFFFT_REAL), reinterpret_cast<const float*>(src), dst, work_, PFFFT_BACKWARD);
         }
 
         inline void dht(const value_type* src, value_type* dst) {
@@ -179,9 +199,6 @@ namespace edsp { inline namespace spectral {
         }
 
         inline void dct(const value_type* src, value_type* dst) {
-            if (meta::is_null(plan_)) {
-                plan_ = pffft_new_setup(nfft_, PFFFT_REAL);
-            }
             std::copy(src, src + nfft_, dst);
             internal::dct(dst, nfft_);
         }
@@ -191,6 +208,36 @@ namespace edsp { inline namespace spectral {
             internal::idct(dst, nfft_);
         }
 
+        inline void dft_batch(const complex_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const complex_type* in, complex_type* out) { dft(in, out); });
+        }
+
+        inline void idft_batch(const complex_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const complex_type* in, complex_type* out) { idft(in, out); });
+        }
+
+        inline void dft_batch(const value_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_ / 2 + 1, layout,
+                  [this](const value_type* in, complex_type* out) { dft(in, out); });
+        }
+
+        inline void idft_batch(const complex_type* src, value_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_ / 2 + 1, dst, nfft_, layout,
+                  [this](const complex_type* in, value_type* out) { idft(in, out); });
+        }
+
+        inline void dht_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const value_type* in, value_type* out) { dht(in, out); });
+        }
+
+        inline void dct_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const value_type* in, value_type* out) { dct(in, out); });
+        }
+
+        inline void idct_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const value_type* in, value_type* out) { idct(in, out); });
+        }
+
         inline void idft_scale(value_type* dst) const {
             const auto scaling = static_cast<value_type>(nfft_);
             for (size_type i = 0; i < nfft_; ++i) {
@@ -213,8 +260,51 @@ namespace edsp { inline namespace spectral {
         }
 
     private:
-        PFFFT_Setup* plan_{nullptr};
+        static constexpr pffft_transform_t domain(fft_kind kind) noexcept {
+            return (kind == fft_kind::ComplexForward || kind == fft_kind::ComplexBackward) ? PFFFT_COMPLEX : PFFFT_REAL;
+        }
+
+        template <typename I, typename O, typename Transform>
+        inline void batch(const I* src, size_type isize, O* dst, size_type osize, const fft_batch_layout& layout,
+                          Transform transform) {
+            // pffft has no batched interface: every transform is gathered into an aligned contiguous buffer, computed
+            // and scattered back to its position in the output.
+            auto* input  = reinterpret_cast<I*>(input_);
+            auto* output = reinterpret_cast<O*>(output_);
+            for (std::size_t i = 0; i < layout.howmany; ++i) {
+                const auto* first = src + i * layout.idist;
+                for (size_type j = 0; j < isize; ++j) {
+                    input[j] = first[j * layout.istride];
+                }
+                transform(input, output);
+                auto* last = dst + i * layout.odist;
+                for (size_type j = 0; j < osize; ++j) {
+                    last[j * layout.ostride] = output[j];
+                }
+            }
+        }
+
+        inline PFFFT_Setup* setup(pffft_transform_t transform) {
+            // The same setup is shared by the forward and backward transforms, it only depends on the input domain.
+            auto& handle = (transform == PFFFT_REAL) ? real_setup_ : complex_setup_;
+            if (meta::is_null(handle)) {
+                const auto kind = (transform == PFFFT_REAL) ? fft_kind::RealForward : fft_kind::ComplexForward;
+                const fft_plan_key key{static_cast<std::size_t>(nfft_), typeid(float), kind, fft_rigor::Estimate, true,
+                                       false};
+                handle = fft_plan_cache::instance().acquire(key, [this, transform]() {
+                    return fft_plan_cache::plan_handle(pffft_new_setup(nfft_, transform), [](void* p) {
+                        pffft_destroy_setup(static_cast<PFFFT_Setup*>(p));
+                    });
+                });
+            }
+            return static_cast<PFFFT_Setup*>(handle.get());
+        }
+
+        fft_plan_cache::plan_handle real_setup_{};
+        fft_plan_cache::plan_handle complex_setup_{};
         float* work_{nullptr};
+        float* input_{nullptr};
+        float* output_{nullptr};
         size_type nfft_;
     };
 
@@ -0,0 +1,696 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: native_fft_impl.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_NATIVE_FFT_IMPL_HPP
+#define EDSP_NATIVE_FFT_IMPL_HPP
+
+#include <edsp/spectral/fft_plan_cache.hpp>
+#include <edsp/meta/is_null.hpp>
+#include <edsp/meta/advance.hpp>
+#include <edsp/meta/iterator.hpp>
+#include <edsp/meta/expects.hpp>
+#include <edsp/meta/unused.hpp>
+#include <edsp/meta/data.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    namespace internal {
+
+        /**
+         * @brief Returns the twiddle factor exp(-2 * pi * i * k / n), computed in extended precision.
+         */
+        template <typename T>
+        inline std::complex<T> native_twiddle(std::size_t k, std::size_t n) {
+            const auto angle = -2 * 3.141592653589793238462643383279502884L * static_cast<long double>(k) /
+                               static_cast<long double>(n);
+            return {static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle))};
+        }
+
+        /**
+         * @brief Complex multiplication without the NaN and infinity recovery of std::complex, which prevents the
+         * vectorization of the butterflies.
+         */
+        template <typename T>
+        inline std::complex<T> native_multiply(const std::complex<T>& a, const std::complex<T>& b) {
+            return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+        }
+
+        /**
+         * @brief Converts a complex number to another precision.
+         */
+        template <typename R, typename T>
+        inline std::complex<R> native_cast(const std::complex<T>& value) {
+            return {static_cast<R>(value.real()), static_cast<R>(value.imag())};
+        }
+
+        /**
+         * @brief Complex FFT of a fixed size.
+         *
+         * Power of two sizes are computed with a Stockham autosort algorithm made of radix-4 stages, followed by a
+         * radix-2 stage if needed. The samples are processed in split format (separate real and imaginary arrays) and
+         * the twiddle factors are stored in contiguous tables, so the butterflies have unit stride and are vectorized
+         * by the compiler for the SIMD instruction set of the target (SSE, AVX2, AVX-512 or NEON).
+         *
+         * Any other size is computed with the Bluestein algorithm, as a convolution of a power of two size.
+         *
+         * The samples are stored in T between the stages, while the twiddle factors are stored in A and every
+         * butterfly is computed in A. With a wider A, the buffers keep the size of T and only the rounding of the
+         * stored samples remains, the error of the twiddle factors and of the butterflies is the one of A.
+         *
+         * The plan is immutable once created, so it can be shared between threads. Every execution needs a scratch
+         * buffer of scratch_size() elements owned by the caller.
+         */
+        template <typename T, typename A = T>
+        class native_fft_plan {
+        public:
+            using complex_type = std::complex<T>;
+            using wide_type    = std::complex<A>;
+            using size_type    = std::size_t;
+
+            explicit native_fft_plan(size_type size) : size_(size) {
+                meta::expects(size > 0, "The size of the FFT should be greater than zero");
+                if ((size & (size - 1)) == 0) {
+                    make_stages();
+                } else {
+                    make_bluestein();
+                }
+            }
+
+            size_type size() const noexcept {
+                return size_;
+            }
+
+            size_type scratch_size() const noexcept {
+                return inner_ ? 2 * inner_->size() + inner_->scratch_size() : 2 * size_;
+            }
+
+            /**
+             * @brief Computes the forward transform, src and dst can be the same buffer.
+             */
+            void forward(const complex_type* src, complex_type* dst, complex_type* scratch) const {
+                execute(src, dst, scratch, false);
+            }
+
+            /**
+             * @brief Computes the unscaled backward transform, src and dst can be the same buffer.
+             */
+            void backward(const complex_type* src, complex_type* dst, complex_type* scratch) const {
+                // IDFT(x) = conj(DFT(conj(x)))
+                execute(src, dst, scratch, true);
+            }
+
+        private:
+            struct stage {
+                size_type radix;
+                size_type offset;
+            };
+
+            void make_stages() {
+                size_type n = size_;
+                while (n > 1) {
+                    const size_type radix = (n % 4 == 0) ? 4 : 2;
+                    const size_type m     = n / radix;
+                    stages_.push_back({radix, twiddle_real_.size()});
+                    for (size_type r = 1; r < radix; ++r) {
+                        for (size_type p = 0; p < m; ++p) {
+                            const auto w = native_twiddle<A>(p * r, n);
+                            twiddle_real_.push_back(w.real());
+                            twiddle_imag_.push_back(w.imag());
+                        }
+                    }
+                    n = m;
+                }
+            }
+
+            void make_bluestein() {
+                size_type m = 1;
+                while (m < 2 * size_ - 1) {
+                    m *= 2;
+                }
+                inner_ = std::make_unique<native_fft_plan>(m);
+
+                // The chirp is computed from k^2 mod 2N to keep the accuracy for large sizes.
+                chirp_.resize(size_);
+                for (size_type k = 0; k < size_; ++k) {
+                    chirp_[k] = native_twiddle<A>((k * k) % (2 * size_), 2 * size_);
+                }
+
+                // The transform of the kernel is computed once, entirely in A.
+                const native_fft_plan<A> plan(m);
+                std::vector<wide_type> kernel(m, wide_type{});
+                std::vector<wide_type> scratch(plan.scratch_size());
+                kernel[0] = std::conj(chirp_[0]);
+                for (size_type k = 1; k < size_; ++k) {
+                    kernel[k]     = std::conj(chirp_[k]);
+                    kernel[m - k] = std::conj(chirp_[k]);
+                }
+                kernel_.resize(m);
+                plan.forward(kernel.data(), kernel_.data(), scratch.data());
+                const auto scaling = static_cast<A>(m);
+                for (auto& value : kernel_) {
+                    value /= scaling;
+                }
+            }
+
+            void execute(const complex_type* src, complex_type* dst, complex_type* scratch, bool conjugate) const {
+                if (inner_) {
+                    bluestein(src, dst, scratch, conjugate);
+                } else {
+                    stockham(src, dst, scratch, conjugate);
+                }
+            }
+
+            void stockham(const complex_type* src, complex_type* dst, complex_type* scratch, bool conjugate) const {
+                // The scratch buffer holds two split-format signals, the stages alternate between them.
+                T* x            = reinterpret_cast<T*>(scratch);
+                T* y            = x + 2 * size_;
+                const auto sign = static_cast<T>(conjugate ? -1 : 1);
+                for (size_type k = 0; k < size_; ++k) {
+                    x[k]         = src[k].real();
+                    x[size_ + k] = sign * src[k].imag();
+                }
+
+                size_type n = size_;
+                size_type s = 1;
+                for (const auto& current : stages_) {
+                    const auto* wr = twiddle_real_.data() + current.offset;
+                    const auto* wi = twiddle_imag_.data() + current.offset;
+                    if (current.radix == 4) {
+                        radix4(x, y, size_, n / 4, s, wr, wi);
+                    } else {
+                        radix2(x, y, size_, n / 2, s, wr, wi);
+                    }
+                    n /= current.radix;
+                    s *= current.radix;
+                    std::swap(x, y);
+                }
+
+                for (size_type k = 0; k < size_; ++k) {
+                    dst[k] = complex_type(x[k], sign * x[size_ + k]);
+                }
+            }
+
+            static void radix2(const T* x, T* y, size_type size, size_type m, size_type s, const A* wr,
+                               const A* wi) {
+                for (size_type p = 0; p < m; ++p) {
+                    const A w1r  = wr[p], w1i = wi[p];
+                    const auto a = s * p;
+                    const auto b = a + s * m;
+                    const auto o = 2 * s * p;
+                    for (size_type q = 0; q < s; ++q) {
+                        const A ar          = x[a + q], ai = x[size + a + q];
+                        const A br          = x[b + q], bi = x[size + b + q];
+                        const auto dr       = ar - br;
+                        const auto di       = ai - bi;
+                        y[o + q]            = static_cast<T>(ar + br);
+                        y[size + o + q]     = static_cast<T>(ai + bi);
+                        y[o + s + q]        = static_cast<T>(dr * w1r - di * w1i);
+                        y[size + o + s + q] = static_cast<T>(dr * w1i + di * w1r);
+                    }
+                }
+            }
+
+            static void radix4(const T* x, T* y, size_type size, size_type m, size_type s, const A* wr,
+                               const A* wi) {
+                // Every buffer stores the real parts followed by the imaginary parts. Using a single base pointer per
+                // buffer keeps the aliasing checks of the vectorized loop to a minimum.
+                const auto step = s * m;
+                const auto butterfly = [x, y, size, s, step](size_type a, size_type o, A w1r, A w1i, A w2r, A w2i,
+                                                             A w3r, A w3i) {
+                    const auto b = a + step;
+                    const auto c = b + step;
+                    const auto d = c + step;
+
+                    const A ar = x[a], ai = x[size + a];
+                    const A br = x[b], bi = x[size + b];
+                    const A cr = x[c], ci = x[size + c];
+                    const A dr = x[d], di = x[size + d];
+
+                    const auto apcr = ar + cr;
+                    const auto apci = ai + ci;
+                    const auto amcr = ar - cr;
+                    const auto amci = ai - ci;
+                    const auto bpdr = br + dr;
+                    const auto bpdi = bi + di;
+                    // Multiplication of b - d by -i
+                    const auto jbmdr = bi - di;
+                    const auto jbmdi = dr - br;
+
+                    const auto t1r = amcr + jbmdr;
+                    const auto t1i = amci + jbmdi;
+                    const auto t2r = apcr - bpdr;
+                    const auto t2i = apci - bpdi;
+                    const auto t3r = amcr - jbmdr;
+                    const auto t3i = amci - jbmdi;
+
+                    y[o]                = static_cast<T>(apcr + bpdr);
+                    y[size + o]         = static_cast<T>(apci + bpdi);
+                    y[o + s]            = static_cast<T>(t1r * w1r - t1i * w1i);
+                    y[size + o + s]     = static_cast<T>(t1r * w1i + t1i * w1r);
+                    y[o + 2 * s]        = static_cast<T>(t2r * w2r - t2i * w2i);
+                    y[size + o + 2 * s] = static_cast<T>(t2r * w2i + t2i * w2r);
+                    y[o + 3 * s]        = static_cast<T>(t3r * w3r - t3i * w3i);
+                    y[size + o + 3 * s] = static_cast<T>(t3r * w3i + t3i * w3r);
+                };
+
+                if (s < 4) {
+                    // The first stages have few samples per butterfly group, the long loop runs over the groups.
+                    for (size_type q = 0; q < s; ++q) {
+                        for (size_type p = 0; p < m; ++p) {
+                            butterfly(s * p + q, 4 * s * p + q, wr[p], wi[p], wr[m + p], wi[m + p], wr[2 * m + p],
+                                      wi[2 * m + p]);
+                        }
+                    }
+                    return;
+                }
+
+                for (size_type p = 0; p < m; ++p) {
+                    const A w1r = wr[p], w1i = wi[p];
+                    const A w2r = wr[m + p], w2i = wi[m + p];
+                    const A w3r = wr[2 * m + p], w3i = wi[2 * m + p];
+                    for (size_type q = 0; q < s; ++q) {
+                        butterfly(s * p + q, 4 * s * p + q, w1r, w1i, w2r, w2i, w3r, w3i);
+                    }
+                }
+            }
+
+            void bluestein(const complex_type* src, complex_type* dst, complex_type* scratch, bool conjugate) const {
+                const auto m       = inner_->size();
+                const auto* chirp  = chirp_.data();
+                const auto* kernel = kernel_.data();
+                auto* input        = scratch;
+                auto* output       = scratch + m;
+                auto* inner        = scratch + 2 * m;
+                for (size_type k = 0; k < size_; ++k) {
+                    const auto value = native_cast<A>(conjugate ? std::conj(src[k]) : src[k]);
+                    input[k]         = native_cast<T>(native_multiply(value, chirp[k]));
+                }
+                std::fill(input + size_, input + m, complex_type{});
+
+                inner_->forward(input, output, inner);
+                for (size_type k = 0; k < m; ++k) {
+                    output[k] = native_cast<T>(std::conj(native_multiply(native_cast<A>(output[k]), kernel[k])));
+                }
+                inner_->forward(output, input, inner);
+                for (size_type k = 0; k < size_; ++k) {
+                    const auto value = native_cast<T>(native_multiply(native_cast<A>(std::conj(input[k])), chirp[k]));
+                    dst[k]           = conjugate ? std::conj(value) : value;
+                }
+            }
+
+            size_type size_;
+            std::vector<stage> stages_;
+            std::vector<A> twiddle_real_;
+            std::vector<A> twiddle_imag_;
+            std::unique_ptr<native_fft_plan> inner_;
+            std::vector<wide_type> chirp_;
+            std::vector<wide_type> kernel_;
+        };
+
+    } // namespace internal
+
+    /**
+     * @brief Header-only FFT backend, used when no external FFT library is available.
+     *
+     * All the transforms are built on top of a complex FFT: the real transforms of even size use a complex FFT of
+     * half the size, the DHT is derived from the real FFT and the DCT-II/DCT-III use the Makhoul algorithm with a
+     * complex FFT of the same size. The plans (twiddle factors) are shared through the fft_plan_cache.
+     *
+     * The buffers store samples of type T, while the twiddle factors and the arithmetic of the transforms use A.
+     * The fft_engine uses A = T, the mixed_fft_engine a wider A.
+     */
+    template <typename T, typename A = T>
+    struct native_fft_impl {
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using wide_type    = std::complex<A>;
+        using size_type    = int;
+
+        native_fft_impl(size_type nfft, const fft_plan_policy& policy) : nfft_(static_cast<std::size_t>(nfft)) {
+            meta::unused(policy);
+            meta::expects(nfft > 0, "The size of the FFT should be greater than zero");
+        }
+
+        static bool export_wisdom(const std::string& path) {
+            meta::unused(path);
+            return false;
+        }
+
+        static bool import_wisdom(const std::string& path) {
+            meta::unused(path);
+            return false;
+        }
+
+        static void forget_wisdom() {}
+
+        inline void prepare(fft_kind kind, bool in_place) {
+            meta::unused(in_place);
+            switch (kind) {
+                case fft_kind::RealForward:
+                case fft_kind::RealBackward:
+                case fft_kind::Hartley:
+                    prepare_real();
+                    break;
+                case fft_kind::Cosine:
+                case fft_kind::InverseCosine:
+                    prepare_cosine();
+                    break;
+                default:
+                    prepare_complex();
+                    break;
+            }
+        }
+
+        inline bool prepared(fft_kind kind, bool in_place) const {
+            meta::unused(in_place);
+            switch (kind) {
+                case fft_kind::RealForward:
+                case fft_kind::RealBackward:
+                case fft_kind::Hartley:
+                    return is_even() ? !meta::is_null(half_) : !meta::is_null(full_);
+                case fft_kind::Cosine:
+                case fft_kind::InverseCosine:
+                    return !meta::is_null(full_) && !cosine_.empty();
+                default:
+                    return !meta::is_null(full_);
+            }
+        }
+
+        inline void prepare_batch(fft_kind kind, const fft_batch_layout& layout, bool in_place) {
+            meta::unused(layout);
+            prepare(kind, in_place);
+            prepare_batch_buffers();
+        }
+
+        inline void dft(const complex_type* src, complex_type* dst) {
+            prepare_complex();
+            full_plan().forward(src, dst, scratch_.data());
+        }
+
+        inline void idft(const complex_type* src, complex_type* dst) {
+            prepare_complex();
+            full_plan().backward(src, dst, scratch_.data());
+        }
+
+        inline void dft(const value_type* src, complex_type* dst) {
+            prepare_real();
+            const auto bins = nfft_ / 2 + 1;
+            auto* buffer    = buffer_.data();
+            if (!is_even()) {
+                std::copy(src, src + nfft_, buffer);
+                full_plan().forward(buffer, buffer, scratch_.data());
+                std::copy_n(buffer, bins, dst);
+                return;
+            }
+
+            // The even and odd samples are packed as a complex signal of half the size.
+            const auto half = nfft_ / 2;
+            for (std::size_t i = 0; i < half; ++i) {
+                buffer[i] = complex_type(src[2 * i], src[2 * i + 1]);
+            }
+            half_plan().forward(buffer, buffer, scratch_.data());
+            const auto* twiddles = real_twiddles_.data();
+            for (std::size_t k = 0; k < bins; ++k) {
+                // Z[N/2] wraps around to Z[0]
+                const auto z    = internal::native_cast<A>(buffer[k == half ? 0 : k]);
+                const auto zc   = internal::native_cast<A>(std::conj(buffer[k == 0 ? 0 : half - k]));
+                const auto sum  = z + zc;
+                const auto diff = z - zc;
+                // even = (z + zc) / 2 and odd = (z - zc) / 2i
+                const wide_type even(sum.real() / 2, sum.imag() / 2);
+                const wide_type odd(diff.imag() / 2, -diff.real() / 2);
+                dst[k] = internal::native_cast<T>(even + internal::native_multiply(twiddles[k], odd));
+            }
+        }
+
+        inline void idft(const complex_type* src, value_type* dst) {
+            prepare_real();
+            auto* buffer = buffer_.data();
+            if (!is_even()) {
+                const auto bins = nfft_ / 2 + 1;
+                std::copy_n(src, bins, buffer);
+                for (std::size_t k = bins; k < nfft_; ++k) {
+                    buffer[k] = std::conj(src[nfft_ - k]);
+                }
+                full_plan().backward(buffer, buffer, scratch_.data());
+                for (std::size_t i = 0; i < nfft_; ++i) {
+                    dst[i] = buffer[i].real();
+                }
+                return;
+            }
+
+            const auto half      = nfft_ / 2;
+            const auto* twiddles = real_twiddles_.data();
+            for (std::size_t k = 0; k < half; ++k) {
+                // The DC and Nyquist bins of a real signal are real: their imaginary parts are ignored, as FFTW does.
+                const auto x   = internal::native_cast<A>((k == 0) ? complex_type(src[0].real(), 0) : src[k]);
+                const auto xc  = internal::native_cast<A>((k == 0) ? complex_type(src[half].real(), 0)
+                                                                   : std::conj(src[half - k]));
+                const auto odd = internal::native_multiply(std::conj(twiddles[k]), x - xc);
+                // Multiplication of the odd part by i
+                buffer[k] = internal::native_cast<T>((x + xc) + wide_type(-odd.imag(), odd.real()));
+            }
+            half_plan().backward(buffer, buffer, scratch_.data());
+            for (std::size_t i = 0; i < half; ++i) {
+                dst[2 * i]     = buffer[i].real();
+                dst[2 * i + 1] = buffer[i].imag();
+            }
+        }
+
+        inline void dht(const value_type* src, value_type* dst) {
+            prepare_real();
+            const auto bins = nfft_ / 2 + 1;
+            auto* spectrum  = spectrum_.data();
+            dft(src, spectrum);
+            for (std::size_t k = 0; k < nfft_; ++k) {
+                // The spectrum of a real signal is Hermitian: X[N - k] = conj(X[k])
+                const auto value = (k < bins) ? spectrum[k] : std::conj(spectrum[nfft_ - k]);
+                dst[k]           = value.real() - value.imag();
+            }
+        }
+
+        inline void dct(const value_type* src, value_type* dst) {
+            prepare_cosine();
+            auto* buffer       = buffer_.data();
+            const auto* cosine = cosine_.data();
+            const auto half    = (nfft_ + 1) / 2;
+            for (std::size_t i = 0; i < half; ++i) {
+                buffer[i] = src[2 * i];
+            }
+            for (std::size_t i = half; i < nfft_; ++i) {
+                buffer[i] = src[2 * (nfft_ - i) - 1];
+            }
+            full_plan().forward(buffer, buffer, scratch_.data());
+            for (std::size_t k = 0; k < nfft_; ++k) {
+                const auto value = internal::native_multiply(internal::native_cast<A>(buffer[k]), cosine[k]);
+                dst[k]           = static_cast<T>(2 * value.real());
+            }
+        }
+
+        inline void idct(const value_type* src, value_type* dst) {
+            prepare_cosine();
+            auto* buffer       = buffer_.data();
+            const auto* cosine = cosine_.data();
+            buffer[0]          = src[0];
+            for (std::size_t k = 1; k < nfft_; ++k) {
+                const wide_type value(src[k], -src[nfft_ - k]);
+                buffer[k] = internal::native_cast<T>(internal::native_multiply(std::conj(cosine[k]), value));
+            }
+            full_plan().backward(buffer, buffer, scratch_.data());
+            const auto half = (nfft_ + 1) / 2;
+            for (std::size_t i = 0; i < half; ++i) {
+                dst[2 * i] = buffer[i].real();
+            }
+            for (std::size_t i = half; i < nfft_; ++i) {
+                dst[2 * (nfft_ - i) - 1] = buffer[i].real();
+            }
+        }
+
+        inline void dft_batch(const complex_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const complex_type* in, complex_type* out) { dft(in, out); });
+        }
+
+        inline void idft_batch(const complex_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const complex_type* in, complex_type* out) { idft(in, out); });
+        }
+
+        inline void dft_batch(const value_type* src, complex_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_ / 2 + 1, layout,
+                  [this](const value_type* in, complex_type* out) { dft(in, out); });
+        }
+
+        inline void idft_batch(const complex_type* src, value_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_ / 2 + 1, dst, nfft_, layout,
+                  [this](const complex_type* in, value_type* out) { idft(in, out); });
+        }
+
+        inline void dht_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const value_type* in, value_type* out) { dht(in, out); });
+        }
+
+        inline void dct_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const value_type* in, value_type* out) { dct(in, out); });
+        }
+
+        inline void idct_batch(const value_type* src, value_type* dst, const fft_batch_layout& layout) {
+            batch(src, nfft_, dst, nfft_, layout, [this](const value_type* in, value_type* out) { idct(in, out); });
+        }
+
+        inline void idft_scale(value_type* dst) const {
+            const auto scaling = static_cast<value_type>(nfft_);
+            for (std::size_t i = 0; i < nfft_; ++i) {
+                dst[i] /= scaling;
+            }
+        }
+
+        inline void idft_scale(complex_type* dst) const {
+            const auto scaling = static_cast<value_type>(nfft_);
+            for (std::size_t i = 0; i < nfft_; ++i) {
+                dst[i] /= scaling;
+            }
+        }
+
+        inline void idct_scale(value_type* dst) const {
+            const auto scaling = static_cast<value_type>(2 * nfft_);
+            for (std::size_t i = 0; i < nfft_; ++i) {
+                dst[i] /= scaling;
+            }
+        }
+
+    private:
+        using plan_type = internal::native_fft_plan<T, A>;
+
+        bool is_even() const noexcept {
+            return nfft_ % 2 == 0;
+        }
+
+        const plan_type& full_plan() const noexcept {
+            return *static_cast<const plan_type*>(full_.get());
+        }
+
+        const plan_type& half_plan() const noexcept {
+            return *static_cast<const plan_type*>(half_.get());
+        }
+
+        static fft_plan_cache::plan_handle acquire(std::size_t size) {
+            // The plan type is used as precision, so the key never matches a plan of another backend.
+            const fft_plan_key key{size, typeid(plan_type), fft_kind::ComplexForward, fft_rigor::Estimate, false,
+                                   false};
+            return fft_plan_cache::instance().acquire(key, [size]() {
+                return fft_plan_cache::plan_handle(new plan_type(size),
+                                                   [](void* p) { delete static_cast<plan_type*>(p); });
+            });
+        }
+
+        void reserve(const fft_plan_cache::plan_handle& plan) {
+            const auto& current = *static_cast<const plan_type*>(plan.get());
+            if (scratch_.size() < std::max(current.scratch_size(), nfft_ / 2 + 1)) {
+                scratch_.resize(std::max(current.scratch_size(), nfft_ / 2 + 1));
+            }
+            if (buffer_.size() < nfft_) {
+                buffer_.resize(nfft_);
+            }
+        }
+
+        void prepare_complex() {
+            if (meta::is_null(full_)) {
+                full_ = acquire(nfft_);
+                reserve(full_);
+            }
+        }
+
+        void prepare_real() {
+            if (!is_even()) {
+                prepare_complex();
+            } else if (meta::is_null(half_)) {
+                half_ = acquire(nfft_ / 2);
+                reserve(half_);
+                real_twiddles_.resize(nfft_ / 2 + 1);
+                for (std::size_t k = 0; k < real_twiddles_.size(); ++k) {
+                    real_twiddles_[k] = internal::native_twiddle<A>(k, nfft_);
+                }
+            }
+            if (spectrum_.empty()) {
+                spectrum_.resize(nfft_ / 2 + 1);
+            }
+        }
+
+        void prepare_cosine() {
+            prepare_complex();
+            if (cosine_.empty()) {
+                cosine_.resize(nfft_);
+                for (std::size_t k = 0; k < nfft_; ++k) {
+                    cosine_[k] = internal::native_twiddle<A>(k, 4 * nfft_);
+                }
+            }
+        }
+
+        void prepare_batch_buffers() {
+            if (batch_input_.size() < 2 * nfft_) {
+                batch_input_.resize(2 * nfft_);
+                batch_output_.resize(2 * nfft_);
+            }
+        }
+
+        template <typename I, typename O, typename Transform>
+        inline void batch(const I* src, std::size_t isize, O* dst, std::size_t osize, const fft_batch_layout& layout,
+                          Transform transform) {
+            // Every transform is gathered into a contiguous buffer, computed and scattered back to its position.
+            prepare_batch_buffers();
+            auto* input  = reinterpret_cast<I*>(batch_input_.data());
+            auto* output = reinterpret_cast<O*>(batch_output_.data());
+            for (std::size_t i = 0; i < layout.howmany; ++i) {
+                const auto* first = src + i * layout.idist;
+                for (std::size_t j = 0; j < isize; ++j) {
+                    input[j] = first[j * layout.istride];
+                }
+                transform(input, output);
+                auto* last = dst + i * layout.odist;
+                for (std::size_t j = 0; j < osize; ++j) {
+                    last[j * layout.ostride] = output[j];
+                }
+            }
+        }
+
+        fft_plan_cache::plan_handle full_{};
+        fft_plan_cache::plan_handle half_{};
+        std::vector<complex_type> scratch_;
+        std::vector<complex_type> buffer_;
+        std::vector<complex_type> spectrum_;
+        std::vector<wide_type> real_twiddles_;
+        std::vector<wide_type> cosine_;
+        std::vector<complex_type> batch_input_;
+        std::vector<complex_type> batch_output_;
+        std::size_t nfft_;
+    };
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_NATIVE_FFT_IMPL_HPP
@@ -0,0 +1,584 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: partitioned_convolver.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_PARTITIONED_CONVOLVER_HPP
+#define EDSP_PARTITIONED_CONVOLVER_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @class partitioned_convolver
+     * @brief This class implements a real-time FFT convolution engine for long impulse responses.
+     *
+     * The impulse response is split in partitions whose spectra are computed once, during the construction. The
+     * input is processed in blocks of block_size samples with the overlap-save method: the spectrum of every block is
+     * stored in a frequency-domain delay line and multiplied by the spectra of the partitions. The latency of the
+     * engine is one block, independently of the length of the impulse response.
+     *
+     * In the uniform mode all the partitions have block_size samples. In the non-uniform mode the first partitions
+     * have block_size samples and the size of the following ones doubles up to max_block_size samples, reducing the
+     * number of spectral multiplications for long responses.
+     *
+     * A segment of large partitions starts far enough in the impulse response that its output is only due one large
+     * block after its input block is complete. Its transforms are computed with the four-step FFT algorithm, as
+     * short row and column transforms, and these transforms and the spectral products are spread evenly across the
+     * small blocks received in the meantime. The work per block is therefore bounded, there is no block computing a
+     * whole large FFT.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class partitioned_convolver {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %partitioned_convolver with the impulse response in the range [first, last).
+         * @param first Input iterator defining the beginning of the impulse response.
+         * @param last Input iterator defining the ending of the impulse response.
+         * @param block_size Number of samples processed in every block.
+         * @param max_block_size Maximum size of the partitions. If it is greater than the block size, the non-uniform
+         * partition mode is used. It should be a power of two multiple of the block size.
+         */
+        template <typename InputIt>
+        partitioned_convolver(InputIt first, InputIt last, size_type block_size, size_type max_block_size = 0);
+
+        /**
+         * @brief Returns the number of samples processed in every block.
+         * @return Block size.
+         */
+        size_type block_size() const noexcept;
+
+        /**
+         * @brief Returns the number of samples of the impulse response.
+         * @return Impulse response length.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Returns the total number of partitions of the impulse response.
+         * @return Number of partitions.
+         */
+        size_type partitions() const noexcept;
+
+        /**
+         * @brief Resets the delay lines of the engine, discarding any previous input.
+         */
+        void reset();
+
+        /**
+         * @brief Convolves the range [first, last) with the impulse response and stores the result in another range,
+         * beginning at d_first.
+         *
+         * The state is preserved between calls, so a long signal can be processed in several calls.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @note The number of input samples should be a multiple of the block size.
+         */
+        template <typename InputIt, typename OutputIt>
+        void process(InputIt first, InputIt last, OutputIt d_first);
+
+    private:
+        // Transforms of a segment spread across the small blocks. The complex FFT of block samples, computed from the
+        // 2 * block real samples packed in pairs, is split in rows x columns = block transforms.
+        struct pipeline {
+            explicit pipeline(size_type block);
+
+            static size_type split(size_type block);
+
+            size_type rows;
+            size_type columns;
+            fft_engine<T> row_engine;
+            fft_engine<T> column_engine;
+            std::vector<value_type> frozen;
+            std::vector<complex_type> matrix;
+            std::vector<complex_type> buffer;
+            std::vector<complex_type> row_input;
+            std::vector<complex_type> row_output;
+            std::vector<complex_type> column_input;
+            std::vector<complex_type> column_output;
+            std::vector<complex_type> twiddles;
+            std::vector<complex_type> real_twiddles;
+            size_type units;
+            size_type done{0};
+            size_type elapsed{0};
+            size_type start{0};
+            bool active{false};
+        };
+
+        struct segment {
+            segment(size_type block, size_type offset, size_type count, bool distributed);
+
+            template <typename InputIt>
+            void set_response(InputIt first, size_type length);
+
+            void reset();
+
+            fft_engine<T> engine;
+            std::vector<complex_type> response;
+            std::vector<complex_type> delay_line;
+            std::vector<complex_type> accumulator;
+            std::vector<complex_type> spectrum;
+            std::vector<value_type> input;
+            std::vector<value_type> output;
+            size_type block;
+            size_type offset;
+            size_type count;
+            size_type head{0};
+            size_type filled{0};
+            std::unique_ptr<pipeline> work;
+        };
+
+        // Complex multiplication without the NaN and infinity recovery of std::complex, which prevents the
+        // vectorization of the spectral products.
+        static complex_type multiply(const complex_type& a, const complex_type& b) {
+            return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+        }
+
+        void process_block();
+        void accumulate(segment& current, size_type from, size_type to);
+        void process_distributed(segment& current);
+        void run(segment& current, size_type unit);
+        void transform_row(segment& current, size_type row, bool backward);
+        void transform_column(segment& current, size_type column, bool backward);
+
+        std::vector<segment> segments_;
+        std::vector<value_type> block_;
+        std::vector<value_type> output_;
+        size_type block_size_;
+        size_type size_;
+        size_type time_{0};
+    };
+
+    template <typename T>
+    partitioned_convolver<T>::pipeline::pipeline(size_type block) :
+        rows(split(block)),
+        columns(block / rows),
+        row_engine(columns, {fft_kind::ComplexForward, fft_kind::ComplexBackward}),
+        column_engine(rows, {fft_kind::ComplexForward, fft_kind::ComplexBackward}),
+        frozen(2 * block, static_cast<value_type>(0)),
+        matrix(block),
+        buffer(block),
+        row_input(columns),
+        row_output(columns),
+        column_input(rows),
+        column_output(rows),
+        twiddles(block),
+        real_twiddles(block + 1) {
+        const auto pi = 3.141592653589793238462643383279502884L;
+        for (size_type i = 0; i < block; ++i) {
+            twiddles[i] = std::polar(static_cast<value_type>(1),
+                                     static_cast<value_type>(-2 * pi * static_cast<long double>(i) /
+                                                             static_cast<long double>(block)));
+        }
+        for (size_type i = 0; i <= block; ++i) {
+            real_twiddles[i] = std::polar(static_cast<value_type>(1),
+                                          static_cast<value_type>(-pi * static_cast<long double>(i) /
+                                                                  static_cast<long double>(block)));
+        }
+
+        // Forward rows and columns, spectrum chunks, inverse chunks, inverse rows and columns and output chunks. The
+        // chunks have as many bins as a row.
+        const auto chunks = [this](size_type count) { return (count + columns - 1) / columns; };
+        units             = 2 * (rows + columns) + chunks(block + 1) + chunks(block) + chunks(block / 2);
+    }
+
+    template <typename T>
+    typename partitioned_convolver<T>::size_type partitioned_convolver<T>::pipeline::split(size_type block) {
+        // The number of rows is the largest power of two dividing the block not greater than its square root.
+        size_type rows = 1;
+        while ((rows * 2) * (rows * 2) <= block && block % (rows * 2) == 0) {
+            rows *= 2;
+        }
+        return rows;
+    }
+
+    template <typename T>
+    partitioned_convolver<T>::segment::segment(size_type block, size_type offset, size_type count, bool distributed) :
+        engine(2 * block, {fft_kind::RealForward, fft_kind::RealBackward}),
+        response(count * (block + 1)),
+        delay_line(count * (block + 1)),
+        accumulator(block + 1),
+        spectrum(block + 1),
+        input(2 * block),
+        output(2 * block),
+        block(block),
+        offset(offset),
+        count(count),
+        work(distributed ? std::make_unique<pipeline>(block) : nullptr) {}
+
+    template <typename T>
+    template <typename InputIt>
+    void partitioned_convolver<T>::segment::set_response(InputIt first, size_type length) {
+        // The inverse FFT scaling is folded in the spectra of the partitions.
+        const auto scaling = static_cast<value_type>(2 * block);
+        for (size_type p = 0; p < count; ++p) {
+            const auto start = offset + p * block;
+            const auto end   = std::min(start + block, length);
+            std::fill(std::begin(input), std::end(input), static_cast<value_type>(0));
+            if (start < end) {
+                std::copy(std::next(first, start), std::next(first, end), std::begin(input));
+            }
+            auto* partition = response.data() + p * (block + 1);
+            engine.dft(input.data(), partition);
+            std::for_each(partition, partition + block + 1, [scaling](complex_type& value) { value /= scaling; });
+        }
+        reset();
+    }
+
+    template <typename T>
+    void partitioned_convolver<T>::segment::reset() {
+        std::fill(std::begin(delay_line), std::end(delay_line), complex_type{});
+        std::fill(std::begin(accumulator), std::end(accumulator), complex_type{});
+        std::fill(std::begin(input), std::end(input), static_cast<value_type>(0));
+        head   = 0;
+        filled = 0;
+        if (work) {
+            std::fill(std::begin(work->frozen), std::end(work->frozen), static_cast<value_type>(0));
+            work->done    = 0;
+            work->elapsed = 0;
+            work->active  = false;
+        }
+    }
+
+    template <typename T>
+    template <typename InputIt>
+    partitioned_convolver<T>::partitioned_convolver(InputIt first, InputIt last, size_type block_size,
+                                                    size_type max_block_size) :
+        block_(block_size),
+        block_size_(block_size),
+        size_(static_cast<size_type>(std::distance(first, last))) {
+        meta::expects(block_size > 0, "The block size should be greater than zero");
+        meta::expects(size_ > 0, "Not expecting an empty impulse response");
+        max_block_size = std::max(max_block_size, block_size);
+        meta::expects(max_block_size % block_size == 0,
+                      "The maximum block size should be a multiple of the block size");
+
+        // Every segment starts where the previous one ends. The output of a segment of N samples is available N
+        // samples after the beginning of its input block, so it can only cover the response from N - block_size on.
+        constexpr size_type partitions_per_segment = 4;
+        size_type offset                           = 0;
+        size_type block                            = block_size;
+        size_type maximum_segments                 = 1;
+        for (auto partition = block_size; partition * 2 <= max_block_size; partition *= 2) {
+            ++maximum_segments;
+        }
+        segments_.reserve(maximum_segments);
+        while (offset < size_) {
+            const bool last_segment = block * 2 > max_block_size;
+            const auto remaining    = (size_ - offset + block - 1) / block;
+            const auto count        = last_segment ? remaining : std::min(remaining, partitions_per_segment);
+            // The output of a segment is due one block later if it covers the response from 2 * N - block_size on.
+            const bool distributed = block > block_size && offset + block_size >= 2 * block;
+            segments_.emplace_back(block, offset, count, distributed);
+            offset += count * block;
+            block = last_segment ? block : block * 2;
+        }
+
+        size_type extent = 0;
+        for (auto& current : segments_) {
+            current.set_response(first, size_);
+            extent = std::max(extent, current.offset + current.block);
+        }
+        output_.resize(extent + block_size_, static_cast<value_type>(0));
+    }
+
+    template <typename T>
+    typename partitioned_convolver<T>::size_type partitioned_convolver<T>::block_size() const noexcept {
+        return block_size_;
+    }
+
+    template <typename T>
+    typename partitioned_convolver<T>::size_type partitioned_convolver<T>::size() const noexcept {
+        return size_;
+    }
+
+    template <typename T>
+    typename partitioned_convolver<T>::size_type partitioned_convolver<T>::partitions() const noexcept {
+        size_type total = 0;
+        for (const auto& current : segments_) {
+            total += current.count;
+        }
+        return total;
+    }
+
+    template <typename T>
+    void partitioned_convolver<T>::reset() {
+        for (auto& current : segments_) {
+            current.reset();
+        }
+        std::fill(std::begin(output_), std::end(output_), static_cast<value_type>(0));
+        time_ = 0;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    void partitioned_convolver<T>::process(InputIt first, InputIt last, OutputIt d_first) {
+        const auto size = static_cast<size_type>(std::distance(first, last));
+        meta::expects(size % block_size_ == 0, "The number of samples should be a multiple of the block size");
+        for (size_type i = 0; i < size; i += block_size_) {
+            std::copy_n(first, block_size_, std::begin(block_));
+            std::advance(first, block_size_);
+            process_block();
+
+            // The ring stores the output indexed by absolute time, the block just processed ends at time_.
+            const auto length = output_.size();
+            for (size_type j = 0; j < block_size_; ++j, ++d_first) {
+                auto& sample = output_[(time_ - block_size_ + j) % length];
+                *d_first     = sample;
+                sample       = 0;
+            }
+        }
+    }
+
+    template <typename T>
+    void partitioned_convolver<T>::accumulate(segment& current, size_type from, size_type to) {
+        // Accumulates the contribution of the partitions [from, to) for the next output block of the segment. The
+        // partition p is multiplied by the spectrum stored p - 1 blocks ago, as the new block is not stored yet.
+        const auto bins = current.block + 1;
+        for (size_type p = from; p < to; ++p) {
+            const auto slot           = (current.head + current.count - (p - 1)) % current.count;
+            const auto* input_bins    = current.delay_line.data() + slot * bins;
+            const auto* response_bins = current.response.data() + p * bins;
+            for (size_type k = 0; k < bins; ++k) {
+                current.accumulator[k] += multiply(input_bins[k], response_bins[k]);
+            }
+        }
+    }
+
+    template <typename T>
+    void partitioned_convolver<T>::process_block() {
+        time_ += block_size_;
+        const auto length = output_.size();
+        for (auto& current : segments_) {
+            if (current.work) {
+                process_distributed(current);
+                continue;
+            }
+
+            const auto position = current.block + current.filled;
+            std::copy(std::cbegin(block_), std::cend(block_), std::begin(current.input) + position);
+            current.filled += block_size_;
+
+            // The tail partitions only depend on previous blocks, their accumulation is spread across the small
+            // blocks received while the segment collects a complete block.
+            const auto steps = current.block / block_size_;
+            const auto step  = current.filled / block_size_;
+            const auto tail  = current.count - 1;
+            accumulate(current, 1 + (step - 1) * tail / steps, 1 + step * tail / steps);
+            if (current.filled < current.block) {
+                continue;
+            }
+
+            const auto bins = current.block + 1;
+            current.head    = (current.head + 1) % current.count;
+            auto* stored    = current.delay_line.data() + current.head * bins;
+            current.engine.dft(current.input.data(), stored);
+            for (size_type k = 0; k < bins; ++k) {
+                current.spectrum[k] = current.accumulator[k] + multiply(stored[k], current.response[k]);
+            }
+            current.engine.idft(current.spectrum.data(), current.output.data());
+
+            // The valid samples of the overlap-save block correspond to the input [time_ - block, time_) and are
+            // delayed by the offset of the segment in the impulse response.
+            const auto start = time_ - current.block + current.offset;
+            for (size_type j = 0; j < current.block; ++j) {
+                output_[(start + j) % length] += current.output[current.block + j];
+            }
+
+            std::copy(std::cbegin(current.input) + current.block, std::cend(current.input), std::begin(current.input));
+            std::fill(std::begin(current.accumulator), std::end(current.accumulator), complex_type{});
+            current.filled = 0;
+        }
+    }
+
+    template <typename T>
+    void partitioned_convolver<T>::process_distributed(segment& current) {
+        // The first half of the input block being collected is the second half of the block being transformed.
+        auto& work = *current.work;
+        std::copy_n(std::cbegin(work.frozen) + current.block + current.filled, block_size_,
+                    std::begin(current.input) + current.filled);
+        std::copy(std::cbegin(block_), std::cend(block_), std::begin(current.input) + current.block + current.filled);
+        current.filled += block_size_;
+
+        // The transforms of the previous block are spread across the small blocks of the current one, so they are
+        // complete when the segment collects a new block.
+        if (work.active) {
+            ++work.elapsed;
+            const auto target = work.units * work.elapsed / (current.block / block_size_);
+            for (; work.done < target; ++work.done) {
+                run(current, work.done);
+            }
+        }
+        if (current.filled < current.block) {
+            return;
+        }
+
+        // The valid samples of the overlap-save block correspond to the input [time_ - block, time_) and are delayed
+        // by the offset of the segment in the impulse response.
+        std::swap(current.input, work.frozen);
+        current.head   = (current.head + 1) % current.count;
+        current.filled = 0;
+        work.start     = time_ - current.block + current.offset;
+        work.done      = 0;
+        work.elapsed   = 0;
+        work.active    = true;
+    }
+
+    template <typename T>
+    void partitioned_convolver<T>::run(segment& current, size_type unit) {
+        auto& work       = *current.work;
+        const auto block = current.block;
+        const auto bins  = block + 1;
+        const auto chunk = work.columns;
+        const auto chunks = [chunk](size_type count) { return (count + chunk - 1) / chunk; };
+        if (unit < work.rows) {
+            transform_row(current, unit, false);
+            return;
+        }
+        unit -= work.rows;
+        if (unit < work.columns) {
+            transform_column(current, unit, false);
+            return;
+        }
+        unit -= work.columns;
+
+        if (unit < chunks(bins)) {
+            // Spectrum of the real block from the transform of its samples packed in pairs, stored in the delay line,
+            // and accumulation of the products of all the partitions.
+            const auto first = unit * chunk;
+            const auto last  = std::min(first + chunk, bins);
+            auto* stored     = current.delay_line.data() + current.head * bins;
+            for (auto k = first; k < last; ++k) {
+                const auto z    = work.buffer[k == block ? 0 : k];
+                const auto zc   = std::conj(work.buffer[k == 0 ? 0 : block - k]);
+                const auto sum  = z + zc;
+                const auto diff = z - zc;
+                const complex_type even(sum.real() / 2, sum.imag() / 2);
+                const complex_type odd(diff.imag() / 2, -diff.real() / 2);
+                stored[k]           = even + multiply(work.real_twiddles[k], odd);
+                current.spectrum[k] = complex_type{};
+            }
+            for (size_type p = 0; p < current.count; ++p) {
+                const auto slot           = (current.head + current.count - p) % current.count;
+                const auto* input_bins    = current.delay_line.data() + slot * bins;
+                const auto* response_bins = current.response.data() + p * bins;
+                for (auto k = first; k < last; ++k) {
+                    current.spectrum[k] += multiply(input_bins[k], response_bins[k]);
+                }
+            }
+            return;
+        }
+        unit -= chunks(bins);
+
+        if (unit < chunks(block)) {
+            // Spectrum of the samples packed in pairs from the Hermitian spectrum, whose DC and Nyquist bins are real.
+            const auto first = unit * chunk;
+            const auto last  = std::min(first + chunk, block);
+            for (auto k = first; k < last; ++k) {
+                const auto x   = (k == 0) ? complex_type(current.spectrum[0].real(), 0) : current.spectrum[k];
+                const auto xc  = (k == 0) ? complex_type(current.spectrum[block].real(), 0)
+                                          : std::conj(current.spectrum[block - k]);
+                const auto odd = multiply(std::conj(work.real_twiddles[k]), x - xc);
+                work.buffer[k] = (x + xc) + complex_type(-odd.imag(), odd.real());
+            }
+            return;
+        }
+        unit -= chunks(block);
+
+        if (unit < work.rows) {
+            transform_row(current, unit, true);
+            return;
+        }
+        unit -= work.rows;
+        if (unit < work.columns) {
+            transform_column(current, unit, true);
+            return;
+        }
+        unit -= work.columns;
+
+        // Only the second half of the overlap-save block is valid, the pairs of samples from block / 2 on.
+        const auto length = output_.size();
+        const auto first  = block / 2 + unit * chunk;
+        const auto last   = std::min(first + chunk, block);
+        for (auto n = first; n < last; ++n) {
+            const auto j = work.start + 2 * n - block;
+            output_[j % length] += work.buffer[n].real();
+            output_[(j + 1) % length] += work.buffer[n].imag();
+        }
+    }
+
+    template <typename T>
+    void partitioned_convolver<T>::transform_row(segment& current, size_type row, bool backward) {
+        // First step of the four-step algorithm: transform of the samples row, row + rows, row + 2 * rows...
+        // multiplied by the twiddle factors of the complete transform.
+        auto& work = *current.work;
+        for (size_type n = 0; n < work.columns; ++n) {
+            const auto index  = n * work.rows + row;
+            work.row_input[n] = backward ? work.buffer[index]
+                                         : complex_type(work.frozen[2 * index], work.frozen[2 * index + 1]);
+        }
+        if (backward) {
+            work.row_engine.idft(work.row_input.data(), work.row_output.data());
+        } else {
+            work.row_engine.dft(work.row_input.data(), work.row_output.data());
+        }
+        auto* destination = work.matrix.data() + row * work.columns;
+        for (size_type k = 0, index = 0; k < work.columns; ++k, index += row) {
+            const auto twiddle = work.twiddles[index];
+            destination[k]     = multiply(work.row_output[k], backward ? std::conj(twiddle) : twiddle);
+        }
+    }
+
+    template <typename T>
+    void partitioned_convolver<T>::transform_column(segment& current, size_type column, bool backward) {
+        // Second step of the four-step algorithm: transform across the rows, whose results are the bins column,
+        // column + columns, column + 2 * columns...
+        auto& work = *current.work;
+        for (size_type n = 0; n < work.rows; ++n) {
+            work.column_input[n] = work.matrix[n * work.columns + column];
+        }
+        if (backward) {
+            work.column_engine.idft(work.column_input.data(), work.column_output.data());
+        } else {
+            work.column_engine.dft(work.column_input.data(), work.column_output.data());
+        }
+        for (size_type k = 0; k < work.rows; ++k) {
+            work.buffer[column + k * work.columns] = work.column_output[k];
+        }
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_PARTITIONED_CONVOLVER_HPP
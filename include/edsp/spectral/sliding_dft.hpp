@@ -0,0 +1,344 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: sliding_dft.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_SLIDING_DFT_HPP
+#define EDSP_SLIDING_DFT_HPP
+
+#include <edsp/types/ring_buffer.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @brief The SlidingDftMode enum defines how the bins of a sliding_dft are updated.
+     */
+    enum class SlidingDftMode {
+        Recursive, /*!< Classic sliding DFT, the bins are rotated by their twiddle factor every sample */
+        Modulated  /*!< Modulated sliding DFT, the input is modulated instead, from an exact table of twiddle factors */
+    };
+
+    /**
+     * @class sliding_dft
+     * @brief This class implements a Sliding Discrete Fourier Transform (SDFT) of a selected set of bins.
+     *
+     * The SDFT computes the DFT of the last N input samples every time a new sample arrives, but only for the selected
+     * bins. Every update costs O(bins) operations, instead of the O(N log N) of a FFT of the whole window:
+     *
+     * \f[
+     *  X_k[n] = e^{j 2 \pi k / N} \left( X_k[n - 1] + x[n] - x[n - N] \right)
+     * \f]
+     *
+     * The recursive form accumulates the rounding errors of the twiddle factors in every update. In the modulated
+     * mode, the input is multiplied by the twiddle factor of its absolute position, taken from an exact table, and
+     * the phase is corrected only when the bins are read. The twiddle factors are then exact, but the additions of the
+     * accumulators still round, and their error grows as a random walk with the number of updates. In both modes, a
+     * second set of accumulators computes the DFT of the next window from scratch, one sample per update, and
+     * replaces the bins every N samples. The error never accumulates over more than two windows, and every update
+     * keeps a bounded cost of O(bins), without the O(N * bins) burst of a recomputation from the window.
+     *
+     * The bins are stored in separate arrays of real and imaginary parts, so the update loop is vectorized across the
+     * bins by the compiler. The result of %magnitude can be used as input of the spectral feature extractors.
+     *
+     * @tparam T Floating point type.
+     * @tparam Allocator Allocator type of the window, defaults to std::allocator<T>.
+     */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class sliding_dft {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %sliding_dft tracking the bins in the range [first, last).
+         * @param size Number of samples of the sliding window, the size N of the DFT.
+         * @param first Input iterator defining the beginning of the range of bin indexes.
+         * @param last Input iterator defining the ending of the range of bin indexes.
+         * @param mode Update mode of the bins.
+         */
+        template <typename InputIt>
+        sliding_dft(size_type size, InputIt first, InputIt last, SlidingDftMode mode = SlidingDftMode::Modulated);
+
+        /**
+         * @brief Returns the number of samples of the sliding window.
+         * @return Size of the DFT.
+         */
+        size_type size() const noexcept;
+
+        /**
+         * @brief Returns the number of tracked bins.
+         * @return Number of bins.
+         */
+        size_type bins() const noexcept;
+
+        /**
+         * @brief Returns the DFT index of the i-th tracked bin.
+         * @param i Position of the bin.
+         * @return Index of the bin in the DFT.
+         */
+        size_type index(size_type i) const;
+
+        /**
+         * @brief Resets the window and the bins.
+         */
+        void reset();
+
+        /**
+         * @brief Updates the bins with a new sample.
+         * @param tick Input sample.
+         */
+        void update(value_type tick);
+
+        /**
+         * @brief Updates the bins with the samples in the range [first, last).
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         */
+        template <typename InputIt>
+        void update(InputIt first, InputIt last);
+
+        /**
+         * @brief Recomputes the bins from the samples of the window, discarding the accumulated rounding errors.
+         *
+         * The bins are already replaced every N samples by the DFT of the window computed during the updates, so it
+         * is never needed while streaming. It costs O(N) operations per bin.
+         */
+        void resynchronize();
+
+        /**
+         * @brief Returns the current value of the i-th tracked bin.
+         * @param i Position of the bin.
+         * @return DFT of the last size() samples at the bin.
+         */
+        complex_type operator[](size_type i) const;
+
+        /**
+         * @brief Stores the current value of the tracked bins in the range beginning at d_first.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename OutputIt>
+        OutputIt spectrum(OutputIt d_first) const;
+
+        /**
+         * @brief Stores the magnitude of the tracked bins in the range beginning at d_first.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename OutputIt>
+        OutputIt magnitude(OutputIt d_first) const;
+
+    private:
+        edsp::ring_buffer<T, Allocator> window_;
+        std::vector<size_type> indexes_;
+        std::vector<size_type> phases_;
+        std::vector<value_type> table_real_;
+        std::vector<value_type> table_imag_;
+        std::vector<value_type> twiddle_real_;
+        std::vector<value_type> twiddle_imag_;
+        std::vector<value_type> real_;
+        std::vector<value_type> imag_;
+        std::vector<size_type> shadow_phases_;
+        std::vector<value_type> shadow_real_;
+        std::vector<value_type> shadow_imag_;
+        size_type elapsed_{0};
+        SlidingDftMode mode_;
+    };
+
+    template <typename T, typename Allocator>
+    template <typename InputIt>
+    sliding_dft<T, Allocator>::sliding_dft(size_type size, InputIt first, InputIt last, SlidingDftMode mode) :
+        window_(size, T()),
+        indexes_(first, last),
+        phases_(indexes_.size(), 0),
+        table_real_(size),
+        table_imag_(size),
+        twiddle_real_(indexes_.size()),
+        twiddle_imag_(indexes_.size()),
+        real_(indexes_.size(), 0),
+        imag_(indexes_.size(), 0),
+        shadow_phases_(indexes_.size(), 0),
+        shadow_real_(indexes_.size(), 0),
+        shadow_imag_(indexes_.size(), 0),
+        mode_(mode) {
+        meta::expects(size > 0, "The size of the window should be greater than zero");
+        // The table stores exp(-j 2 pi i / N), the twiddle factor of every absolute position.
+        for (size_type i = 0; i < size; ++i) {
+            const auto angle = -2 * 3.141592653589793238462643383279502884L * static_cast<long double>(i) /
+                               static_cast<long double>(size);
+            table_real_[i] = static_cast<value_type>(std::cos(angle));
+            table_imag_[i] = static_cast<value_type>(std::sin(angle));
+        }
+        for (size_type i = 0; i < indexes_.size(); ++i) {
+            meta::expects(indexes_[i] < size, "The bin indexes should be lower than the size of the window");
+            // The recursive mode rotates the bins by exp(j 2 pi k / N)
+            twiddle_real_[i] = table_real_[indexes_[i]];
+            twiddle_imag_[i] = -table_imag_[indexes_[i]];
+        }
+    }
+
+    template <typename T, typename Allocator>
+    typename sliding_dft<T, Allocator>::size_type sliding_dft<T, Allocator>::size() const noexcept {
+        return window_.capacity();
+    }
+
+    template <typename T, typename Allocator>
+    typename sliding_dft<T, Allocator>::size_type sliding_dft<T, Allocator>::bins() const noexcept {
+        return indexes_.size();
+    }
+
+    template <typename T, typename Allocator>
+    typename sliding_dft<T, Allocator>::size_type sliding_dft<T, Allocator>::index(size_type i) const {
+        return indexes_[i];
+    }
+
+    template <typename T, typename Allocator>
+    void sliding_dft<T, Allocator>::reset() {
+        std::fill(std::begin(window_), std::end(window_), T());
+        std::fill(std::begin(phases_), std::end(phases_), 0);
+        std::fill(std::begin(real_), std::end(real_), 0);
+        std::fill(std::begin(imag_), std::end(imag_), 0);
+        std::fill(std::begin(shadow_phases_), std::end(shadow_phases_), 0);
+        std::fill(std::begin(shadow_real_), std::end(shadow_real_), 0);
+        std::fill(std::begin(shadow_imag_), std::end(shadow_imag_), 0);
+        elapsed_ = 0;
+    }
+
+    template <typename T, typename Allocator>
+    void sliding_dft<T, Allocator>::update(value_type tick) {
+        const auto delta = tick - window_.front();
+        window_.push_back(tick);
+
+        const auto count  = indexes_.size();
+        const auto size   = window_.capacity();
+        const auto* tr    = table_real_.data();
+        const auto* ti    = table_imag_.data();
+        const auto* index = indexes_.data();
+        auto* real        = real_.data();
+        auto* imag        = imag_.data();
+        auto* shadow_real = shadow_real_.data();
+        auto* shadow_imag = shadow_imag_.data();
+        if (mode_ == SlidingDftMode::Recursive) {
+            // The shadow accumulators sum the samples since the beginning of the next window, the first one with the
+            // phase 0, as the bins of the recursive mode.
+            const auto* wr = twiddle_real_.data();
+            const auto* wi = twiddle_imag_.data();
+            auto* phase    = shadow_phases_.data();
+            for (size_type i = 0; i < count; ++i) {
+                const auto re = real[i] + delta;
+                const auto im = imag[i];
+                real[i]       = re * wr[i] - im * wi[i];
+                imag[i]       = re * wi[i] + im * wr[i];
+                shadow_real[i] += tick * tr[phase[i]];
+                shadow_imag[i] += tick * ti[phase[i]];
+                phase[i] += index[i];
+                phase[i] = (phase[i] >= size) ? phase[i] - size : phase[i];
+            }
+        } else {
+            // The window samples keep the modulation of their absolute position, x[n] - x[n - N] shares the same one,
+            // and so do the samples summed by the shadow accumulators.
+            auto* phase = phases_.data();
+            for (size_type i = 0; i < count; ++i) {
+                real[i] += delta * tr[phase[i]];
+                imag[i] += delta * ti[phase[i]];
+                shadow_real[i] += tick * tr[phase[i]];
+                shadow_imag[i] += tick * ti[phase[i]];
+                phase[i] += index[i];
+                phase[i] = (phase[i] >= size) ? phase[i] - size : phase[i];
+            }
+        }
+
+        // After N samples, the shadow accumulators hold the DFT of the window computed from scratch.
+        if (++elapsed_ == size) {
+            real_.swap(shadow_real_);
+            imag_.swap(shadow_imag_);
+            std::fill(std::begin(shadow_real_), std::end(shadow_real_), 0);
+            std::fill(std::begin(shadow_imag_), std::end(shadow_imag_), 0);
+            std::fill(std::begin(shadow_phases_), std::end(shadow_phases_), 0);
+            elapsed_ = 0;
+        }
+    }
+
+    template <typename T, typename Allocator>
+    template <typename InputIt>
+    void sliding_dft<T, Allocator>::update(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            update(*first);
+        }
+    }
+
+    template <typename T, typename Allocator>
+    void sliding_dft<T, Allocator>::resynchronize() {
+        // The window is stored from the oldest sample. In the recursive mode the oldest sample has the phase 0, in the
+        // modulated mode it keeps the modulation of its absolute position, which is the next modulation index.
+        const auto size = window_.capacity();
+        for (size_type i = 0; i < indexes_.size(); ++i) {
+            auto phase = (mode_ == SlidingDftMode::Recursive) ? size_type{0} : phases_[i];
+            auto re    = static_cast<value_type>(0);
+            auto im    = static_cast<value_type>(0);
+            for (const auto sample : window_) {
+                re += sample * table_real_[phase];
+                im += sample * table_imag_[phase];
+                phase += indexes_[i];
+                phase = (phase >= size) ? phase - size : phase;
+            }
+            real_[i] = re;
+            imag_[i] = im;
+        }
+    }
+
+    template <typename T, typename Allocator>
+    typename sliding_dft<T, Allocator>::complex_type sliding_dft<T, Allocator>::operator[](size_type i) const {
+        const complex_type value(real_[i], imag_[i]);
+        if (mode_ == SlidingDftMode::Recursive) {
+            return value;
+        }
+        // The oldest sample of the window has the phase k (n + 1) mod N, which is the next modulation index.
+        return value * complex_type(table_real_[phases_[i]], -table_imag_[phases_[i]]);
+    }
+
+    template <typename T, typename Allocator>
+    template <typename OutputIt>
+    OutputIt sliding_dft<T, Allocator>::spectrum(OutputIt d_first) const {
+        for (size_type i = 0; i < indexes_.size(); ++i, ++d_first) {
+            *d_first = (*this)[i];
+        }
+        return d_first;
+    }
+
+    template <typename T, typename Allocator>
+    template <typename OutputIt>
+    OutputIt sliding_dft<T, Allocator>::magnitude(OutputIt d_first) const {
+        // The modulation only changes the phase of the bins.
+        for (size_type i = 0; i < indexes_.size(); ++i, ++d_first) {
+            *d_first = std::hypot(real_[i], imag_[i]);
+        }
+        return d_first;
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_SLIDING_DFT_HPP
@@ -0,0 +1,170 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: spectral_workspace.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_SPECTRAL_WORKSPACE_HPP
+#define EDSP_SPECTRAL_WORKSPACE_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/meta/expects.hpp>
+#include <complex>
+#include <memory>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @class spectral_workspace
+     * @brief This class stores the temporary buffers and FFT engines used by the spectral functions.
+     *
+     * The spectral functions (conv, xcorr, cepstrum, spectrum and hilbert) need several temporary buffers per call.
+     * Their overloads taking a %spectral_workspace reuse the memory of the workspace instead, so once the workspace
+     * is prepared they never allocate and can be used in a real-time thread.
+     *
+     * A workspace serves inputs of a fixed number of samples, the one given in the constructor.
+     *
+     * @tparam T Floating point type.
+     * @tparam RAllocator Allocator of the real buffers, defaults to std::allocator<T>.
+     * @tparam CAllocator Allocator of the complex buffers, defaults to std::allocator<std::complex<T>>.
+     */
+    template <typename T, typename RAllocator = std::allocator<T>,
+              typename CAllocator = std::allocator<std::complex<T>>>
+    class spectral_workspace {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+        using real_buffer    = std::vector<value_type, RAllocator>;
+        using complex_buffer = std::vector<complex_type, CAllocator>;
+
+        /**
+         * @brief Returns the number of samples of the real buffers needed to process inputs of the given size.
+         *
+         * The workspace stores two real buffers of required_size(size) samples and two complex buffers of
+         * required_size(size) / 2 + 1 samples.
+         * @param size Number of samples of the inputs.
+         * @return Number of samples of every real buffer.
+         */
+        static constexpr size_type required_size(size_type size) noexcept {
+            return 2 * size;
+        }
+
+        /**
+         * @brief Creates a %spectral_workspace for inputs of the given size.
+         * @param size Number of samples of the inputs.
+         */
+        explicit spectral_workspace(size_type size) :
+            real1_(required_size(size)),
+            real2_(required_size(size)),
+            complex1_(make_fft_size(required_size(size))),
+            complex2_(make_fft_size(required_size(size))),
+            size_(size) {
+            meta::expects(size > 0, "Not expecting empty input");
+        }
+
+        /**
+         * @brief Returns the number of samples of the inputs served by the workspace.
+         * @return Size of the inputs.
+         */
+        constexpr size_type size() const noexcept {
+            return size_;
+        }
+
+        /**
+         * @brief Creates in advance the FFT engines and plans used by the spectral functions.
+         *
+         * Without calling this function, they are created the first time they are needed.
+         */
+        void prepare() {
+            padded_engine().prepare(fft_kind::RealForward);
+            padded_engine().prepare(fft_kind::RealBackward);
+            engine().prepare(fft_kind::RealForward);
+            engine().prepare(fft_kind::ComplexForward);
+            engine().prepare(fft_kind::ComplexBackward);
+        }
+
+        /**
+         * @brief Returns the FFT engine of size() samples.
+         * @return Reference to the engine.
+         */
+        fft_engine<T>& engine() {
+            if (!engine_) {
+                engine_ = std::make_unique<fft_engine<T>>(size_);
+            }
+            return *engine_;
+        }
+
+        /**
+         * @brief Returns the FFT engine of required_size(size()) samples, used with zero-padded inputs.
+         * @return Reference to the engine.
+         */
+        fft_engine<T>& padded_engine() {
+            if (!padded_engine_) {
+                padded_engine_ = std::make_unique<fft_engine<T>>(required_size(size_));
+            }
+            return *padded_engine_;
+        }
+
+        /**
+         * @brief Returns the first real buffer.
+         * @return Reference to the buffer.
+         */
+        real_buffer& real1() noexcept {
+            return real1_;
+        }
+
+        /**
+         * @brief Returns the second real buffer.
+         * @return Reference to the buffer.
+         */
+        real_buffer& real2() noexcept {
+            return real2_;
+        }
+
+        /**
+         * @brief Returns the first complex buffer.
+         * @return Reference to the buffer.
+         */
+        complex_buffer& complex1() noexcept {
+            return complex1_;
+        }
+
+        /**
+         * @brief Returns the second complex buffer.
+         * @return Reference to the buffer.
+         */
+        complex_buffer& complex2() noexcept {
+            return complex2_;
+        }
+
+    private:
+        std::unique_ptr<fft_engine<T>> engine_;
+        std::unique_ptr<fft_engine<T>> padded_engine_;
+        real_buffer real1_;
+        real_buffer real2_;
+        complex_buffer complex1_;
+        complex_buffer complex2_;
+        size_type size_;
+    };
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_SPECTRAL_WORKSPACE_HPP
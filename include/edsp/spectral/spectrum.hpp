@@ -23,12 +23,58 @@
 #define EDSP_SPECTROGRAM_HPP
 
 #include <edsp/spectral/dft.hpp>
+#include <edsp/spectral/spectral_workspace.hpp>
 #include <edsp/converter/mag2db.hpp>
 #include <edsp/math/numeric.hpp>
 #include <vector>
 
 namespace edsp { inline namespace spectral {
 
+    namespace internal {
+
+        // The buffers hold at least N real samples and N / 2 + 1 complex samples.
+        template <typename InputIt, typename OutputIt, typename T, typename RBuffer, typename CBuffer>
+        inline void spectrum(InputIt first, InputIt last, OutputIt d_first, fft_engine<T>& engine,
+                             RBuffer& temp_input, CBuffer& fft_data) {
+            const auto size = std::distance(first, last);
+            std::copy(first, last, std::begin(temp_input));
+            engine.dft(meta::data(temp_input), meta::data(fft_data));
+            std::transform(std::cbegin(fft_data), std::cbegin(fft_data) + make_fft_size(size), d_first,
+                           [](const auto val) { return math::square(std::abs(val)); });
+        }
+
+    } // namespace internal
+
+    /**
+     * @brief Computes the spectrum of the range [first, last) and stores the result in another range, beginning at d_first.
+     *
+     * The spectrum is an estimate of the spectral density of a signal.
+     *
+     * \f[
+     *
+     *  {\displaystyle S\left({\tfrac {k}{NT}}\right)=\left|\sum _{n}x_{N}[n]\cdot e^{-i2\pi {\frac {kn}{N}}}\right|^{2}}
+     *
+     * \f]
+     *
+     * where T, is the inverse of the sample rate \f$ f_s \f$.
+     *
+     * This overload does not allocate any memory: all the temporary buffers are taken from the workspace.
+     *
+     * @param first Input iterator defining the beginning of the input range.
+     * @param last Input iterator defining the ending of the input range.
+     * @param d_first Output iterator defining the beginning of the destination range.
+     * @param workspace Workspace created for inputs of std::distance(first, last) samples.
+     */
+    template <typename InputIt, typename OutputIt, typename T, typename RAllocator, typename CAllocator>
+    inline void spectrum(InputIt first, InputIt last, OutputIt d_first,
+                         spectral_workspace<T, RAllocator, CAllocator>& workspace) {
+        const auto size = std::distance(first, last);
+        meta::expects(size > 0, "Not expecting empty input");
+        meta::expects(static_cast<std::size_t>(size) == workspace.size(),
+                      "The workspace size does not match the input");
+        internal::spectrum(first, last, d_first, workspace.engine(), workspace.real1(), workspace.complex1());
+    }
+
     /**
      * @brief Computes the spectrum of the range [first, last) and stores the result in another range, beginning at d_first.
      *
@@ -45,18 +91,17 @@ namespace edsp { inline namespace spectral {
      * @param first Input iterator defining the beginning of the input range.
      * @param last Input iterator defining the ending of the input range.
      * @param d_first Output iterator defining the beginning of the destination range.
-     * @param scale  Scale to be used in the output
      */
     template <typename InputIt, typename OutputIt,
               typename Allocator = std::allocator<std::complex<meta::value_type_t<OutputIt>>>>
     inline void spectrum(InputIt first, InputIt last, OutputIt d_first) {
         meta::expects(std::distance(first, last) > 0, "Not expecting empty input");
         using value_type = meta::value_type_t<InputIt>;
-        const auto size  = std::distance(first, last);
-        std::vector<std::complex<value_type>, Allocator> fft_data_(make_fft_size(size));
-        dft(first, last, std::begin(fft_data_));
-        std::transform(std::cbegin(fft_data_), std::cend(fft_data_), d_first,
-                       [](const auto val) { return math::square(std::abs(val)); });
+        const auto size  = static_cast<std::size_t>(std::distance(first, last));
+        fft_engine<value_type> engine(size);
+        std::vector<value_type> temp_input(size);
+        std::vector<std::complex<value_type>, Allocator> fft_data(make_fft_size(size));
+        internal::spectrum(first, last, d_first, engine, temp_input, fft_data);
     }
 
 }} // namespace edsp::spectral
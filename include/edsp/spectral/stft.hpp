@@ -0,0 +1,374 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: stft.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_STFT_HPP
+#define EDSP_STFT_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/windowing.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <complex>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @class stft
+     * @brief This class implements a streaming Short-Time Fourier Transform (STFT).
+     *
+     * The input signal is split in overlapping frames of frame_size samples, separated by hop_size samples. Every
+     * frame is windowed, zero-padded to nfft samples and transformed with a Real-to-Complex FFT, producing
+     * nfft / 2 + 1 complex bins.
+     *
+     * The samples can be pushed in blocks of any length: the incomplete frames are kept between calls. All the
+     * memory and FFT plans are allocated during the construction, so pushing samples never allocates.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class stft {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %stft with the given configuration.
+         * @param window Type of window applied to every frame.
+         * @param frame_size Number of samples of every frame.
+         * @param hop_size Number of samples between the beginning of two consecutive frames.
+         * @param nfft Size of the FFT, it should be greater or equal than the frame size.
+         */
+        stft(windowing::WindowType window, size_type frame_size, size_type hop_size, size_type nfft);
+
+        /**
+         * @brief Returns the number of samples of every frame.
+         * @return Frame size.
+         */
+        size_type frame_size() const noexcept;
+
+        /**
+         * @brief Returns the number of samples between two consecutive frames.
+         * @return Hop size.
+         */
+        size_type hop_size() const noexcept;
+
+        /**
+         * @brief Returns the size of the FFT.
+         * @return Size of the FFT.
+         */
+        size_type nfft() const noexcept;
+
+        /**
+         * @brief Returns the number of complex bins of every emitted frame.
+         * @return nfft / 2 + 1
+         */
+        size_type bins() const noexcept;
+
+        /**
+         * @brief Returns the number of frames emitted if the given number of samples is pushed.
+         *
+         * Use this function to size the output storage of %push.
+         * @param samples Number of samples to be pushed.
+         * @return Number of frames.
+         */
+        size_type frames(size_type samples) const noexcept;
+
+        /**
+         * @brief Discards the buffered samples.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Pushes the samples in the range [first, last) and stores the spectrum of every completed frame in
+         * another range, beginning at d_first.
+         *
+         * The frames are stored one after the other, every frame containing bins() complex numbers.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Number of emitted frames.
+         * @see frames
+         */
+        template <typename InputIt, typename OutputIt>
+        size_type push(InputIt first, InputIt last, OutputIt d_first);
+
+    private:
+        template <typename OutputIt>
+        OutputIt emit(OutputIt d_first);
+
+        fft_engine<T> engine_;
+        std::vector<value_type> window_;
+        std::vector<value_type> frame_;
+        std::vector<value_type> windowed_;
+        std::vector<complex_type> spectrum_;
+        size_type hop_size_;
+        size_type filled_{0};
+        size_type skip_{0};
+    };
+
+    template <typename T>
+    stft<T>::stft(windowing::WindowType window, size_type frame_size, size_type hop_size, size_type nfft) :
+        engine_(nfft, {fft_kind::RealForward}),
+        window_(frame_size),
+        frame_(frame_size),
+        windowed_(nfft, 0),
+        spectrum_(make_fft_size(nfft)),
+        hop_size_(hop_size) {
+        meta::expects(frame_size > 0 && hop_size > 0, "The frame and hop sizes should be greater than zero");
+        meta::expects(frame_size <= nfft, "The FFT size should be greater or equal than the frame size");
+        windowing::make_window(window, std::begin(window_), std::end(window_));
+    }
+
+    template <typename T>
+    typename stft<T>::size_type stft<T>::frame_size() const noexcept {
+        return frame_.size();
+    }
+
+    template <typename T>
+    typename stft<T>::size_type stft<T>::hop_size() const noexcept {
+        return hop_size_;
+    }
+
+    template <typename T>
+    typename stft<T>::size_type stft<T>::nfft() const noexcept {
+        return windowed_.size();
+    }
+
+    template <typename T>
+    typename stft<T>::size_type stft<T>::bins() const noexcept {
+        return spectrum_.size();
+    }
+
+    template <typename T>
+    typename stft<T>::size_type stft<T>::frames(size_type samples) const noexcept {
+        if (samples <= skip_) {
+            return 0;
+        }
+        const auto available = filled_ + samples - skip_;
+        return (available < frame_.size()) ? 0 : (available - frame_.size()) / hop_size_ + 1;
+    }
+
+    template <typename T>
+    void stft<T>::reset() noexcept {
+        filled_ = 0;
+        skip_   = 0;
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    typename stft<T>::size_type stft<T>::push(InputIt first, InputIt last, OutputIt d_first) {
+        const auto frame_size = frame_.size();
+        size_type emitted     = 0;
+        while (first != last) {
+            if (skip_ > 0) {
+                --skip_;
+                ++first;
+                continue;
+            }
+
+            const auto needed = static_cast<std::ptrdiff_t>(frame_size - filled_);
+            const auto count  = std::min(needed, static_cast<std::ptrdiff_t>(std::distance(first, last)));
+            std::copy_n(first, count, std::begin(frame_) + filled_);
+            std::advance(first, count);
+            filled_ += static_cast<size_type>(count);
+
+            if (filled_ == frame_size) {
+                d_first = emit(d_first);
+                ++emitted;
+                if (hop_size_ < frame_size) {
+                    std::copy(std::begin(frame_) + hop_size_, std::end(frame_), std::begin(frame_));
+                    filled_ = frame_size - hop_size_;
+                } else {
+                    skip_   = hop_size_ - frame_size;
+                    filled_ = 0;
+                }
+            }
+        }
+        return emitted;
+    }
+
+    template <typename T>
+    template <typename OutputIt>
+    OutputIt stft<T>::emit(OutputIt d_first) {
+        std::transform(std::cbegin(frame_), std::cend(frame_), std::cbegin(window_), std::begin(windowed_),
+                       std::multiplies<value_type>());
+        engine_.dft(windowed_.data(), spectrum_.data());
+        return std::copy(std::cbegin(spectrum_), std::cend(spectrum_), d_first);
+    }
+
+    /**
+     * @class istft
+     * @brief This class implements a streaming Inverse Short-Time Fourier Transform (ISTFT).
+     *
+     * Every frame is transformed back to the time domain, windowed again with the synthesis window and added to
+     * the previous ones (weighted overlap-add). Every output sample is normalized with the squared windows that
+     * actually overlapped it, including the first frame_size - hop_size samples where fewer frames have been added
+     * than in the steady state. The original signal is therefore reconstructed from the first sample, for any
+     * window and hop size whose overlapped squared window does not vanish. Samples not covered by any nonzero
+     * window value, such as the first sample of a Hann window, can not be recovered and are returned as zero.
+     *
+     * Every pushed frame produces hop_size output samples: the n-th frame completes the samples in the range
+     * [n * hop_size, (n + 1) * hop_size) of the signal analysed by the %stft.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class istft {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates an %istft with the given configuration.
+         * @param window Type of window applied to every frame.
+         * @param frame_size Number of samples of every frame.
+         * @param hop_size Number of samples between the beginning of two consecutive frames, it should be less or
+         * equal than the frame size.
+         * @param nfft Size of the FFT, it should be greater or equal than the frame size.
+         */
+        istft(windowing::WindowType window, size_type frame_size, size_type hop_size, size_type nfft);
+
+        /**
+         * @brief Returns the number of samples of every frame.
+         * @return Frame size.
+         */
+        size_type frame_size() const noexcept;
+
+        /**
+         * @brief Returns the number of output samples produced by every frame.
+         * @return Hop size.
+         */
+        size_type hop_size() const noexcept;
+
+        /**
+         * @brief Returns the size of the FFT.
+         * @return Size of the FFT.
+         */
+        size_type nfft() const noexcept;
+
+        /**
+         * @brief Returns the number of complex bins expected in every frame.
+         * @return nfft / 2 + 1
+         */
+        size_type bins() const noexcept;
+
+        /**
+         * @brief Discards the accumulated overlap.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Pushes a single frame of bins() complex numbers, beginning at first, and stores the hop_size()
+         * resynthesized samples in another range, beginning at d_first.
+         * @param first Input iterator defining the beginning of the frame.
+         * @param d_first Output iterator defining the beginning of the destination range.
+         * @return Output iterator to the element past the last element written.
+         */
+        template <typename InputIt, typename OutputIt>
+        OutputIt push(InputIt first, OutputIt d_first);
+
+    private:
+        fft_engine<T> engine_;
+        std::vector<value_type> window_;
+        std::vector<value_type> overlap_;
+        std::vector<value_type> envelope_;
+        std::vector<value_type> frame_;
+        std::vector<complex_type> spectrum_;
+        size_type hop_size_;
+    };
+
+    template <typename T>
+    istft<T>::istft(windowing::WindowType window, size_type frame_size, size_type hop_size, size_type nfft) :
+        engine_(nfft, {fft_kind::RealBackward}),
+        window_(frame_size),
+        overlap_(frame_size, 0),
+        envelope_(frame_size, 0),
+        frame_(nfft),
+        spectrum_(make_fft_size(nfft)),
+        hop_size_(hop_size) {
+        meta::expects(frame_size > 0 && hop_size > 0, "The frame and hop sizes should be greater than zero");
+        meta::expects(hop_size <= frame_size, "The hop size should be less or equal than the frame size");
+        meta::expects(frame_size <= nfft, "The FFT size should be greater or equal than the frame size");
+        windowing::make_window(window, std::begin(window_), std::end(window_));
+    }
+
+    template <typename T>
+    typename istft<T>::size_type istft<T>::frame_size() const noexcept {
+        return window_.size();
+    }
+
+    template <typename T>
+    typename istft<T>::size_type istft<T>::hop_size() const noexcept {
+        return hop_size_;
+    }
+
+    template <typename T>
+    typename istft<T>::size_type istft<T>::nfft() const noexcept {
+        return frame_.size();
+    }
+
+    template <typename T>
+    typename istft<T>::size_type istft<T>::bins() const noexcept {
+        return spectrum_.size();
+    }
+
+    template <typename T>
+    void istft<T>::reset() noexcept {
+        std::fill(std::begin(overlap_), std::end(overlap_), 0);
+        std::fill(std::begin(envelope_), std::end(envelope_), 0);
+    }
+
+    template <typename T>
+    template <typename InputIt, typename OutputIt>
+    OutputIt istft<T>::push(InputIt first, OutputIt d_first) {
+        std::copy_n(first, spectrum_.size(), std::begin(spectrum_));
+        engine_.idft(spectrum_.data(), frame_.data());
+
+        const auto frame_size = window_.size();
+        const auto scaling    = static_cast<value_type>(frame_.size());
+        for (size_type i = 0; i < frame_size; ++i) {
+            overlap_[i] += frame_[i] * window_[i] / scaling;
+            envelope_[i] += window_[i] * window_[i];
+        }
+
+        // Every output sample is the sum of the overlapped frames, weighted by both the analysis and synthesis
+        // windows. The squared windows are accumulated alongside, so the samples completed before the steady state
+        // is reached are normalized by the frames that really contributed to them.
+        const auto eps = std::numeric_limits<value_type>::epsilon();
+        for (size_type i = 0; i < hop_size_; ++i, ++d_first) {
+            *d_first = (envelope_[i] > eps) ? overlap_[i] / envelope_[i] : 0;
+        }
+        std::copy(std::begin(overlap_) + hop_size_, std::end(overlap_), std::begin(overlap_));
+        std::fill(std::end(overlap_) - hop_size_, std::end(overlap_), 0);
+        std::copy(std::begin(envelope_) + hop_size_, std::end(envelope_), std::begin(envelope_));
+        std::fill(std::end(envelope_) - hop_size_, std::end(envelope_), 0);
+        return d_first;
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_STFT_HPP
@@ -0,0 +1,305 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: welch_psd.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_WELCH_PSD_HPP
+#define EDSP_WELCH_PSD_HPP
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <edsp/windowing.hpp>
+#include <edsp/meta/expects.hpp>
+#include <algorithm>
+#include <complex>
+#include <functional>
+#include <vector>
+
+namespace edsp { inline namespace spectral {
+
+    /**
+     * @brief The PsdScaling enum defines the units of the power spectral estimates.
+     */
+    enum class PsdScaling {
+        Density, /*!< Power spectral density, in V^2 / Hz */
+        Spectrum /*!< Power spectrum, in V^2 */
+    };
+
+    /**
+     * @class welch_psd
+     * @brief This class estimates the one-sided power spectral density of a stream with the Welch method.
+     *
+     * The input signal is split in overlapping segments, every segment is windowed and transformed, and the
+     * periodograms of all the segments are averaged:
+     *
+     * \f[
+     *  P_k = \frac{c_k}{M} \sum_{m=0}^{M-1} \left| \sum_{n} w_n x_{mH + n} e^{-j 2 \pi k n / N} \right|^2
+     * \f]
+     *
+     * where H is the hop between segments and c_k the scaling, \f$ 1 / (f_s \sum w_n^2) \f$ for a density or
+     * \f$ 1 / (\sum w_n)^2 \f$ for a spectrum, doubled in every bin but the DC and Nyquist ones.
+     *
+     * The samples can be pushed in blocks of any length. Only the running average of every bin and the incomplete
+     * segment are stored, so arbitrarily long recordings can be analysed with constant memory, and the estimate can
+     * be read at any time. All the memory and FFT plans are allocated during the construction.
+     *
+     * @tparam T Floating point type.
+     */
+    template <typename T>
+    class welch_psd {
+    public:
+        using value_type   = T;
+        using complex_type = std::complex<T>;
+        using size_type    = std::size_t;
+
+        /**
+         * @brief Creates a %welch_psd with the given configuration.
+         * @param window Type of window applied to every segment.
+         * @param segment_size Number of samples of every segment.
+         * @param overlap Number of samples shared by two consecutive segments, it should be less than the segment
+         * size.
+         * @param nfft Size of the FFT, it should be greater or equal than the segment size.
+         * @param sample_rate Sampling frequency in Hz.
+         * @param scaling Units of the estimates.
+         */
+        welch_psd(windowing::WindowType window, size_type segment_size, size_type overlap, size_type nfft,
+                  value_type sample_rate, PsdScaling scaling = PsdScaling::Density);
+
+        /**
+         * @brief Returns the number of samples of every segment.
+         * @return Segment size.
+         */
+        size_type segment_size() const noexcept;
+
+        /**
+         * @brief Returns the number of samples shared by two consecutive segments.
+         * @return Overlap.
+         */
+        size_type overlap() const noexcept;
+
+        /**
+         * @brief Returns the size of the FFT.
+         * @return Size of the FFT.
+         */
+        size_type nfft() const noexcept;
+
+        /**
+         * @brief Returns the number of bins of the estimate.
+         * @return nfft / 2 + 1
+         */
+        size_type bins() const noexcept;
+
+        /**
+         * @brief Returns the number of segments averaged so far.
+         * @return Number of segments.
+         */
+        size_type segments() const noexcept;
+
+        /**
+         * @brief Returns the frequency of the i-th bin.
+         * @param i Position of the bin.
+         * @return Frequency in Hz.
+         */
+        value_type frequency(size_type i) const noexcept;
+
+        /**
+         * @brief Discards the buffered samples and the accumulated average.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Pushes the samples in the range [first, last), averaging every completed segment.
+         * @param first Input iterator defining the beginning of the input range.
+         * @param last Input iterator defining the ending of the input range.
+         * @return Number of segments completed by the samples.
+         */
+        template <typename InputIt>
+        size_type push(InputIt first, InputIt last);
+
+        /**
+         * @brief Stores the current estimate in the range beginning at d_first.
+         *
+         * If no segment has been completed yet, the estimate is zero.
+         * @param d_first Output iterator defining the beginning of the destination range, it stores bins() values.
+         * @return Output iterator to the element past the last element stored.
+         */
+        template <typename OutputIt>
+        OutputIt estimate(OutputIt d_first) const;
+
+    private:
+        void accumulate();
+
+        fft_engine<T> engine_;
+        std::vector<value_type> window_;
+        std::vector<value_type> frame_;
+        std::vector<value_type> windowed_;
+        std::vector<complex_type> spectrum_;
+        std::vector<value_type> scaling_;
+        std::vector<value_type> average_;
+        value_type sample_rate_;
+        size_type hop_size_;
+        size_type filled_{0};
+        size_type segments_{0};
+    };
+
+    template <typename T>
+    welch_psd<T>::welch_psd(windowing::WindowType window, size_type segment_size, size_type overlap, size_type nfft,
+                            value_type sample_rate, PsdScaling scaling) :
+        engine_(nfft, {fft_kind::RealForward}),
+        window_(segment_size),
+        frame_(segment_size),
+        windowed_(nfft, 0),
+        spectrum_(make_fft_size(nfft)),
+        scaling_(make_fft_size(nfft)),
+        average_(make_fft_size(nfft), 0),
+        sample_rate_(sample_rate),
+        hop_size_(segment_size - overlap) {
+        meta::expects(segment_size > 0, "The segment size should be greater than zero");
+        meta::expects(overlap < segment_size, "The overlap should be less than the segment size");
+        meta::expects(segment_size <= nfft, "The FFT size should be greater or equal than the segment size");
+        meta::expects(sample_rate > 0, "The sample rate should be greater than zero");
+        windowing::make_window(window, std::begin(window_), std::end(window_));
+
+        value_type sum = 0, squared = 0;
+        for (const auto value : window_) {
+            sum += value;
+            squared += value * value;
+        }
+        const auto factor = (scaling == PsdScaling::Density) ? 1 / (sample_rate * squared) : 1 / (sum * sum);
+
+        // The one-sided estimate folds the negative frequencies, which do not include DC and Nyquist.
+        std::fill(std::begin(scaling_), std::end(scaling_), 2 * factor);
+        scaling_.front() = factor;
+        if (nfft % 2 == 0) {
+            scaling_.back() = factor;
+        }
+    }
+
+    template <typename T>
+    typename welch_psd<T>::size_type welch_psd<T>::segment_size() const noexcept {
+        return frame_.size();
+    }
+
+    template <typename T>
+    typename welch_psd<T>::size_type welch_psd<T>::overlap() const noexcept {
+        return frame_.size() - hop_size_;
+    }
+
+    template <typename T>
+    typename welch_psd<T>::size_type welch_psd<T>::nfft() const noexcept {
+        return windowed_.size();
+    }
+
+    template <typename T>
+    typename welch_psd<T>::size_type welch_psd<T>::bins() const noexcept {
+        return average_.size();
+    }
+
+    template <typename T>
+    typename welch_psd<T>::size_type welch_psd<T>::segments() const noexcept {
+        return segments_;
+    }
+
+    template <typename T>
+    typename welch_psd<T>::value_type welch_psd<T>::frequency(size_type i) const noexcept {
+        return static_cast<value_type>(i) * sample_rate_ / static_cast<value_type>(windowed_.size());
+    }
+
+    template <typename T>
+    void welch_psd<T>::reset() noexcept {
+        std::fill(std::begin(average_), std::end(average_), 0);
+        filled_   = 0;
+        segments_ = 0;
+    }
+
+    template <typename T>
+    template <typename InputIt>
+    typename welch_psd<T>::size_type welch_psd<T>::push(InputIt first, InputIt last) {
+        const auto segment_size = frame_.size();
+        size_type completed     = 0;
+        while (first != last) {
+            const auto needed = static_cast<std::ptrdiff_t>(segment_size - filled_);
+            const auto count  = std::min(needed, static_cast<std::ptrdiff_t>(std::distance(first, last)));
+            std::copy_n(first, count, std::begin(frame_) + filled_);
+            std::advance(first, count);
+            filled_ += static_cast<size_type>(count);
+
+            if (filled_ == segment_size) {
+                accumulate();
+                ++completed;
+                std::copy(std::begin(frame_) + hop_size_, std::end(frame_), std::begin(frame_));
+                filled_ = segment_size - hop_size_;
+            }
+        }
+        return completed;
+    }
+
+    template <typename T>
+    template <typename OutputIt>
+    OutputIt welch_psd<T>::estimate(OutputIt d_first) const {
+        return std::transform(std::cbegin(average_), std::cend(average_), std::cbegin(scaling_), d_first,
+                              std::multiplies<value_type>());
+    }
+
+    template <typename T>
+    void welch_psd<T>::accumulate() {
+        std::transform(std::cbegin(frame_), std::cend(frame_), std::cbegin(window_), std::begin(windowed_),
+                       std::multiplies<value_type>());
+        engine_.dft(windowed_.data(), spectrum_.data());
+
+        // Running mean, it does not lose precision as the number of segments grows like a plain sum.
+        ++segments_;
+        const auto weight = 1 / static_cast<value_type>(segments_);
+        const auto size   = average_.size();
+        const auto* bin   = spectrum_.data();
+        auto* average     = average_.data();
+        for (size_type i = 0; i < size; ++i) {
+            const auto power = bin[i].real() * bin[i].real() + bin[i].imag() * bin[i].imag();
+            average[i] += (power - average[i]) * weight;
+        }
+    }
+
+    /**
+     * @brief Estimates the one-sided power spectral density of the range [first, last) with the Welch method and
+     * stores the result in another range, beginning at d_first.
+     *
+     * The trailing samples that do not complete a segment are ignored.
+     * @param first Input iterator defining the beginning of the input range.
+     * @param last Input iterator defining the ending of the input range.
+     * @param d_first Output iterator defining the beginning of the destination range, it stores nfft / 2 + 1 values.
+     * @param window Type of window applied to every segment.
+     * @param segment_size Number of samples of every segment.
+     * @param overlap Number of samples shared by two consecutive segments.
+     * @param nfft Size of the FFT.
+     * @param sample_rate Sampling frequency in Hz.
+     * @param scaling Units of the estimates.
+     * @see welch_psd
+     */
+    template <typename InputIt, typename OutputIt, typename T>
+    inline void welch(InputIt first, InputIt last, OutputIt d_first, windowing::WindowType window,
+                      std::size_t segment_size, std::size_t overlap, std::size_t nfft, T sample_rate,
+                      PsdScaling scaling = PsdScaling::Density) {
+        welch_psd<meta::value_type_t<InputIt>> estimator(window, segment_size, overlap, nfft, sample_rate, scaling);
+        estimator.push(first, last);
+        estimator.estimate(d_first);
+    }
+
+}} // namespace edsp::spectral
+
+#endif //EDSP_WELCH_PSD_HPP
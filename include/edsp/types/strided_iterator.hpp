@@ -0,0 +1,224 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: strided_iterator.hpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#ifndef EDSP_STRIDED_ITERATOR_HPP
+#define EDSP_STRIDED_ITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+
+namespace edsp { inline namespace types {
+
+    /**
+     * @class strided_iterator
+     * @brief This class adapts a random access iterator to visit one element every stride elements.
+     *
+     * It exposes a single channel of an interleaved buffer, where the sample n of the channel c is stored at the
+     * position n * channels + c, as a regular range. Any function of the library taking iterators, such as the
+     * feature extractors or the streaming transforms, can then process the channel in place, without copying it to
+     * a contiguous buffer.
+     *
+     * The iterator stores the beginning of the underlying range and the index of the current element, and only
+     * computes the position of an element when it is accessed. Two iterators compare equal if they have the same
+     * index, so they should refer to the same sequence.
+     *
+     * @tparam Iterator Random access iterator type.
+     * @see make_channel_iterator
+     */
+    template <typename Iterator>
+    class strided_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = typename std::iterator_traits<Iterator>::value_type;
+        using difference_type   = typename std::iterator_traits<Iterator>::difference_type;
+        using pointer           = typename std::iterator_traits<Iterator>::pointer;
+        using reference         = typename std::iterator_traits<Iterator>::reference;
+
+        constexpr strided_iterator() = default;
+
+        /**
+         * @brief Creates a %strided_iterator visiting the elements first[offset + i * stride].
+         *
+         * Only the visited elements are ever formed from first, so an iterator past the end of the visited sequence,
+         * such as the end of a channel, never points outside the underlying range.
+         * @param first Iterator to the beginning of the underlying range.
+         * @param stride Distance between two consecutive visited elements.
+         * @param offset Distance from first to the first visited element.
+         * @param index Number of visited elements preceding the current one.
+         */
+        constexpr strided_iterator(Iterator first, difference_type stride, difference_type offset = 0,
+                                   difference_type index = 0) :
+            first_(first),
+            stride_(stride),
+            offset_(offset),
+            index_(index) {}
+
+        /**
+         * @brief Returns the underlying iterator, only valid if the current element can be dereferenced.
+         * @return Iterator to the current element.
+         */
+        constexpr Iterator base() const {
+            return first_ + position();
+        }
+
+        /**
+         * @brief Returns the number of visited elements preceding the current one.
+         * @return Index of the current element.
+         */
+        constexpr difference_type index() const noexcept {
+            return index_;
+        }
+
+        /**
+         * @brief Returns the distance between two consecutive visited elements.
+         * @return Stride of the iterator.
+         */
+        constexpr difference_type stride() const noexcept {
+            return stride_;
+        }
+
+        constexpr reference operator*() const {
+            return first_[position()];
+        }
+
+        constexpr pointer operator->() const {
+            return &first_[position()];
+        }
+
+        constexpr reference operator[](difference_type n) const {
+            return first_[offset_ + (index_ + n) * stride_];
+        }
+
+        constexpr strided_iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        constexpr strided_iterator operator++(int) {
+            auto copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        constexpr strided_iterator& operator--() {
+            --index_;
+            return *this;
+        }
+
+        constexpr strided_iterator operator--(int) {
+            auto copy = *this;
+            --index_;
+            return copy;
+        }
+
+        constexpr strided_iterator& operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+
+        constexpr strided_iterator& operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+
+        constexpr strided_iterator operator+(difference_type n) const {
+            return strided_iterator(first_, stride_, offset_, index_ + n);
+        }
+
+        constexpr strided_iterator operator-(difference_type n) const {
+            return strided_iterator(first_, stride_, offset_, index_ - n);
+        }
+
+        constexpr difference_type operator-(const strided_iterator& other) const {
+            return index_ - other.index_;
+        }
+
+        constexpr bool operator==(const strided_iterator& other) const {
+            return index_ == other.index_;
+        }
+
+        constexpr bool operator!=(const strided_iterator& other) const {
+            return index_ != other.index_;
+        }
+
+        constexpr bool operator<(const strided_iterator& other) const {
+            return index_ < other.index_;
+        }
+
+        constexpr bool operator>(const strided_iterator& other) const {
+            return other < *this;
+        }
+
+        constexpr bool operator<=(const strided_iterator& other) const {
+            return !(other < *this);
+        }
+
+        constexpr bool operator>=(const strided_iterator& other) const {
+            return !(*this < other);
+        }
+
+    private:
+        constexpr difference_type position() const noexcept {
+            return offset_ + index_ * stride_;
+        }
+
+        Iterator first_{};
+        difference_type stride_{1};
+        difference_type offset_{0};
+        difference_type index_{0};
+    };
+
+    template <typename Iterator>
+    constexpr strided_iterator<Iterator> operator+(typename strided_iterator<Iterator>::difference_type n,
+                                                   const strided_iterator<Iterator>& it) {
+        return it + n;
+    }
+
+    /**
+     * @brief Creates a %strided_iterator visiting one element every stride elements, beginning at first.
+     * @param first Iterator to the first element.
+     * @param stride Distance between two consecutive visited elements.
+     * @return Strided iterator.
+     */
+    template <typename Iterator>
+    constexpr strided_iterator<Iterator> make_strided_iterator(Iterator first, std::ptrdiff_t stride) {
+        return strided_iterator<Iterator>(first, stride);
+    }
+
+    /**
+     * @brief Creates a %strided_iterator to the sample n of a channel of an interleaved buffer.
+     * @param first Iterator to the beginning of the interleaved buffer.
+     * @param channels Number of channels of the buffer.
+     * @param channel Index of the channel.
+     * @param n Index of the sample in the channel, use the number of frames to get the end of the channel.
+     * @return Strided iterator.
+     */
+    template <typename Iterator>
+    constexpr strided_iterator<Iterator> make_channel_iterator(Iterator first, std::size_t channels,
+                                                               std::size_t channel, std::size_t n = 0) {
+        return strided_iterator<Iterator>(first, static_cast<std::ptrdiff_t>(channels),
+                                          static_cast<std::ptrdiff_t>(channel), static_cast<std::ptrdiff_t>(n));
+    }
+
+}} // namespace edsp::types
+
+#endif //EDSP_STRIDED_ITERATOR_HPP
@@ -158,6 +158,42 @@ namespace edsp { namespace windowing {
         return internal::_build_window<Type>{}(first, last);
     }
 
+    /**
+     * @brief Computes a window of the given type and length N and stores the result in the range, beginning at d_first.
+     *
+     * Unlike the template version, the type of window is selected at runtime.
+     * @param type Type of window to be computed
+     * @param first Input iterator defining the beginning of the output range.
+     * @param last Input iterator defining the ending of the output range.
+     */
+    template <typename OutputIt>
+    inline void make_window(WindowType type, OutputIt first, OutputIt last) {
+        switch (type) {
+            case WindowType::Bartlett:
+                return make_window<WindowType::Bartlett>(first, last);
+            case WindowType::Blackman:
+                return make_window<WindowType::Blackman>(first, last);
+            case WindowType::BlackmanHarris:
+                return make_window<WindowType::BlackmanHarris>(first, last);
+            case WindowType::BlackmanNuttall:
+                return make_window<WindowType::BlackmanNuttall>(first, last);
+            case WindowType::Boxcar:
+                return make_window<WindowType::Boxcar>(first, last);
+            case WindowType::FlatTop:
+                return make_window<WindowType::FlatTop>(first, last);
+            case WindowType::Hamming:
+                return make_window<WindowType::Hamming>(first, last);
+            case WindowType::Hanning:
+                return make_window<WindowType::Hanning>(first, last);
+            case WindowType::Rectangular:
+                return make_window<WindowType::Rectangular>(first, last);
+            case WindowType::Triangular:
+                return make_window<WindowType::Triangular>(first, last);
+            case WindowType::Welch:
+                return make_window<WindowType::Welch>(first, last);
+        }
+    }
+
 }} // namespace edsp::windowing
 
 #endif // EDSP_WINDOWING_HPP
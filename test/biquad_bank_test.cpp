@@ -0,0 +1,132 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: biquad_bank_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/filter.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::filter;
+
+namespace {
+
+    constexpr float rate = 48000;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // A different design for every lane, so a lane reading the coefficients or the samples of another one is caught.
+    biquad<float> design(std::size_t lane) {
+        const auto fc = static_cast<float>(100 + 700 * lane);
+        const auto Q  = static_cast<float>(0.5 + 0.3 * lane);
+        switch (lane % 4) {
+            case 0:
+                return RBJFilterDesigner<float, filter_type::LowPass>{}(fc, rate, Q);
+            case 1:
+                return RBJFilterDesigner<float, filter_type::HighPass>{}(fc, rate, Q);
+            case 2:
+                return RBJFilterDesigner<float, filter_type::BandPass>{}(fc, rate, Q);
+            default:
+                return RBJFilterDesigner<float, filter_type::AllPass>{}(fc, rate, Q);
+        }
+    }
+
+    bool same(const biquad<float>& lhs, const biquad<float>& rhs) {
+        return lhs.b0() == rhs.b0() && lhs.b1() == rhs.b1() && lhs.b2() == rhs.b2() && lhs.a1() == rhs.a1() &&
+               lhs.a2() == rhs.a2();
+    }
+
+    // Filters the channels [offset, offset + Lanes) of an interleaved buffer of the given number of channels, with
+    // chunks of several lengths and twice with a reset in between, and compares them with one biquad per channel.
+    // The remaining channels must be left untouched.
+    template <std::size_t Lanes>
+    bool run(std::size_t channels, std::size_t offset, bool in_place) {
+        constexpr std::size_t frames = 4096;
+        std::mt19937 generator(static_cast<unsigned>(Lanes + channels));
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<float> input(frames * channels);
+        std::generate(std::begin(input), std::end(input), [&]() { return distribution(generator); });
+
+        biquad_bank<float, Lanes> bank;
+        bool coefficients = true;
+        for (std::size_t l = 0; l < Lanes; ++l) {
+            bank.set(l, design(l));
+            coefficients &= same(bank.get(l), design(l));
+        }
+
+        // The output is written with a stride one larger than the input when filtering out of place.
+        const auto stride = in_place ? channels : channels + 1;
+        double error = 0, peak = 0;
+        bool untouched = true;
+        for (auto pass = 0; pass < 2; ++pass) {
+            bank.reset();
+            std::vector<float> output = in_place ? input : std::vector<float>(frames * stride, 7);
+            const std::size_t chunks[] = {1, 2, 3, 61, 64, 100, 257, 1000};
+            for (std::size_t n = 0, i = 0; n < frames; ++i) {
+                const auto length = std::min(chunks[i % 8], frames - n);
+                if (in_place) {
+                    bank.process(output.data() + n * stride + offset, length, stride);
+                } else {
+                    bank.filter(input.data() + n * channels + offset, output.data() + n * stride + offset, length,
+                                channels, stride);
+                }
+                n += length;
+            }
+
+            for (std::size_t c = 0; c < stride; ++c) {
+                if (c < offset || c >= offset + Lanes) {
+                    for (std::size_t n = 0; n < frames; ++n) {
+                        const auto expected = in_place ? input[n * channels + c] : 7.0f;
+                        untouched &= output[n * stride + c] == expected;
+                    }
+                    continue;
+                }
+                auto reference = design(c - offset);
+                for (std::size_t n = 0; n < frames; ++n) {
+                    const double expected = reference.tick(input[n * channels + c]);
+                    error                 = std::max(error, std::abs(output[n * stride + c] - expected));
+                    peak                  = std::max(peak, std::abs(expected));
+                }
+            }
+        }
+        std::printf("%zu lanes of %zu channels from %zu, %s: max error %.3g, peak %.3g\n", Lanes, channels, offset,
+                    in_place ? "in place" : "out of place", error, peak);
+        return coefficients && untouched && error <= 1e-6 * peak;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    passed &= check(run<1>(1, 0, true), "one lane");
+    passed &= check(run<2>(2, 0, true), "stereo");
+    passed &= check(run<5>(5, 0, false), "five lanes, out of place");
+    passed &= check(run<5>(8, 2, true), "five lanes of eight channels");
+    passed &= check(run<8>(11, 3, false), "eight lanes of eleven channels, out of place");
+    passed &= check(run<16>(16, 0, true), "sixteen lanes");
+    passed &= check(run<32>(33, 1, false), "thirty two lanes, out of place");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: cepstrum_engine_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/cepstrum_engine.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace edsp::spectral;
+
+namespace {
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Complex cepstrum of (1 + a z^-1) (1 + b z), aliased on nfft coefficients: the minimum phase factor contributes
+    // (-1)^(n + 1) a^n / n at n > 0 and the maximum phase one (-1)^(n + 1) b^n / n at -n.
+    std::vector<double> reference(double a, double b, std::size_t nfft) {
+        std::vector<double> output(nfft, 0);
+        for (std::size_t n = 1; n < 8 * nfft; ++n) {
+            const auto sign = (n % 2 == 1) ? 1.0 : -1.0;
+            output[n % nfft] += sign * std::pow(a, n) / n;
+            output[(nfft - n % nfft) % nfft] += sign * std::pow(b, n) / n;
+        }
+        return output;
+    }
+
+    bool run(const std::vector<float>& input, std::size_t nfft, const std::vector<double>& expected,
+             int expected_sign, std::ptrdiff_t expected_delay) {
+        cepstrum_engine<float> engine(input.size(), nfft, CepstrumMode::Complex);
+        std::vector<float> output(nfft);
+        engine.compute(std::cbegin(input), std::begin(output));
+
+        double error = 0;
+        for (std::size_t i = 0; i < nfft; ++i) {
+            error = std::max(error, std::abs(static_cast<double>(output[i]) - expected[i]));
+        }
+        std::printf("nfft %3zu: c[1] %.6f sign %d delay %td max error %.3g\n", nfft, output[1 % nfft], engine.sign(),
+                    engine.delay(), error);
+        return error < 1e-5 && engine.sign() == expected_sign && engine.delay() == expected_delay;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    passed &= check(run({1.0f, 0.5f}, 64, reference(0.5, 0, 64), 1, 0), "minimum phase");
+    passed &= check(run({-1.0f, -0.5f}, 64, reference(0.5, 0, 64), -1, 0), "minimum phase with negative dc");
+    passed &= check(run({-1.0f, -0.5f}, 63, reference(0.5, 0, 63), -1, 0), "negative dc with odd size");
+    passed &= check(run({-1.0f, -0.5f}, 2, {std::log(0.75) / 2, std::log(3.0) / 2}, -1, 0),
+                    "negative dc without padding");
+    passed &= check(run({0.25f, 1.125f, 0.5f}, 64, reference(0.5, 0.25, 64), 1, 1), "mixed phase");
+    passed &= check(run({-0.25f, -1.125f, -0.5f}, 64, reference(0.5, 0.25, 64), -1, 1),
+                    "mixed phase with negative dc");
+    return passed ? 0 : 1;
+}
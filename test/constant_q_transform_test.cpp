@@ -0,0 +1,141 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: constant_q_transform_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/constant_q_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::spectral;
+using edsp::windowing::WindowType;
+
+namespace {
+
+    using complex_type = std::complex<float>;
+
+    constexpr float sample_rate = 8000;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    std::vector<float> make_input(std::size_t size) {
+        std::mt19937 generator(11);
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<float> input(size);
+        for (std::size_t n = 0; n < size; ++n) {
+            input[n] = static_cast<float>(std::sin(2 * M_PI * 440 * n / sample_rate)) + distribution(generator) / 4;
+        }
+        return input;
+    }
+
+    // Direct correlation of every frame with the windowed complex exponentials centred in the frame, computed in
+    // double precision.
+    std::vector<std::complex<double>> reference(const constant_q_transform<float>& cqt, const std::vector<float>& input,
+                                                std::size_t frames, double gamma, double q) {
+        const auto nfft = cqt.nfft();
+        std::vector<std::complex<double>> output(frames * cqt.bins());
+        for (std::size_t k = 0; k < cqt.bins(); ++k) {
+            const auto frequency = static_cast<double>(cqt.frequency(k));
+            const auto length    = static_cast<std::size_t>(std::ceil(sample_rate / (frequency / q + gamma)));
+            std::vector<double> window(length);
+            edsp::windowing::make_window(WindowType::Hanning, std::begin(window), std::end(window));
+            double sum = 0;
+            for (const auto value : window) {
+                sum += value;
+            }
+            const auto start = (nfft - length) / 2;
+            for (std::size_t f = 0; f < frames; ++f) {
+                std::complex<double> value = 0;
+                for (std::size_t n = 0; n < length; ++n) {
+                    const auto phase = -2 * M_PI * frequency * static_cast<double>(start + n) / sample_rate;
+                    value += static_cast<double>(input[f * cqt.hop_size() + start + n]) * window[n] / sum *
+                             std::polar(1.0, phase);
+                }
+                output[f * cqt.bins() + k] = value;
+            }
+        }
+        return output;
+    }
+
+    template <typename Container>
+    double distance(const Container& x, const std::vector<std::complex<double>>& y) {
+        double error = 0;
+        for (std::size_t i = 0; i < y.size(); ++i) {
+            error = std::max(error, std::abs(std::complex<double>(x[i]) - y[i]));
+        }
+        return error;
+    }
+
+    // Compares the transform with the direct correlation, and the streaming, single and multi-threaded batch paths
+    // with each other.
+    bool run(std::size_t hop_size, float gamma, float threshold, double tolerance) {
+        const auto q = 1 / (std::pow(2.0, 1.0 / 12) - 1);
+        std::vector<float> frequencies;
+        for (auto k = 0; k < 36; ++k) {
+            frequencies.push_back(static_cast<float>(110 * std::pow(2.0, k / 12.0)));
+        }
+        constant_q_transform<float> cqt(std::cbegin(frequencies), std::cend(frequencies), sample_rate,
+                                        static_cast<float>(q), hop_size, WindowType::Hanning, gamma, threshold);
+        const auto input  = make_input(cqt.nfft() + 9 * hop_size + hop_size / 2);
+        const auto frames = cqt.frames(input.size());
+        const auto bins   = cqt.bins();
+
+        std::vector<complex_type> single(frames * bins), multi(frames * bins), streamed(frames * bins);
+        const auto computed = cqt.compute(std::cbegin(input), std::cend(input), std::begin(single), 1);
+        cqt.compute(std::cbegin(input), std::cend(input), std::begin(multi), 4);
+
+        // The samples are pushed in chunks of several lengths, shorter and longer than the hop size.
+        const std::vector<std::size_t> lengths = {1, 7, hop_size, 3 * hop_size + 1, 100};
+        std::size_t emitted = 0;
+        for (std::size_t position = 0, call = 0; position < input.size(); ++call) {
+            const auto count = std::min(lengths[call % lengths.size()], input.size() - position);
+            emitted += cqt.push(std::cbegin(input) + position, std::cbegin(input) + position + count,
+                                std::begin(streamed) + emitted * bins);
+            position += count;
+        }
+
+        const auto expected  = reference(cqt, input, frames, gamma, q);
+        const auto batch     = std::vector<std::complex<double>>(std::cbegin(single), std::cend(single));
+        const auto error     = distance(single, expected);
+        const auto threads   = distance(multi, batch);
+        const auto streaming = distance(streamed, batch);
+        std::printf("hop %4zu gamma %4.1f threshold %g: %zu frames, error %.3g threads %.3g push %.3g\n", hop_size,
+                    static_cast<double>(gamma), static_cast<double>(threshold), frames, error, threads, streaming);
+        return frames == 10 && computed == frames && emitted == frames && error < tolerance && threads < 1e-6 &&
+               streaming < 1e-6;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    passed &= check(run(256, 0, 0, 1e-4), "constant q without threshold");
+    passed &= check(run(256, 0, 0.0005f, 1e-3), "constant q with the default threshold");
+    passed &= check(run(512, 20, 0, 1e-4), "variable q without threshold");
+    passed &= check(run(4096, 0, 0, 1e-4), "hop size longer than the frame");
+    return passed ? 0 : 1;
+}
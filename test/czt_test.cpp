@@ -0,0 +1,147 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: czt_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/czt.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::spectral;
+
+namespace {
+
+    using wide_type = std::complex<long double>;
+
+    constexpr long double two_pi = 2 * 3.141592653589793238462643383279502884L;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Naive evaluation of the Z-transform at z_k = a w^-k, computed in extended precision.
+    template <typename Sample>
+    std::vector<wide_type> reference(const std::vector<Sample>& input, std::size_t points, wide_type w, wide_type a) {
+        std::vector<wide_type> output(points);
+        for (std::size_t k = 0; k < points; ++k) {
+            const auto z  = a * std::pow(w, -static_cast<long double>(k));
+            wide_type sum = 0, power = 1;
+            for (const auto& sample : input) {
+                sum += wide_type(sample) * power;
+                power /= z;
+            }
+            output[k] = sum;
+        }
+        return output;
+    }
+
+    // Largest error relative to the largest magnitude of the expected transform.
+    double error(const std::vector<std::complex<float>>& result, const std::vector<wide_type>& expected) {
+        long double peak = 0, difference = 0;
+        for (std::size_t k = 0; k < expected.size(); ++k) {
+            peak       = std::max(peak, std::abs(expected[k]));
+            difference = std::max(difference, std::abs(wide_type(result[k]) - expected[k]));
+        }
+        return static_cast<double>(difference / peak);
+    }
+
+    template <typename Sample>
+    std::vector<Sample> make_input(std::size_t size);
+
+    template <>
+    std::vector<float> make_input<float>(std::size_t size) {
+        std::mt19937 generator(static_cast<unsigned>(size));
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<float> input(size);
+        std::generate(std::begin(input), std::end(input), [&]() { return distribution(generator); });
+        return input;
+    }
+
+    template <>
+    std::vector<std::complex<float>> make_input<std::complex<float>>(std::size_t size) {
+        std::mt19937 generator(static_cast<unsigned>(size));
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<std::complex<float>> input(size);
+        std::generate(std::begin(input), std::end(input),
+                      [&]() { return std::complex<float>(distribution(generator), distribution(generator)); });
+        return input;
+    }
+
+    // Computes several frames with the same engine and compares every one with the naive evaluation.
+    template <typename Sample>
+    bool run(std::size_t size, std::size_t points, wide_type w, wide_type a) {
+        czt_engine<float> engine(size, points, w, a);
+        std::vector<std::complex<float>> output(points);
+        double worst = 0;
+        for (std::size_t frame = 0; frame < 3; ++frame) {
+            const auto input = make_input<Sample>(size + frame);
+            const std::vector<Sample> samples(std::cbegin(input) + frame, std::cend(input));
+            engine.compute(std::cbegin(samples), std::cend(samples), std::begin(output));
+            worst = std::max(worst, error(output, reference(samples, points, w, a)));
+        }
+        std::printf("size %5zu points %5zu nfft %6zu: max relative error %.3g\n", size, points, engine.nfft(), worst);
+        return worst < 1e-5;
+    }
+
+    // The zoom FFT of a tone between two DFT bins, compared with the naive DTFT on the band.
+    bool run_zoom(std::size_t size, std::size_t points, float start, float stop, float sample_rate) {
+        std::vector<float> input(size);
+        for (std::size_t n = 0; n < size; ++n) {
+            input[n] = static_cast<float>(std::sin(two_pi * 50.3L * n / sample_rate));
+        }
+        std::vector<std::complex<float>> output(points), oneshot(points);
+        auto engine = make_zoom_fft(size, points, start, stop, sample_rate);
+        engine.compute(std::cbegin(input), std::cend(input), std::begin(output));
+        zoom_fft(std::cbegin(input), std::cend(input), std::begin(oneshot), points, start, stop, sample_rate);
+
+        const auto step = (stop - start) / static_cast<long double>(points - 1);
+        const auto w    = std::polar(1.0L, -two_pi * step / sample_rate);
+        const auto a    = std::polar(1.0L, two_pi * start / sample_rate);
+
+        const auto expected      = reference(input, points, w, a);
+        const auto engine_error  = error(output, expected);
+        const auto oneshot_error = error(oneshot, expected);
+        std::printf("zoom %5zu samples %5zu points: max relative error %.3g one-shot %.3g\n", size, points,
+                    engine_error, oneshot_error);
+        return engine_error < 1e-5 && oneshot_error < 1e-5;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    const auto dft = [](std::size_t size) { return std::polar(1.0L, -two_pi / static_cast<long double>(size)); };
+    passed &= check(run<float>(64, 64, dft(64), 1), "dft of a power of two size");
+    passed &= check(run<std::complex<float>>(100, 100, dft(100), 1), "dft of a complex sequence");
+    passed &= check(run<float>(300, 37, std::polar(1.0L, -0.001L), std::polar(1.0L, 0.3L)),
+                    "fewer points than samples");
+    passed &= check(run<float>(37, 500, std::polar(1.0L, -0.01L), std::polar(1.0L, -0.7L)),
+                    "more points than samples");
+    passed &= check(run<std::complex<float>>(64, 80, std::polar(1.0005L, -0.05L), std::polar(0.98L, 0.1L)),
+                    "spiral arc");
+    passed &= check(run_zoom(1000, 501, 45, 55, 1000), "zoom fft around a tone");
+    passed &= check(run_zoom(4096, 64, 49.5f, 51.0f, 1000), "zoom fft of a narrow band");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: fft_plan_cache_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/fft_engine.hpp>
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace edsp::spectral;
+
+namespace {
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    fft_plan_key make_key(std::size_t size) {
+        return fft_plan_key{size, typeid(char), fft_kind::ComplexForward, fft_rigor::Estimate, false, false, {}};
+    }
+
+    fft_plan_cache::plan_handle make_plan() {
+        return fft_plan_cache::plan_handle(new int(0), [](void* p) { delete static_cast<int*>(p); });
+    }
+
+    // Steady-state calls never plan: a second identical transform is served from the cache.
+    bool steady_state() {
+        auto& cache = fft_plan_cache::instance();
+        cache.clear();
+        cache.reset_stats();
+
+        const std::size_t nfft = 1024;
+        std::vector<float> input(nfft, 1);
+        std::vector<std::complex<float>> output(make_fft_size(nfft));
+        fft_engine<float>(nfft).dft(input.data(), output.data());
+        const auto first = cache.stats();
+        fft_engine<float>(nfft).dft(input.data(), output.data());
+        const auto second = cache.stats();
+
+        bool passed = check(first.misses > 0, "the first transform creates its plans");
+        passed &= check(second.misses == first.misses, "the second transform does not plan");
+        passed &= check(second.hits > first.hits, "the second transform hits the cache");
+        return passed;
+    }
+
+    // A plan being created never blocks the requests of the plans already stored.
+    bool concurrent_planning() {
+        auto& cache = fft_plan_cache::instance();
+        cache.clear();
+        cache.acquire(make_key(1), make_plan);
+
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        auto slow     = std::async(std::launch::async, [&]() {
+            return cache.acquire(make_key(2), [released]() {
+                released.wait();
+                return make_plan();
+            });
+        });
+        while (cache.size() < 2) {
+            std::this_thread::yield();
+        }
+
+        auto hit    = std::async(std::launch::async, [&]() { return cache.acquire(make_key(1), make_plan); });
+        bool passed = check(hit.wait_for(std::chrono::seconds(5)) == std::future_status::ready,
+                            "a hit is served while another plan is created");
+        release.set_value();
+        passed &= check(slow.get() != nullptr, "the slow plan is published");
+
+        const auto misses = cache.stats().misses;
+        cache.acquire(make_key(2), make_plan);
+        passed &= check(cache.stats().misses == misses, "the slow plan is reused");
+        return passed;
+    }
+
+    // A failed creation is reported to the caller and is not stored.
+    bool failed_planning() {
+        auto& cache = fft_plan_cache::instance();
+        cache.clear();
+
+        bool thrown = false;
+        try {
+            cache.acquire(make_key(3), []() -> fft_plan_cache::plan_handle { throw std::runtime_error("failure"); });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        bool passed = check(thrown, "the exception of the factory is propagated");
+        passed &= check(cache.size() == 0, "the failed plan is not stored");
+        passed &= check(cache.acquire(make_key(3), make_plan) != nullptr, "the plan can be created again");
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = steady_state();
+    passed &= concurrent_planning();
+    passed &= failed_planning();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: fir_filter_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/filter/fir_filter.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::filter;
+
+namespace {
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Direct convolution computed in double precision.
+    std::vector<double> reference(const std::vector<float>& coefficients, const std::vector<float>& input) {
+        std::vector<double> output(input.size(), 0);
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            for (std::size_t j = 0; j < coefficients.size() && j <= i; ++j) {
+                output[i] += static_cast<double>(coefficients[j]) * static_cast<double>(input[i - j]);
+            }
+        }
+        return output;
+    }
+
+    // Filters the input in calls of mixed lengths, around the FFT threshold and the block size, then sample by sample
+    // after a reset, and compares both with the direct convolution.
+    bool run(std::size_t taps, std::size_t crossover, bool uses_fft) {
+        std::mt19937 generator(static_cast<unsigned>(taps + crossover));
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<float> coefficients(taps), input(8 * taps + 4096);
+        std::generate(std::begin(coefficients), std::end(coefficients), [&]() { return distribution(generator); });
+        std::generate(std::begin(input), std::end(input), [&]() { return distribution(generator); });
+        const auto expected = reference(coefficients, input);
+        double norm         = 0;
+        for (const auto coefficient : coefficients) {
+            norm += std::abs(static_cast<double>(coefficient));
+        }
+
+        fir_filter<float> filter(std::cbegin(coefficients), std::cend(coefficients), crossover);
+        const auto threshold = std::max<std::size_t>(filter.fft_threshold(), 2);
+        const std::vector<std::size_t> lengths = {1, 3, threshold - 1, threshold, threshold + 1, 2 * taps + 5,
+                                                  17, 1000};
+        std::vector<float> output(input.size());
+        for (std::size_t position = 0, call = 0; position < input.size(); ++call) {
+            const auto count = std::min(lengths[call % lengths.size()], input.size() - position);
+            filter.filter(std::cbegin(input) + position, std::cbegin(input) + position + count,
+                          std::begin(output) + position);
+            position += count;
+        }
+        double block_error = 0;
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            block_error = std::max(block_error, std::abs(output[i] - expected[i]));
+        }
+
+        filter.reset();
+        double tick_error = 0;
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            tick_error = std::max(tick_error, std::abs(filter(input[i]) - expected[i]));
+        }
+        std::printf("taps %5zu fft %d threshold %4zu: block error %.3g tick error %.3g\n", taps, filter.uses_fft(),
+                    filter.fft_threshold(), block_error, tick_error);
+        const auto tolerance = 1e-6 * norm;
+        return filter.uses_fft() == uses_fft && block_error < tolerance && tick_error < tolerance;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    passed &= check(run(1, fir_filter<float>::default_crossover, false), "single coefficient in direct form");
+    passed &= check(run(31, fir_filter<float>::default_crossover, false), "short kernel in direct form");
+    passed &= check(run(31, 1, true), "short kernel with overlap-save");
+    passed &= check(run(191, fir_filter<float>::default_crossover, false), "kernel below the crossover");
+    passed &= check(run(192, fir_filter<float>::default_crossover, true), "kernel at the crossover");
+    passed &= check(run(1000, fir_filter<float>::default_crossover, true), "long kernel with overlap-save");
+    passed &= check(run(1000, 2000, false), "long kernel forced in direct form");
+    return passed ? 0 : 1;
+}
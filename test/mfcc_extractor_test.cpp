@@ -0,0 +1,187 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: mfcc_extractor_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/feature/spectral/mfcc_extractor.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::feature;
+using edsp::windowing::WindowType;
+
+namespace {
+
+    constexpr float sample_rate        = 16000;
+    constexpr std::size_t frame_size   = 400;
+    constexpr std::size_t nfft         = 512;
+    constexpr std::size_t filters      = 26;
+    constexpr std::size_t coefficients = 13;
+    constexpr std::size_t frames       = 20;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Frames of a chirp with noise, so the coefficients change from frame to frame.
+    std::vector<float> make_frames() {
+        std::mt19937 generator(3);
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<float> input(frames * frame_size);
+        for (std::size_t n = 0; n < input.size(); ++n) {
+            const auto time = static_cast<double>(n) / sample_rate;
+            const auto tone = std::sin(2 * M_PI * (200 + 4000 * time) * time);
+            input[n]        = static_cast<float>(tone) + distribution(generator) / 8;
+        }
+        return input;
+    }
+
+    // Naive window, DFT, filterbank, logarithm and orthonormal DCT-II, computed in double precision.
+    std::vector<double> reference(const mfcc_extractor<float>& extractor, const float* frame) {
+        std::vector<double> window(frame_size);
+        edsp::windowing::make_window(WindowType::Hamming, std::begin(window), std::end(window));
+        const auto& bank = extractor.filterbank();
+        std::vector<double> power(nfft / 2 + 1), energies(filters, 0), output(coefficients, 0);
+        for (std::size_t k = 0; k < power.size(); ++k) {
+            std::complex<double> sum = 0;
+            for (std::size_t n = 0; n < frame_size; ++n) {
+                const auto phase = -2 * M_PI * static_cast<double>((k * n) % nfft) / nfft;
+                sum += frame[n] * window[n] * std::polar(1.0, phase);
+            }
+            power[k] = std::norm(sum);
+        }
+        for (std::size_t m = 0; m < filters; ++m) {
+            for (std::size_t k = 0; k < power.size(); ++k) {
+                energies[m] += static_cast<double>(bank.weight(m, k)) * power[k];
+            }
+            energies[m] = std::log(energies[m]);
+        }
+        for (std::size_t k = 0; k < coefficients; ++k) {
+            for (std::size_t m = 0; m < filters; ++m) {
+                output[k] += energies[m] * std::cos(M_PI * static_cast<double>(k * (2 * m + 1)) / (2 * filters));
+            }
+            output[k] *= std::sqrt((k == 0 ? 1.0 : 2.0) / filters);
+        }
+        return output;
+    }
+
+    // Regression over a whole sequence of vectors, replicating the first and last ones at the edges.
+    std::vector<std::vector<double>> regression(const std::vector<std::vector<double>>& input, std::size_t width) {
+        const auto last = static_cast<std::ptrdiff_t>(input.size()) - 1;
+        double sum      = 0;
+        for (std::size_t n = 1; n <= width; ++n) {
+            sum += static_cast<double>(n * n);
+        }
+        std::vector<std::vector<double>> output(input.size(), std::vector<double>(input[0].size(), 0));
+        for (std::ptrdiff_t t = 0; t <= last; ++t) {
+            for (std::size_t n = 1; n <= width; ++n) {
+                const auto next     = std::min(t + static_cast<std::ptrdiff_t>(n), last);
+                const auto previous = std::max(t - static_cast<std::ptrdiff_t>(n), std::ptrdiff_t{0});
+                for (std::size_t i = 0; i < input[0].size(); ++i) {
+                    output[t][i] += static_cast<double>(n) * (input[next][i] - input[previous][i]) / (2 * sum);
+                }
+            }
+        }
+        return output;
+    }
+
+    bool run_coefficients() {
+        mfcc_extractor<float> extractor(sample_rate, frame_size, nfft, filters, coefficients, 20, 8000);
+        const auto input = make_frames();
+        std::vector<float> output(frames * coefficients);
+        extractor.compute(std::cbegin(input), frames, std::begin(output));
+        double error = 0;
+        for (std::size_t f = 0; f < frames; ++f) {
+            const auto expected = reference(extractor, input.data() + f * frame_size);
+            for (std::size_t k = 0; k < coefficients; ++k) {
+                error = std::max(error, std::abs(output[f * coefficients + k] - expected[k]));
+            }
+        }
+        std::printf("coefficients: max error %.3g\n", error);
+        return error < 1e-3;
+    }
+
+    // Pushes all the frames, flushes the pending ones and compares the features with the offline regressions of the
+    // coefficients.
+    bool run_deltas(std::size_t order, std::size_t width) {
+        mfcc_extractor<float> extractor(sample_rate, frame_size, nfft, filters, coefficients, 20, 8000,
+                                        WindowType::Hamming, order, width);
+        const auto input = make_frames();
+        std::vector<std::vector<double>> cepstra(frames, std::vector<double>(coefficients));
+        std::vector<float> values(coefficients);
+        for (std::size_t f = 0; f < frames; ++f) {
+            extractor.compute(std::cbegin(input) + f * frame_size, std::begin(values));
+            std::copy(std::cbegin(values), std::cend(values), std::begin(cepstra[f]));
+        }
+        const auto deltas       = regression(cepstra, width);
+        const auto delta_deltas = regression(deltas, width);
+
+        bool passed = true;
+        for (auto pass = 0; pass < 2; ++pass) {
+            extractor.reset();
+            std::vector<std::vector<float>> features;
+            std::vector<float> feature(extractor.features());
+            for (std::size_t f = 0; f < frames; ++f) {
+                if (extractor.push(std::cbegin(input) + f * frame_size, std::begin(feature))) {
+                    features.push_back(feature);
+                }
+            }
+            const auto delayed = features.size();
+            while (extractor.flush(std::begin(feature))) {
+                features.push_back(feature);
+            }
+
+            double error = 0;
+            for (std::size_t f = 0; f < std::min(features.size(), frames); ++f) {
+                for (std::size_t k = 0; k < coefficients; ++k) {
+                    error = std::max(error, std::abs(features[f][k] - cepstra[f][k]));
+                    if (order > 0) {
+                        error = std::max(error, std::abs(features[f][coefficients + k] - deltas[f][k]));
+                    }
+                    if (order > 1) {
+                        error = std::max(error, std::abs(features[f][2 * coefficients + k] - delta_deltas[f][k]));
+                    }
+                }
+            }
+            std::printf("order %zu width %zu pass %d: %zu frames, %zu delayed, max error %.3g\n", order, width, pass,
+                        features.size(), frames - delayed, error);
+            const auto latency = std::min(extractor.latency(), frames);
+            passed &= features.size() == frames && frames - delayed == latency && error < 1e-5;
+        }
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    passed &= check(run_coefficients(), "coefficients against a naive computation");
+    passed &= check(run_deltas(0, 2), "features without deltas");
+    passed &= check(run_deltas(1, 2), "first order deltas");
+    passed &= check(run_deltas(2, 2), "second order deltas");
+    passed &= check(run_deltas(2, 1), "second order deltas of width one");
+    passed &= check(run_deltas(2, 12), "deltas wider than half of the stream");
+    return passed ? 0 : 1;
+}
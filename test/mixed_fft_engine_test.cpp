@@ -0,0 +1,119 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: mixed_fft_engine_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/mixed_fft_engine.hpp>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::spectral;
+
+namespace {
+
+    using wide_type = std::complex<long double>;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Signal to noise ratio in dB of a result, the error being measured against the extended precision transform.
+    template <typename Container>
+    double snr(const Container& result, const std::vector<wide_type>& expected) {
+        long double signal = 0, noise = 0;
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            signal += std::norm(expected[i]);
+            noise += std::norm(wide_type(result[i]) - expected[i]);
+        }
+        return static_cast<double>(10 * std::log10(signal / noise));
+    }
+
+    // Compares the mixed engine with the same native algorithms computed entirely in float: keeping the twiddle
+    // factors and the butterflies in double should gain at least 4 dB of SNR.
+    bool run(std::size_t size) {
+        std::mt19937 generator(static_cast<unsigned>(size));
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        const auto bins = size / 2 + 1;
+        std::vector<std::complex<float>> signal(size), spectrum(size), single(size), mixed(size);
+        std::vector<float> real(size), single_real(size), mixed_real(size);
+        std::vector<wide_type> wide_signal(size), wide_spectrum(size), wide_real(size), expected(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            signal[i]      = {distribution(generator), distribution(generator)};
+            real[i]        = distribution(generator);
+            wide_signal[i] = wide_type(signal[i]);
+            wide_real[i]   = wide_type(real[i]);
+        }
+
+        native_fft_impl<long double> reference(static_cast<int>(size), fft_plan_policy{});
+        native_fft_impl<float> native(static_cast<int>(size), fft_plan_policy{});
+        mixed_fft_engine<float> engine(size);
+        bool passed = true;
+        const auto compare = [&](const char* transform, double single_snr, double mixed_snr) {
+            std::printf("size %6zu %-14s float %.1f dB mixed %.1f dB\n", size, transform, single_snr, mixed_snr);
+            passed &= (mixed_snr >= single_snr + 4);
+        };
+
+        reference.dft(wide_signal.data(), expected.data());
+        native.dft(signal.data(), single.data());
+        engine.dft(signal.data(), mixed.data());
+        compare("complex dft", snr(single, expected), snr(mixed, expected));
+
+        reference.idft(wide_signal.data(), expected.data());
+        native.idft(signal.data(), single.data());
+        engine.idft(signal.data(), mixed.data());
+        compare("complex idft", snr(single, expected), snr(mixed, expected));
+
+        std::vector<long double> real_input(std::cbegin(real), std::cend(real));
+        expected.resize(bins);
+        reference.dft(real_input.data(), expected.data());
+        native.dft(real.data(), single.data());
+        engine.dft(real.data(), mixed.data());
+        compare("real dft", snr(single, expected), snr(mixed, expected));
+
+        // The spectrum of the real signal is transformed back, its imaginary DC and Nyquist parts being zero.
+        for (std::size_t k = 0; k < bins; ++k) {
+            spectrum[k] = std::complex<float>(static_cast<float>(expected[k].real()),
+                                              static_cast<float>(expected[k].imag()));
+            wide_spectrum[k] = wide_type(spectrum[k]);
+        }
+        std::vector<long double> expected_real(size);
+        reference.idft(wide_spectrum.data(), expected_real.data());
+        native.idft(spectrum.data(), single_real.data());
+        engine.idft(spectrum.data(), mixed_real.data());
+        expected.assign(std::cbegin(expected_real), std::cend(expected_real));
+        compare("real idft", snr(single_real, expected), snr(mixed_real, expected));
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    for (const std::size_t size : {256u, 1000u, 4096u, 12000u, 65536u}) {
+        char name[64]{};
+        std::snprintf(name, sizeof(name), "size %zu gains accuracy over float", size);
+        passed &= check(run(size), name);
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: native_fft_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/internal/native_fft_impl.hpp>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::spectral;
+
+namespace {
+
+    using complex_type = std::complex<double>;
+
+    constexpr double tolerance = 1e-9;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Naive DFT computed in extended precision, sign -1 for the forward transform and +1 for the backward one.
+    std::vector<complex_type> reference(const std::vector<complex_type>& input, int sign) {
+        const auto size = input.size();
+        std::vector<complex_type> output(size);
+        for (std::size_t k = 0; k < size; ++k) {
+            std::complex<long double> sum = 0;
+            for (std::size_t n = 0; n < size; ++n) {
+                const auto angle = sign * 2 * 3.141592653589793238462643383279502884L *
+                                   static_cast<long double>((k * n) % size) / static_cast<long double>(size);
+                sum += std::complex<long double>(input[n]) * std::polar(1.0L, angle);
+            }
+            output[k] = complex_type(static_cast<double>(sum.real()), static_cast<double>(sum.imag()));
+        }
+        return output;
+    }
+
+    template <typename Container1, typename Container2>
+    double distance(const Container1& x, const Container2& y, std::size_t count) {
+        double error = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            error = std::max(error, std::abs(complex_type(x[i]) - complex_type(y[i])));
+        }
+        return error;
+    }
+
+    bool run(std::size_t size) {
+        std::mt19937 generator(static_cast<unsigned>(size));
+        std::uniform_real_distribution<double> distribution(-1, 1);
+        std::vector<complex_type> signal(size);
+        std::vector<double> real(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            signal[i] = complex_type(distribution(generator), distribution(generator));
+            real[i]   = distribution(generator);
+        }
+        const auto scale = static_cast<double>(size) * tolerance;
+        const auto bins  = size / 2 + 1;
+        native_fft_impl<double> engine(static_cast<int>(size), fft_plan_policy{});
+        char name[64]{};
+        bool passed = true;
+
+        // Complex transforms
+        std::vector<complex_type> spectrum(size), output(size);
+        engine.dft(signal.data(), spectrum.data());
+        std::snprintf(name, sizeof(name), "complex forward matches the reference, N = %zu", size);
+        passed &= check(distance(spectrum, reference(signal, -1), size) < scale, name);
+        engine.idft(spectrum.data(), output.data());
+        engine.idft_scale(output.data());
+        std::snprintf(name, sizeof(name), "complex round trip, N = %zu", size);
+        passed &= check(distance(output, signal, size) < scale, name);
+
+        // Real transforms
+        const auto expected = reference(std::vector<complex_type>(std::cbegin(real), std::cend(real)), -1);
+        std::vector<complex_type> half(bins);
+        std::vector<double> restored(size);
+        engine.dft(real.data(), half.data());
+        std::snprintf(name, sizeof(name), "real forward matches the reference, N = %zu", size);
+        passed &= check(distance(half, expected, bins) < scale, name);
+        engine.idft(half.data(), restored.data());
+        engine.idft_scale(restored.data());
+        std::snprintf(name, sizeof(name), "real round trip, N = %zu", size);
+        passed &= check(distance(restored, real, size) < scale, name);
+
+        // The imaginary parts of the DC and Nyquist bins of a Hermitian spectrum are ignored.
+        half.front() += complex_type(0, 1);
+        if (size % 2 == 0) {
+            half.back() += complex_type(0, 1);
+        }
+        engine.idft(half.data(), restored.data());
+        engine.idft_scale(restored.data());
+        std::snprintf(name, sizeof(name), "real backward ignores the DC and Nyquist phase, N = %zu", size);
+        passed &= check(distance(restored, real, size) < scale, name);
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    for (const std::size_t size : {1, 2, 3, 5, 8, 12, 16, 17, 64, 100, 1024}) {
+        passed &= run(size);
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: parallel_biquad_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/filter.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::filter;
+
+namespace {
+
+    constexpr std::size_t max_order = 16;
+    constexpr std::size_t samples   = 1 << 14;
+
+    template <typename T>
+    using cascade = biquad_cascade<T, max_order / 2>;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // The output of the parallel form is compared against a long double cascade with fixed bounds, independent of the
+    // error of the cascade in the same precision: the root mean square error relative to the one of the reference
+    // output, and the maximum absolute error. The inputs are bounded by one.
+    template <typename T>
+    bool equivalent(const cascade<T>& serial, const std::vector<T>& input, double relative, double absolute) {
+        cascade<long double> reference;
+        for (const auto& stage : serial) {
+            reference.emplace_back(static_cast<long double>(stage.a0()), static_cast<long double>(stage.a1()),
+                                   static_cast<long double>(stage.a2()), static_cast<long double>(stage.b0()),
+                                   static_cast<long double>(stage.b1()), static_cast<long double>(stage.b2()));
+        }
+        auto parallel = make_parallel_biquad(serial);
+        std::vector<T> output(input.size());
+        parallel.filter(std::cbegin(input), std::cend(input), std::begin(output));
+
+        long double energy = 0, error = 0, maximum = 0;
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            const auto expected   = reference.tick(static_cast<long double>(input[i]));
+            const auto difference = std::abs(output[i] - expected);
+            energy += expected * expected;
+            error += difference * difference;
+            maximum = std::max(maximum, difference);
+        }
+        const auto rms = static_cast<double>(std::sqrt(error / energy));
+        if (rms > relative || maximum > absolute) {
+            std::printf("relative error %.3g, absolute error %.3g\n", rms, static_cast<double>(maximum));
+            return false;
+        }
+        return true;
+    }
+
+    // Every design is checked with an impulse and with white noise.
+    template <typename T>
+    bool run(const char* type, double relative, double absolute) {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<T> distribution(-1, 1);
+        std::vector<T> noise(samples), impulse(samples, 0);
+        std::generate(std::begin(noise), std::end(noise), [&]() { return distribution(generator); });
+        impulse[0] = 1;
+
+        bool passed     = true;
+        const auto rate = static_cast<T>(48000);
+        char name[64]{};
+        for (std::size_t order = 2; order <= max_order; order += 2) {
+            const cascade<T> designs[] = {
+                designer<T, designer_type::Butterworth, max_order>{}.template design<filter_type::LowPass>(
+                    order, rate, static_cast<T>(2000)),
+                designer<T, designer_type::Butterworth, max_order>{}.template design<filter_type::HighPass>(
+                    order, rate, static_cast<T>(500)),
+                designer<T, designer_type::ChebyshevI, max_order>{}.template design<filter_type::LowPass>(
+                    order, rate, static_cast<T>(4000), static_cast<T>(1))};
+            const char* names[] = {"butterworth lp", "butterworth hp", "chebyshev I lp"};
+            for (std::size_t i = 0; i < 3; ++i) {
+                std::snprintf(name, sizeof(name), "%s %s %zu is equivalent", type, names[i], order);
+                passed &= check(equivalent(designs[i], impulse, relative, absolute) &&
+                                    equivalent(designs[i], noise, relative, absolute),
+                                name);
+            }
+        }
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = run<float>("float", 1e-3, 2e-3);
+    passed &= run<double>("double", 2e-12, 5e-12);
+    return passed ? 0 : 1;
+}
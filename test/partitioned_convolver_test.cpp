@@ -0,0 +1,97 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: partitioned_convolver_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/partitioned_convolver.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::spectral;
+
+namespace {
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Direct convolution computed in double precision.
+    std::vector<double> reference(const std::vector<float>& response, const std::vector<float>& input) {
+        std::vector<double> output(input.size(), 0);
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            for (std::size_t j = 0; j < response.size() && j <= i; ++j) {
+                output[i] += static_cast<double>(response[j]) * static_cast<double>(input[i - j]);
+            }
+        }
+        return output;
+    }
+
+    // Compares the engine with the direct convolution, processing the input in calls of several blocks, before and
+    // after a reset.
+    bool run(std::size_t taps, std::size_t block_size, std::size_t max_block_size) {
+        std::mt19937 generator(static_cast<unsigned>(taps));
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<float> response(taps), input(4 * taps + 8 * max_block_size);
+        std::generate(std::begin(response), std::end(response), [&]() { return distribution(generator); });
+        std::generate(std::begin(input), std::end(input), [&]() { return distribution(generator); });
+        input.resize(input.size() - input.size() % block_size);
+        const auto expected = reference(response, input);
+        const auto peak     = std::abs(*std::max_element(std::cbegin(expected), std::cend(expected),
+                                                     [](double x, double y) { return std::abs(x) < std::abs(y); }));
+
+        partitioned_convolver<float> convolver(std::cbegin(response), std::cend(response), block_size,
+                                               max_block_size);
+        bool passed = true;
+        char name[64]{};
+        for (const auto pass : {"", " after reset"}) {
+            std::vector<float> output(input.size());
+            const std::size_t calls[] = {1, 3, 2, 5};
+            for (std::size_t i = 0, call = 0; i < input.size(); ++call) {
+                const auto count = std::min(calls[call % 4] * block_size, input.size() - i);
+                convolver.process(std::cbegin(input) + i, std::cbegin(input) + i + count, std::begin(output) + i);
+                i += count;
+            }
+            double error = 0;
+            for (std::size_t i = 0; i < input.size(); ++i) {
+                error = std::max(error, std::abs(static_cast<double>(output[i]) - expected[i]));
+            }
+            std::snprintf(name, sizeof(name), "%zu taps, blocks of %zu to %zu%s", taps, block_size, max_block_size,
+                          pass);
+            passed &= check(error <= 1e-5 * peak, name);
+            convolver.reset();
+        }
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = run(1000, 64, 64);
+    passed &= run(777, 32, 32);
+    passed &= run(1000, 16, 256);
+    passed &= run(5000, 64, 1024);
+    passed &= run(3000, 48, 768);
+    passed &= run(12000, 16, 2048);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: sliding_dft_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/sliding_dft.hpp>
+#include <edsp/spectral/goertzel_bank.hpp>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::spectral;
+
+namespace {
+
+    constexpr std::size_t size    = 256;
+    constexpr std::size_t samples = 1 << 20;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // DFT of the last size samples ending at the position last, every sample weighted by damping^age, computed in
+    // double precision.
+    std::complex<double> reference(const std::vector<float>& input, std::size_t last, std::size_t bin,
+                                   double damping) {
+        std::complex<double> sum = 0;
+        double weight            = 1;
+        for (std::size_t age = 0; age < size && age <= last; ++age, weight *= damping) {
+            const auto position = size - 1 - age;
+            const auto angle    = -2 * M_PI * static_cast<double>((bin * position) % size) / size;
+            sum += weight * static_cast<double>(input[last - age]) * std::polar(1.0, angle);
+        }
+        return sum;
+    }
+
+    std::vector<float> make_input() {
+        // A random signal with a DC offset, which drives the double pole of the DC resonator.
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<float> input(samples);
+        for (auto& sample : input) {
+            sample = 0.5f + distribution(generator);
+        }
+        return input;
+    }
+
+    // Follows a long single precision stream and compares the bins with the DFT of the window at regular positions.
+    // The error should stay at the level of a single window, instead of growing with the length of the stream.
+    template <typename Tracker, typename Reader>
+    double track(Tracker& tracker, const std::vector<std::size_t>& bins, double damping, Reader read) {
+        const auto input = make_input();
+        double error     = 0;
+        for (std::size_t i = 0; i < samples; ++i) {
+            tracker.update(input[i]);
+            if (i % 997 == 0 || i + 1 == samples) {
+                for (std::size_t j = 0; j < bins.size(); ++j) {
+                    const auto expected = reference(input, i, bins[j], damping);
+                    error               = std::max(error, std::abs(read(tracker, j) - expected));
+                }
+            }
+        }
+        return error;
+    }
+
+    bool run_sliding_dft(SlidingDftMode mode) {
+        const std::vector<std::size_t> bins = {0, 1, 5, 64, 127, 128};
+        sliding_dft<float> tracker(size, std::cbegin(bins), std::cend(bins), mode);
+        const auto error = track(tracker, bins, 1.0, [](const sliding_dft<float>& dft, std::size_t j) {
+            return std::complex<double>(dft[j]);
+        });
+        std::printf("sliding dft %-10s max error %.3g\n", mode == SlidingDftMode::Recursive ? "recursive" : "modulated",
+                    error);
+        return error < 1e-3;
+    }
+
+    bool run_goertzel_bank(float damping) {
+        const float rate                    = static_cast<float>(size);
+        const std::vector<float> frequency  = {0, 1, 5, 64, 127, 128};
+        const std::vector<std::size_t> bins = {0, 1, 5, 64, 127, 128};
+        goertzel_bank<float> tracker(std::cbegin(frequency), std::cend(frequency), rate, size, damping);
+        const auto error = track(tracker, bins, damping, [](const goertzel_bank<float>& bank, std::size_t j) {
+            return std::complex<double>(bank[j]);
+        });
+        std::printf("goertzel damping %.3f max error %.3g\n", static_cast<double>(damping), error);
+        // The resonators amplify the rounding errors by up to N (the double pole of the DC and Nyquist bins), even
+        // within a single window.
+        return error < 1e-3 * size;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    passed &= check(run_sliding_dft(SlidingDftMode::Recursive), "recursive sliding dft over a long stream");
+    passed &= check(run_sliding_dft(SlidingDftMode::Modulated), "modulated sliding dft over a long stream");
+    passed &= check(run_goertzel_bank(1.0f), "undamped goertzel bank over a long stream");
+    passed &= check(run_goertzel_bank(0.999f), "damped goertzel bank over a long stream");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: state_variable_filter_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/filter.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::filter;
+
+namespace {
+
+    constexpr std::size_t samples = 1 << 14;
+    constexpr double rate         = 48000;
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    std::vector<double> make_input() {
+        std::mt19937 generator(11);
+        std::uniform_real_distribution<double> distribution(-1, 1);
+        std::vector<double> input(samples);
+        std::generate(std::begin(input), std::end(input), [&]() { return distribution(generator); });
+        return input;
+    }
+
+    // The responses of the RBJ low pass and high pass designs in double precision. The band pass design has a
+    // constant skirt gain, as the band pass output of the filter; the notch and the peak responses are the sum and
+    // the difference of the low pass and the high pass ones.
+    struct reference_type {
+        std::vector<double> low, band, high, notch, peak;
+    };
+
+    reference_type reference(const std::vector<double>& input, double fc, double Q) {
+        auto low  = RBJFilterDesigner<double, filter_type::LowPass>{}(fc, rate, Q);
+        auto band = RBJFilterDesigner<double, filter_type::BandPass>{}(fc, rate, Q);
+        auto high = RBJFilterDesigner<double, filter_type::HighPass>{}(fc, rate, Q);
+        reference_type output;
+        for (const auto value : input) {
+            output.low.push_back(low.tick(value));
+            output.band.push_back(band.tick(value));
+            output.high.push_back(high.tick(value));
+            output.notch.push_back(output.low.back() + output.high.back());
+            output.peak.push_back(output.low.back() - output.high.back());
+        }
+        return output;
+    }
+
+    template <typename T>
+    double relative_error(const std::vector<T>& output, const std::vector<double>& expected) {
+        double error = 0, peak = 0;
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            error = std::max(error, std::abs(static_cast<double>(output[i]) - expected[i]));
+            peak  = std::max(peak, std::abs(expected[i]));
+        }
+        return error / peak;
+    }
+
+    template <typename T, svf_mode Mode>
+    double process_error(const std::vector<double>& input, const std::vector<double>& expected, double fc, double Q) {
+        state_variable_filter<T> filter(static_cast<T>(rate), static_cast<T>(fc), static_cast<T>(Q));
+        std::vector<T> output(std::cbegin(input), std::cend(input));
+        const std::size_t chunks[] = {1, 63, 64, 65, 1000};
+        for (std::size_t n = 0, i = 0; n < samples; n += chunks[i++ % 5]) {
+            filter.template process<Mode>(output.data() + n, std::min(chunks[i % 5], samples - n));
+        }
+        return relative_error(output, expected);
+    }
+
+    // Compares tick and the block processing of every response with a fixed cutoff frequency against the RBJ
+    // designs, which share the bilinear transform with frequency prewarping and therefore the transfer function.
+    template <typename T>
+    bool run(const char* type, double fc, double Q, double tolerance) {
+        const auto input    = make_input();
+        const auto expected = reference(input, fc, Q);
+
+        state_variable_filter<T> filter(static_cast<T>(rate), static_cast<T>(fc), static_cast<T>(Q));
+        std::vector<T> low, band, high, notch, peak;
+        for (const auto value : input) {
+            const auto response = filter.tick(static_cast<T>(value));
+            low.push_back(response.low);
+            band.push_back(response.band);
+            high.push_back(response.high);
+            notch.push_back(response.notch);
+            peak.push_back(response.peak);
+        }
+
+        const double ticks[] = {relative_error(low, expected.low), relative_error(band, expected.band),
+                                relative_error(high, expected.high), relative_error(notch, expected.notch),
+                                relative_error(peak, expected.peak)};
+        const double blocks[] = {process_error<T, svf_mode::LowPass>(input, expected.low, fc, Q),
+                                 process_error<T, svf_mode::BandPass>(input, expected.band, fc, Q),
+                                 process_error<T, svf_mode::HighPass>(input, expected.high, fc, Q),
+                                 process_error<T, svf_mode::Notch>(input, expected.notch, fc, Q),
+                                 process_error<T, svf_mode::Peak>(input, expected.peak, fc, Q)};
+        const auto error = std::max(*std::max_element(ticks, ticks + 5), *std::max_element(blocks, blocks + 5));
+        std::printf("%-6s fc %7.1f Q %5.2f: tick %.3g %.3g %.3g %.3g %.3g, process %.3g %.3g %.3g %.3g %.3g\n", type,
+                    fc, Q, ticks[0], ticks[1], ticks[2], ticks[3], ticks[4], blocks[0], blocks[1], blocks[2],
+                    blocks[3], blocks[4]);
+        return error < tolerance;
+    }
+
+    // Modulates the cutoff frequency every sample and compares the buffered processing, prewarped with fast_tan,
+    // against set_cutoff and tick every sample.
+    template <typename T>
+    bool run_modulated(const char* type, double tolerance) {
+        const auto input = make_input();
+        std::vector<T> cutoff(samples);
+        for (std::size_t i = 0; i < samples; ++i) {
+            cutoff[i] = static_cast<T>(2000 + 1800 * std::sin(2 * M_PI * 30 * static_cast<double>(i) / rate));
+        }
+
+        const auto Q = static_cast<T>(4);
+        state_variable_filter<T> buffered(static_cast<T>(rate), cutoff[0], Q);
+        state_variable_filter<T> exact(static_cast<T>(rate), cutoff[0], Q);
+        std::vector<T> output(std::cbegin(input), std::cend(input));
+        std::vector<double> expected(samples);
+        const std::size_t chunks[] = {1, 63, 64, 65, 1000};
+        for (std::size_t n = 0, i = 0; n < samples; n += chunks[i++ % 5]) {
+            const auto length = std::min(chunks[i % 5], samples - n);
+            buffered.template process<svf_mode::BandPass>(output.data() + n, cutoff.data() + n, length);
+        }
+        for (std::size_t i = 0; i < samples; ++i) {
+            exact.set_cutoff(cutoff[i]);
+            expected[i] = exact.tick(static_cast<T>(input[i])).band;
+        }
+
+        const auto error = relative_error(output, expected);
+        const auto last  = std::abs(buffered.cutoff() - cutoff.back()) / cutoff.back();
+        std::printf("%-6s modulated: error %.3g, cutoff error %.3g\n", type, error, static_cast<double>(last));
+        return error < tolerance && last < tolerance;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    passed &= check(run<double>("double", 20, 0.707, 1e-9), "double, 20 Hz");
+    passed &= check(run<double>("double", 1000, 2, 1e-12), "double, 1 kHz");
+    passed &= check(run<double>("double", 15000, 0.5, 1e-12), "double, 15 kHz");
+    passed &= check(run<double>("double", 23000, 10, 1e-12), "double, 23 kHz and high resonance");
+    passed &= check(run<float>("float", 1000, 2, 1e-5), "float, 1 kHz");
+    passed &= check(run<float>("float", 15000, 0.5, 1e-5), "float, 15 kHz");
+    passed &= check(run_modulated<double>("double", 1e-10), "double, modulated cutoff");
+    passed &= check(run_modulated<float>("float", 1e-5), "float, modulated cutoff");
+    return passed ? 0 : 1;
+}
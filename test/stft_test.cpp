@@ -0,0 +1,97 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: stft_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/spectral/stft.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace edsp::spectral;
+using edsp::windowing::WindowType;
+
+namespace {
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Analyses and resynthesizes a random signal, twice with a reset in between, and compares every output sample,
+    // including the start-up ones, with the input. Samples whose overlapped squared window is below a thousandth of
+    // its steady-state minimum are numerically unrecoverable in single precision and are skipped.
+    bool run(WindowType type, std::size_t frame_size, std::size_t hop_size, std::size_t nfft) {
+        std::mt19937 generator(static_cast<unsigned>(frame_size + hop_size));
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        std::vector<float> input(16 * frame_size + hop_size / 2);
+        std::generate(std::begin(input), std::end(input), [&]() { return distribution(generator); });
+
+        std::vector<float> window(frame_size);
+        edsp::windowing::make_window(type, std::begin(window), std::end(window));
+        std::vector<double> envelope(input.size() + frame_size, 0);
+        for (std::size_t start = 0; start < input.size(); start += hop_size) {
+            for (std::size_t i = 0; i < frame_size; ++i) {
+                envelope[start + i] += static_cast<double>(window[i]) * window[i];
+            }
+        }
+        const auto steady =
+            *std::min_element(std::begin(envelope) + frame_size, std::begin(envelope) + input.size() - frame_size);
+
+        stft<float> analysis(type, frame_size, hop_size, nfft);
+        istft<float> synthesis(type, frame_size, hop_size, nfft);
+        std::vector<std::complex<float>> spectrum(analysis.frames(input.size()) * analysis.bins());
+        bool passed = true;
+        for (auto pass = 0; pass < 2; ++pass) {
+            analysis.reset();
+            synthesis.reset();
+            const auto frames = analysis.push(std::cbegin(input), std::cend(input), std::begin(spectrum));
+            std::vector<float> output(frames * hop_size);
+            for (std::size_t n = 0; n < frames; ++n) {
+                synthesis.push(std::cbegin(spectrum) + n * analysis.bins(), std::begin(output) + n * hop_size);
+            }
+
+            double error = 0;
+            for (std::size_t i = 0; i < output.size(); ++i) {
+                if (envelope[i] >= 1e-3 * steady) {
+                    error = std::max(error, std::abs(static_cast<double>(output[i]) - input[i]));
+                }
+            }
+            std::printf("frame %4zu hop %4zu nfft %4zu pass %d: max error %.3g\n", frame_size, hop_size, nfft,
+                        pass, error);
+            passed &= (frames > 0) && (error < 1e-4);
+        }
+        return passed;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+    passed &= check(run(WindowType::Hanning, 256, 64, 256), "hann 256/64 round trip from the first sample");
+    passed &= check(run(WindowType::Hanning, 256, 128, 512), "hann 256/128 zero-padded round trip");
+    passed &= check(run(WindowType::Hamming, 200, 50, 256), "hamming 200/50 round trip from the first sample");
+    passed &= check(run(WindowType::Hamming, 100, 100, 128), "hamming without overlap round trip");
+    passed &= check(run(WindowType::Blackman, 512, 96, 512), "blackman 512/96 round trip");
+    return passed ? 0 : 1;
+}
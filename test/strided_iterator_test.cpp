@@ -0,0 +1,105 @@
+/*
+* eDSP, A cross-platform Digital Signal Processing library written in modern C++.
+* Copyright (C) 2019 Mohammed Boujemaoui Boulaghmoudi, All rights reserved.
+*
+* This program is free software: you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option)
+* any later version.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of  MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+*
+* You should have received a copy of the GNU General Public License along width
+* this program.  If not, see <http://www.gnu.org/licenses/>
+*
+* Filename: strided_iterator_test.cpp
+* Author: Mohammed Boujemaoui
+* Date: 15/10/26
+*/
+
+#include <edsp/types/strided_iterator.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+using namespace edsp::types;
+
+namespace {
+
+    bool check(bool condition, const char* name) {
+        std::printf("%-56s %s\n", name, condition ? "ok" : "FAILED");
+        return condition;
+    }
+
+    // Sample n of the channel c, as stored at the position n * channels + c.
+    int sample(std::size_t n, std::size_t c) {
+        return static_cast<int>(100 * c + n);
+    }
+
+    std::vector<int> make_buffer(std::size_t frames, std::size_t channels) {
+        std::vector<int> buffer(frames * channels);
+        for (std::size_t n = 0; n < frames; ++n) {
+            for (std::size_t c = 0; c < channels; ++c) {
+                buffer[n * channels + c] = sample(n, c);
+            }
+        }
+        return buffer;
+    }
+
+} // namespace
+
+// The test is built with the checked standard library iterators, which abort if an iterator is moved outside of its
+// container, as the end of a channel other than the first one used to be.
+int main() {
+    const std::size_t frames = 10, channels = 3;
+    bool passed              = true;
+
+    auto buffer        = make_buffer(frames, channels);
+    bool channels_read = true;
+    for (std::size_t c = 0; c < channels; ++c) {
+        const auto first = make_channel_iterator(std::cbegin(buffer), channels, c);
+        const auto last  = make_channel_iterator(std::cbegin(buffer), channels, c, frames);
+        std::vector<int> channel;
+        std::copy(first, last, std::back_inserter(channel));
+        channels_read &= (std::distance(first, last) == static_cast<std::ptrdiff_t>(frames));
+        for (std::size_t n = 0; n < frames; ++n) {
+            channels_read &= (channel[n] == sample(n, c)) && (first[static_cast<std::ptrdiff_t>(n)] == sample(n, c));
+        }
+    }
+    passed &= check(channels_read, "every channel is read up to its end");
+
+    const auto first = make_channel_iterator(std::begin(buffer), channels, channels - 1);
+    const auto last  = make_channel_iterator(std::begin(buffer), channels, channels - 1, frames);
+    std::sort(first, last, std::greater<int>());
+    bool sorted = std::is_sorted(first, last, std::greater<int>());
+    for (std::size_t n = 0; n < frames; ++n) {
+        sorted &= (buffer[n * channels] == sample(n, 0)) && (buffer[n * channels + 1] == sample(n, 1));
+    }
+    passed &= check(sorted, "the last channel is sorted in place");
+
+    auto it     = last;
+    bool walked = true;
+    for (std::size_t n = frames; n > 0; --n) {
+        --it;
+        const auto position = static_cast<std::ptrdiff_t>((n - 1) * channels + channels - 1);
+        walked &= (*it == sample(frames - n, channels - 1)) && (it.base() == std::begin(buffer) + position);
+    }
+    walked &= (it == first) && (last - first == static_cast<std::ptrdiff_t>(frames)) && (first < last);
+    passed &= check(walked, "the last channel is walked backwards");
+
+    const auto reversed = make_strided_iterator(std::cend(buffer) - 1, -static_cast<std::ptrdiff_t>(channels));
+    passed &= check(std::accumulate(reversed, reversed + static_cast<std::ptrdiff_t>(frames), 0) ==
+                        std::accumulate(first, last, 0),
+                    "a negative stride visits the channel backwards");
+
+    std::vector<int> empty;
+    passed &= check(make_channel_iterator(std::begin(empty), channels, 2) ==
+                        make_channel_iterator(std::begin(empty), channels, 2, 0),
+                    "an empty channel of an empty buffer");
+    return passed ? 0 : 1;
+}